@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "Socket.h"
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+/**
+* @brief What a single connection measured.
+*/
+struct ConnectionStats
+{
+    std::vector<double> latencies;
+    std::size_t failures = 0;
+    std::string error;
+};
+
+/**
+* @brief Sends requests on one connection, keeping up to 'pipeline' of them
+* in flight, and times each one from the moment it was queued for sending
+* until its response arrived.
+*/
+void runConnection( const std::string& address, const std::vector<std::string>& puzzles,
+    std::size_t offset, std::size_t requests, std::size_t pipeline, ConnectionStats& stats )
+{
+    int fd = -1;
+    try
+    {
+        fd = Sudoku::connectTo( address );
+    }
+    catch( const std::exception& ex )
+    {
+        stats.error = ex.what();
+        return;
+    }
+
+    Sudoku::LineReader reader( fd );
+    std::deque<Clock::time_point> inFlight;
+    std::string batch;
+    std::string response;
+    std::size_t sent = 0;
+
+    stats.latencies.reserve( requests );
+    while( stats.latencies.size() < requests )
+    {
+        batch.clear();
+        while( sent < requests && inFlight.size() < pipeline )
+        {
+            batch += puzzles[( offset + sent ) % puzzles.size()];
+            batch += '\n';
+            inFlight.push_back( Clock::now() );
+            ++sent;
+        }
+        if( !batch.empty() && !Sudoku::writeAll( fd, batch.data(), batch.size() ) )
+        {
+            stats.error = "connection closed while sending";
+            break;
+        }
+
+        if( !reader.next( response ) )
+        {
+            stats.error = "connection closed while receiving";
+            break;
+        }
+
+        const std::chrono::duration<double, std::micro> latency = Clock::now() - inFlight.front();
+        inFlight.pop_front();
+        stats.latencies.push_back( latency.count() );
+
+        if( response.compare( 0, 7, "SOLVED " ) != 0 )
+            ++stats.failures;
+    }
+
+    ::close( fd );
+}
+
+double percentile( const std::vector<double>& sorted, double p )
+{
+    if( sorted.empty() )
+        return 0;
+    const auto index = static_cast< std::size_t >( p * ( sorted.size() - 1 ) );
+    return sorted[index];
+}
+}
+
+int main( int argc, char* argv[] )
+{
+    if( argc < 3 )
+    {
+        std::cerr << "Usage: " << argv[0] << " <unix:path|tcp:port> <puzzle file> [--requests <count>] [--connections <count>] [--pipeline <depth>]" << std::endl
+            << "The puzzle file has one board per line in the compact line format." << std::endl << std::endl;
+        return 1;
+    }
+
+    const std::string address = argv[1];
+    std::size_t requests = 10000;
+    std::size_t connections = 1;
+    std::size_t pipeline = 16;
+
+    try
+    {
+        for( int i = 3; i < argc; i += 2 )
+        {
+            const std::string option = argv[i];
+            if( i + 1 >= argc )
+                throw std::invalid_argument( "Missing value for " + option );
+
+            const auto value = std::stoull( argv[i + 1], nullptr, 0 );
+            if( value == 0 )
+                throw std::invalid_argument( option + " must be greater than 0" );
+
+            if( option == "--requests" )
+                requests = value;
+            else if( option == "--connections" )
+                connections = value;
+            else if( option == "--pipeline" )
+                pipeline = value;
+            else
+                throw std::invalid_argument( "Unknown option " + option );
+        }
+    }
+    catch( const std::exception& ex )
+    {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> puzzles;
+    {
+        std::ifstream file( argv[2] );
+        std::string line;
+        while( std::getline( file, line ) )
+        {
+            if( !line.empty() )
+                puzzles.push_back( line );
+        }
+    }
+    if( puzzles.empty() )
+    {
+        std::cerr << "No puzzles read from " << argv[2] << std::endl;
+        return 2;
+    }
+
+    std::vector<ConnectionStats> stats( connections );
+    std::vector<std::thread> threads;
+
+    const auto start = Clock::now();
+    for( std::size_t i = 0; i < connections; ++i )
+    {
+        // spread the total over the connections
+        const auto share = requests / connections + ( i < requests % connections ? 1 : 0 );
+        threads.emplace_back( runConnection, std::cref( address ), std::cref( puzzles ), i, share, pipeline, std::ref( stats[i] ) );
+    }
+    for( auto& thread : threads )
+    {
+        thread.join();
+    }
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    std::vector<double> latencies;
+    std::size_t failures = 0;
+    for( const auto& connection : stats )
+    {
+        if( !connection.error.empty() )
+            std::cerr << "Connection error: " << connection.error << std::endl;
+        latencies.insert( latencies.end(), connection.latencies.begin(), connection.latencies.end() );
+        failures += connection.failures;
+    }
+    std::sort( latencies.begin(), latencies.end() );
+
+    std::cout << "Requests:   " << latencies.size() << " (" << failures << " not solved)" << std::endl;
+    std::cout << "Elapsed:    " << elapsed.count() << " s" << std::endl;
+    std::cout << "Throughput: " << latencies.size() / elapsed.count() << " requests/s" << std::endl;
+    std::cout << "Latency:    p50 " << percentile( latencies, 0.5 ) << " us, p99 " << percentile( latencies, 0.99 )
+        << " us, max " << percentile( latencies, 1.0 ) << " us" << std::endl;
+
+    return latencies.size() == requests ? 0 : 3;
+}
@@ -0,0 +1,233 @@
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <system_error>
+#include <thread>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "Executor.h"
+#include "FileParser.h"
+#include "ResultWriter.h"
+#include "Server.h"
+#include "Socket.h"
+#include "SolutionCache.h"
+#include "Solver.h"
+
+namespace
+{
+/**
+* @brief Maximum number of requests of a single connection waiting for their
+* response before the server stops reading from it.
+*/
+constexpr std::size_t MaxPending = 4096;
+
+/**
+* @brief The open connections, so that the server can shut them down and wait
+* for them before destroying the executor and the cache they use.
+*/
+struct Connections
+{
+    std::mutex mutex;
+    std::condition_variable closed;
+    std::set<int> fds;
+};
+
+/**
+* @brief Serves a single client: reads its requests, queues the solves on the
+* executor and writes the responses back in request order.
+*/
+void serveConnection( int fd, Sudoku::Executor& executor, Sudoku::SolutionCache* cache, const Sudoku::ServerConfig& config,
+    Connections& connections )
+{
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<std::future<Sudoku::SolveResult>> pending;
+    bool reading = true;
+    bool broken = false;
+
+    std::thread writer( [&]()
+        {
+            // responses solved in a row go out in a single write, and the
+            // last one as soon as the next isn't ready
+            Sudoku::ResultWriter responses( [fd]( const char* data, std::size_t size ) { return Sudoku::writeAll( fd, data, size ); },
+                Sudoku::OutputFormat::Line );
+            for( ;; )
+            {
+                std::future<Sudoku::SolveResult> response;
+                {
+                    std::unique_lock<std::mutex> lock( mutex );
+                    changed.wait( lock, [&]() { return !pending.empty() || !reading; } );
+                    if( pending.empty() )
+                        return;
+                    response = std::move( pending.front() );
+                    pending.pop_front();
+                }
+                changed.notify_all();
+
+                try
+                {
+                    responses.write( response.get() );
+                }
+                catch( const std::exception& ex )
+                {
+                    responses.writeError( ex.what() );
+                }
+
+                bool ready = false;
+                {
+                    std::lock_guard<std::mutex> lock( mutex );
+                    ready = !pending.empty() && pending.front().wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready;
+                }
+                if( !ready && !responses.flush() )
+                {
+                    std::lock_guard<std::mutex> lock( mutex );
+                    broken = true;
+                }
+            }
+        } );
+
+    Sudoku::LineReader reader( fd );
+    std::string line;
+    while( reader.next( line ) )
+    {
+        if( line.empty() )
+            continue;
+
+        auto promise = std::make_shared<std::promise<Sudoku::SolveResult>>();
+        {
+            std::unique_lock<std::mutex> lock( mutex );
+            changed.wait( lock, [&]() { return pending.size() < MaxPending; } );
+            if( broken )
+                break;
+            pending.push_back( promise->get_future() );
+        }
+        changed.notify_all();
+
+        try
+        {
+            Sudoku::SolveOptions options;
+            options.maxNodes = config.maxNodes;
+            if( config.timeout.count() > 0 )
+            {
+                options.deadline = Sudoku::SolveOptions::Clock::now() +
+                    std::chrono::duration_cast< Sudoku::SolveOptions::Clock::duration >( config.timeout );
+            }
+
+            if( cache )
+            {
+                auto givens = Sudoku::parseLineValues( line );
+                executor.submit( [promise, givens, options, cache]( Sudoku::SolverContext& context )
+                    {
+                        try
+                        {
+                            promise->set_value( Sudoku::solve( givens, options, context, *cache ) );
+                        }
+                        catch( ... )
+                        {
+                            promise->set_exception( std::current_exception() );
+                        }
+                    } );
+            }
+            else
+            {
+                executor.solve( Sudoku::parseLine( line ), options,
+                    [promise]( Sudoku::SolveResult result ) { promise->set_value( std::move( result ) ); },
+                    [promise]( std::exception_ptr error ) { promise->set_exception( error ); } );
+            }
+        }
+        catch( const std::exception& )
+        {
+            promise->set_exception( std::current_exception() );
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock( mutex );
+        reading = false;
+    }
+    changed.notify_all();
+    writer.join();
+
+    // closed under the lock, so the server never shuts down a reused descriptor
+    std::lock_guard<std::mutex> lock( connections.mutex );
+    connections.fds.erase( fd );
+    ::close( fd );
+    connections.closed.notify_all();
+}
+}
+
+int Sudoku::serve( const ServerConfig& config )
+{
+    int listener = -1;
+    try
+    {
+        listener = listenOn( config.address );
+    }
+    catch( const std::exception& ex )
+    {
+        std::cerr << ex.what() << std::endl;
+        return 4;
+    }
+    return serve( config, listener );
+}
+
+int Sudoku::serve( const ServerConfig& config, int listener )
+{
+    const auto threads = config.threads != 0 ? config.threads : std::max( 1u, std::thread::hardware_concurrency() );
+    // the connections outlive the executor, whose tasks may use the cache
+    Connections connections;
+    std::unique_ptr<SolutionCache> cache;
+    if( config.cacheSize != 0 )
+        cache.reset( new SolutionCache( config.cacheSize ) );
+    // the solver threads and their contexts stay warm for the whole run
+    Executor executor( threads, MaxPending );
+
+    std::cout << "Listening on " << config.address << " with " << threads << " solver threads" << std::endl;
+
+    for( ;; )
+    {
+        const int client = ::accept( listener, nullptr, nullptr );
+        if( client < 0 )
+        {
+            if( errno == EINTR || errno == ECONNABORTED )
+                continue;
+            std::cerr << "accept failed" << std::endl;
+            ::close( listener );
+            break;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock( connections.mutex );
+            connections.fds.insert( client );
+        }
+        try
+        {
+            std::thread( serveConnection, client, std::ref( executor ), cache.get(), std::cref( config ), std::ref( connections ) ).detach();
+        }
+        catch( const std::system_error& )
+        {
+            // out of threads: drop this client rather than the server
+            std::lock_guard<std::mutex> lock( connections.mutex );
+            connections.fds.erase( client );
+            ::close( client );
+        }
+    }
+
+    // stop reading new requests, but answer the pending ones before the
+    // executor goes away
+    std::unique_lock<std::mutex> lock( connections.mutex );
+    for( int fd : connections.fds )
+    {
+        ::shutdown( fd, SHUT_RD );
+    }
+    connections.closed.wait( lock, [&connections]() { return connections.fds.empty(); } );
+    return 4;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace Sudoku
+{
+
+/**
+* @brief Settings of the solving server.
+*/
+struct ServerConfig
+{
+    /**
+    * @brief Where to listen, see listenOn().
+    */
+    std::string address;
+    /**
+    * @brief Number of solver threads. 0 uses one per hardware thread.
+    */
+    std::size_t threads = 0;
+    /**
+    * @brief Maximum time allowed for each request. 0 means no limit.
+    */
+    std::chrono::duration<double> timeout{ 0 };
+    /**
+    * @brief Maximum number of nodes allowed for each request. 0 means no limit.
+    */
+    std::size_t maxNodes = 0;
+    /**
+    * @brief Number of solutions kept to answer repeated puzzles, equivalent
+    * ones included, without solving them again. 0 disables the cache.
+    */
+    std::size_t cacheSize = 0;
+};
+
+/**
+* @brief Runs the solving server until the process is terminated.
+*
+* Clients send one board per line in the compact line format and may pipeline
+* as many requests as they want. Each request gets exactly one response line,
+* in request order:
+*   SOLVED <solution> <nodes> <microseconds>
+*   <UNSOLVABLE|TIMEOUT|NODELIMIT|CANCELLED> - <nodes> <microseconds>
+*   ERROR <message>
+*
+* @param config the server settings
+* @return The process exit code if the server could not be started.
+*/
+int serve( const ServerConfig& config );
+/**
+* @brief Runs the solving server on a listening socket until accepting a
+* connection fails, e.g. because the socket was shut down. The open
+* connections then stop reading; it returns once their pending requests are
+* answered.
+* @param config the server settings, the address is only displayed
+* @param listener the listening socket, closed on return
+* @return The process exit code.
+*/
+int serve( const ServerConfig& config, int listener );
+
+} // namespace
@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Socket.h"
+
+namespace
+{
+const std::string UnixPrefix = "unix:";
+const std::string TcpPrefix = "tcp:";
+
+[[noreturn]] void fail( const std::string& what )
+{
+    throw std::runtime_error( what + ": " + std::strerror( errno ) );
+}
+
+/**
+* @brief Creates a socket for the address and fills in the matching socket address.
+* @return the socket descriptor
+*/
+int openSocket( const std::string& address, sockaddr_storage& storage, socklen_t& length )
+{
+    std::memset( &storage, 0, sizeof( storage ) );
+
+    if( address.compare( 0, UnixPrefix.size(), UnixPrefix ) == 0 )
+    {
+        const auto path = address.substr( UnixPrefix.size() );
+        auto& un = reinterpret_cast< sockaddr_un& >( storage );
+        if( path.empty() || path.size() >= sizeof( un.sun_path ) )
+            throw std::runtime_error( "invalid socket path: " + path );
+
+        un.sun_family = AF_UNIX;
+        std::copy( path.begin(), path.end(), un.sun_path );
+        length = sizeof( sockaddr_un );
+    }
+    else if( address.compare( 0, TcpPrefix.size(), TcpPrefix ) == 0 )
+    {
+        const auto port = std::stoul( address.substr( TcpPrefix.size() ) );
+        if( port == 0 || port > 65535 )
+            throw std::runtime_error( "invalid port: " + address.substr( TcpPrefix.size() ) );
+
+        auto& in = reinterpret_cast< sockaddr_in& >( storage );
+        in.sin_family = AF_INET;
+        in.sin_port = htons( static_cast< uint16_t >( port ) );
+        in.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+        length = sizeof( sockaddr_in );
+    }
+    else
+    {
+        throw std::runtime_error( "address must start with unix: or tcp: " + address );
+    }
+
+    const int fd = ::socket( storage.ss_family, SOCK_STREAM, 0 );
+    if( fd < 0 )
+        fail( "socket" );
+
+    if( storage.ss_family == AF_INET )
+    {
+        // responses are small and latency matters
+        const int one = 1;
+        ::setsockopt( fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof( one ) );
+        ::setsockopt( fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof( one ) );
+    }
+    return fd;
+}
+}
+
+int Sudoku::listenOn( const std::string& address )
+{
+    sockaddr_storage storage;
+    socklen_t length = 0;
+    const int fd = openSocket( address, storage, length );
+
+    if( storage.ss_family == AF_UNIX )
+    {
+        // a previous instance may have left its socket file behind
+        ::unlink( reinterpret_cast< sockaddr_un& >( storage ).sun_path );
+    }
+
+    if( ::bind( fd, reinterpret_cast< sockaddr* >( &storage ), length ) != 0 )
+    {
+        ::close( fd );
+        fail( "bind " + address );
+    }
+    if( ::listen( fd, SOMAXCONN ) != 0 )
+    {
+        ::close( fd );
+        fail( "listen " + address );
+    }
+    return fd;
+}
+
+int Sudoku::connectTo( const std::string& address )
+{
+    sockaddr_storage storage;
+    socklen_t length = 0;
+    const int fd = openSocket( address, storage, length );
+
+    if( ::connect( fd, reinterpret_cast< sockaddr* >( &storage ), length ) != 0 )
+    {
+        ::close( fd );
+        fail( "connect " + address );
+    }
+    return fd;
+}
+
+bool Sudoku::writeAll( int fd, const char* data, std::size_t size )
+{
+    while( size > 0 )
+    {
+        const auto written = ::send( fd, data, size, MSG_NOSIGNAL );
+        if( written < 0 )
+        {
+            if( errno == EINTR )
+                continue;
+            return false;
+        }
+        data += written;
+        size -= static_cast< std::size_t >( written );
+    }
+    return true;
+}
+
+Sudoku::LineReader::LineReader( int fd ) :
+    m_fd( fd ),
+    m_buffer( 64 * 1024 )
+{
+}
+
+bool Sudoku::LineReader::next( std::string& line )
+{
+    line.clear();
+
+    for( ;; )
+    {
+        const auto begin = m_buffer.begin() + m_begin;
+        const auto end = m_buffer.begin() + m_end;
+        const auto newline = std::find( begin, end, '\n' );
+        line.append( begin, newline );
+
+        if( newline != end )
+        {
+            m_begin = static_cast< std::size_t >( newline - m_buffer.begin() ) + 1;
+            if( !line.empty() && line.back() == '\r' )
+                line.pop_back();
+            return true;
+        }
+
+        m_begin = 0;
+        m_end = 0;
+
+        const auto received = ::recv( m_fd, m_buffer.data(), m_buffer.size(), 0 );
+        if( received < 0 && errno == EINTR )
+            continue;
+        if( received <= 0 )
+        {
+            // a last line without terminator still counts
+            return !line.empty();
+        }
+        m_end = static_cast< std::size_t >( received );
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Sudoku
+{
+
+/**
+* @brief Opens a listening socket.
+* @param address "unix:<path>" for a Unix domain socket or "tcp:<port>" for a
+* TCP socket bound to the loopback interface
+* @return The listening socket descriptor
+* @throw std::runtime_error if the address is invalid or the socket can't be opened
+*/
+int listenOn( const std::string& address );
+
+/**
+* @brief Connects to a listening socket.
+* @param address the address, in the format accepted by listenOn()
+* @return The connected socket descriptor
+* @throw std::runtime_error if the address is invalid or the connection failed
+*/
+int connectTo( const std::string& address );
+
+/**
+* @brief Writes a whole buffer to a socket, retrying on partial writes.
+* @param fd the socket descriptor
+* @param data the data to write
+* @param size the number of bytes to write
+* @return True if everything was written, false if the connection failed.
+*/
+bool writeAll( int fd, const char* data, std::size_t size );
+
+/**
+* @brief Reads newline terminated lines from a socket through a buffer, so
+* pipelined requests are read with few system calls.
+*/
+class LineReader
+{
+public:
+    explicit LineReader( int fd );
+    /**
+    * @brief Reads the next line, without its terminator.
+    * @param line receives the line
+    * @return True if a line was read, false at end of stream or on error.
+    */
+    bool next( std::string& line );
+
+private:
+    int m_fd;
+    std::vector<char> m_buffer;
+    std::size_t m_begin = 0;
+    std::size_t m_end = 0;
+};
+
+} // namespace
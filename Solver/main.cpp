@@ -1,20 +1,987 @@
 #include <iostream>
+#include <atomic>
 #include <chrono>
 #include <string>
 #include <sstream>
+#include <thread>
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iomanip>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "BatchSolver.h"
+#include "Executor.h"
 #include "FileParser.h"
+#include "Generator.h"
+#include "PerfCounters.h"
+#include "Portfolio.h"
+#include "Rater.h"
+#include "ResultWriter.h"
+#include "SolutionCache.h"
 #include "Solver.h"
+#include "Trace.h"
 #include "Utils.h"
+#include "Verifier.h"
+#ifdef SUDOKU_SERVER
+#include "Server.h"
+#endif
+#ifdef SUDOKU_STORE
+#include "SolutionStore.h"
+#endif
+
+namespace
+{
+/**
+* @brief The optional settings shared by the solving modes.
+*/
+struct Settings
+{
+    Sudoku::SolveOptions options;
+    std::chrono::duration<double> timeout{ 0 };
+    std::size_t threads = 0;
+    std::size_t cacheSize = 0;
+    std::string store;
+    Sudoku::Engine engine = Sudoku::Engine::Search;
+    // if true, the puzzles of a batch are solved BatchSolver::Lanes at a time
+    bool lanes = false;
+    Sudoku::AnnealOptions annealOptions;
+    Sudoku::LearnOptions learnOptions;
+    // when not empty, the configurations racing on every puzzle instead of the engine
+    std::vector<Sudoku::Configuration> portfolio;
+    Sudoku::OutputFormat format = Sudoku::OutputFormat::Line;
+    bool stats = true;
+    // when not empty, the file the trace of the solves is written to
+    std::string trace;
+    // if true, the hardware events of the phases are counted and reported
+    bool counters = false;
+};
+
+/**
+* @brief Parses the optional "--name value" arguments starting at argv[first].
+* @throw std::invalid_argument on unknown options or missing values
+*/
+void parseOptions( int argc, char* argv[], int first, Settings& settings )
+{
+    settings.annealOptions.chains = std::max( 1u, std::thread::hardware_concurrency() );
+    std::size_t portfolio = 0;
+    for( int i = first; i < argc; i += 2 )
+    {
+        const std::string option = argv[i];
+        if( i + 1 >= argc )
+        {
+            throw std::invalid_argument( "Missing value for " + option );
+        }
+
+        if( option == "--timeout" )
+        {
+            settings.timeout = std::chrono::duration<double>( std::stod( argv[i + 1] ) );
+            settings.options.deadline = Sudoku::SolveOptions::Clock::now() +
+                std::chrono::duration_cast< Sudoku::SolveOptions::Clock::duration >( settings.timeout );
+        }
+        else if( option == "--max-nodes" )
+        {
+            settings.options.maxNodes = std::stoull( argv[i + 1], nullptr, 0 );
+        }
+        else if( option == "--threads" )
+        {
+            settings.threads = std::stoull( argv[i + 1], nullptr, 0 );
+        }
+        else if( option == "--cache" )
+        {
+            settings.cacheSize = std::stoull( argv[i + 1], nullptr, 0 );
+        }
+        else if( option == "--engine" )
+        {
+            const std::string engine = argv[i + 1];
+            settings.lanes = engine == "lanes";
+            if( engine == "search" || engine == "lanes" )
+                settings.engine = Sudoku::Engine::Search;
+            else if( engine == "anneal" )
+                settings.engine = Sudoku::Engine::Anneal;
+            else if( engine == "learn" )
+                settings.engine = Sudoku::Engine::Learn;
+            else
+                throw std::invalid_argument( "Unknown engine " + engine );
+        }
+        else if( option == "--chains" )
+        {
+            settings.annealOptions.chains = std::stoull( argv[i + 1], nullptr, 0 );
+        }
+        else if( option == "--restart-after" )
+        {
+            settings.annealOptions.restartAfter = std::stoull( argv[i + 1], nullptr, 0 );
+        }
+        else if( option == "--restart-interval" )
+        {
+            settings.learnOptions.restartInterval = std::stoull( argv[i + 1], nullptr, 0 );
+        }
+        else if( option == "--seed" )
+        {
+            settings.options.seed = std::stoull( argv[i + 1], nullptr, 0 );
+        }
+        else if( option == "--value-order" )
+        {
+            const std::string order = argv[i + 1];
+            if( order == "ascending" )
+                settings.options.valueOrder = Sudoku::ValueOrder::Ascending;
+            else if( order == "random" )
+                settings.options.valueOrder = Sudoku::ValueOrder::Random;
+            else if( order == "lcv" )
+                settings.options.valueOrder = Sudoku::ValueOrder::LeastConstraining;
+            else if( order == "history" )
+                settings.options.valueOrder = Sudoku::ValueOrder::History;
+            else
+                throw std::invalid_argument( "Unknown value order " + order );
+        }
+        else if( option == "--portfolio" )
+        {
+            portfolio = std::stoull( argv[i + 1], nullptr, 0 );
+        }
+        else if( option == "--format" )
+        {
+            settings.format = Sudoku::parseOutputFormat( argv[i + 1] );
+        }
+        else if( option == "--stats" )
+        {
+            settings.stats = std::stoull( argv[i + 1], nullptr, 0 ) != 0;
+        }
+        else if( option == "--trace" )
+        {
+            settings.trace = argv[i + 1];
+        }
+        else if( option == "--counters" )
+        {
+            settings.counters = std::stoull( argv[i + 1], nullptr, 0 ) != 0;
+        }
+#ifdef SUDOKU_STORE
+        else if( option == "--store" )
+        {
+            settings.store = argv[i + 1];
+        }
+#endif
+        else
+        {
+            throw std::invalid_argument( "Unknown option " + option );
+        }
+    }
+    settings.portfolio = Sudoku::defaultPortfolio( portfolio, settings.options.seed );
+}
+
+/**
+* @brief Starts tracing the solves if the settings ask for a trace.
+*/
+void startTrace( const Settings& settings )
+{
+    if( !settings.trace.empty() )
+        Sudoku::Trace::enable();
+}
+
+/**
+* @brief Writes the trace of the solves to the file named in the settings, if any.
+*/
+void writeTrace( const Settings& settings )
+{
+    if( settings.trace.empty() )
+        return;
+
+    Sudoku::Trace::disable();
+    std::ofstream file( settings.trace );
+    Sudoku::Trace::write( file );
+    if( !file )
+        std::cerr << "Can't write the trace to " << settings.trace << std::endl;
+}
+
+/**
+* @brief Starts counting hardware events if the settings ask for it and the
+* system allows it, or tells why it doesn't.
+*/
+void startCounters( const Settings& settings )
+{
+    if( !settings.counters )
+        return;
+
+    std::string reason;
+    if( Sudoku::PerfCounters::available( &reason ) )
+        Sudoku::PerfCounters::enable();
+    else
+        std::cerr << "Hardware counters unavailable, " << reason << std::endl;
+}
+
+/**
+* @brief Writes the hardware events of a phase on a line.
+*/
+void writeCounters( std::ostream& stream, const char* phase, const Sudoku::PerfSample& sample )
+{
+    stream << phase << ": " << sample.cycles << " cycles, " << sample.instructions << " instructions";
+    if( sample.cycles )
+        stream << " (" << static_cast< double >( sample.instructions ) / sample.cycles << " per cycle)";
+    stream << ", " << sample.l1Misses << " L1 misses, " << sample.llcMisses << " LLC misses, "
+        << sample.branchMisses << " branch misses" << std::endl;
+}
+
+/**
+* @brief Writes the hardware events of the phases of solving, if counted.
+* @param solve the events of the solves, which include their propagation
+*/
+void writeCounters( std::ostream& stream, const Sudoku::PerfSample& parse, const Sudoku::PerfSample& solve, const Sudoku::PerfSample& propagation )
+{
+    if( !Sudoku::PerfCounters::enabled() )
+        return;
+
+    writeCounters( stream, "Parse", parse );
+    writeCounters( stream, "Solve", solve );
+    writeCounters( stream, "  propagation", propagation );
+    writeCounters( stream, "  search", solve - propagation );
+}
+
+/**
+* @brief Opens the solution store or cache requested by the settings, if any.
+* @throw std::runtime_error if the store can't be opened
+*/
+std::unique_ptr<Sudoku::SolutionLookup> openLookup( const Settings& settings )
+{
+#ifdef SUDOKU_STORE
+    if( !settings.store.empty() )
+        return std::unique_ptr<Sudoku::SolutionLookup>( new Sudoku::SolutionStore( settings.store ) );
+#endif
+    if( settings.cacheSize )
+        return std::unique_ptr<Sudoku::SolutionLookup>( new Sudoku::SolutionCache( settings.cacheSize ) );
+    return nullptr;
+}
+
+/**
+* @brief The outcome of solving the lines of a chunk of a puzzle file with the
+* lanes engine.
+*/
+struct LanesChunk
+{
+    // the records of the lines, in file order
+    std::string output;
+    std::size_t count = 0;
+    std::size_t solved = 0;
+    std::size_t propagated = 0;
+    std::size_t searched = 0;
+};
+
+/**
+* @brief Solves the puzzles on the lines of a chunk, BatchSolver::Lanes at a
+* time, with a solver per thread.
+*/
+LanesChunk solveLanesChunk( const std::vector<std::string>& lines, const Settings& settings )
+{
+    constexpr auto Cells = Sudoku::BatchSolver::Cells;
+    thread_local Sudoku::BatchSolver solver;
+    LanesChunk chunk;
+    const auto propagated = solver.propagated();
+    const auto searched = solver.searched();
+    auto options = settings.options;
+    if( settings.timeout.count() > 0 )
+    {
+        options.deadline = Sudoku::SolveOptions::Clock::now() +
+            std::chrono::duration_cast< Sudoku::SolveOptions::Clock::duration >( settings.timeout );
+    }
+
+    Sudoku::ResultWriter writer( [&chunk]( const char* data, std::size_t size )
+        {
+            chunk.output.append( data, size );
+            return true;
+        }, settings.format, settings.stats );
+    Sudoku::Nums cells;
+    Sudoku::Nums puzzles;
+    Sudoku::Nums solutions;
+    std::vector<Sudoku::SolveStatus> statuses;
+    std::vector<Sudoku::SolveStats> stats;
+    // solves the puzzles gathered so far, so that the output keeps the line order
+    const auto solvePending = [&]()
+        {
+            const auto count = puzzles.size() / Cells;
+            if( count == 0 )
+                return;
+            solutions.resize( puzzles.size() );
+            statuses.resize( count, Sudoku::SolveStatus::Unsolvable );
+            stats.resize( count );
+            solver.solve( puzzles.data(), count, solutions.data(), statuses.data(), options, stats.data() );
+            for( std::size_t puzzle = 0; puzzle < count; ++puzzle )
+            {
+                chunk.solved += statuses[puzzle] == Sudoku::SolveStatus::Solved;
+                writer.write( statuses[puzzle], solutions.data() + puzzle * Cells, 9, stats[puzzle] );
+            }
+            puzzles.clear();
+        };
+
+    for( const auto& line : lines )
+    {
+        ++chunk.count;
+        try
+        {
+            if( Sudoku::parseLineCells( line.data(), line.size(), cells ) != 3 )
+                throw std::invalid_argument( "The lanes engine only solves 9x9 puzzles" );
+            puzzles.insert( puzzles.end(), cells.begin(), cells.end() );
+        }
+        catch( const std::exception& ex )
+        {
+            solvePending();
+            writer.writeError( ex.what() );
+        }
+    }
+    solvePending();
+    writer.flush();
+    chunk.propagated = solver.propagated() - propagated;
+    chunk.searched = solver.searched() - searched;
+    return chunk;
+}
+
+/**
+* @brief Solves the puzzles of a file in the compact line format with the
+* lanes engine, writing the outcomes like solveBatch. A timeout applies to
+* each chunk of lines.
+*/
+int solveLanes( const std::string& filename, const Settings& settings )
+{
+    // puzzles per task, a multiple of the lanes
+    constexpr std::size_t ChunkSize = 16 * Sudoku::BatchSolver::Lanes;
+    std::ifstream file( filename );
+    if( !file.is_open() )
+    {
+        std::cerr << "Can't open file " << filename << std::endl;
+        return 2;
+    }
+
+    const auto threads = settings.threads ? settings.threads : std::max( 1u, std::thread::hardware_concurrency() );
+    const auto window = threads * 4;
+    Sudoku::Executor executor( threads, window );
+    std::deque<std::future<LanesChunk>> pending;
+    std::size_t count = 0;
+    std::size_t solved = 0;
+    std::size_t propagated = 0;
+    std::size_t searched = 0;
+    const auto write = [&]( std::size_t keep )
+        {
+            while( pending.size() > keep )
+            {
+                try
+                {
+                    const auto chunk = pending.front().get();
+                    std::cout.write( chunk.output.data(), chunk.output.size() );
+                    count += chunk.count;
+                    solved += chunk.solved;
+                    propagated += chunk.propagated;
+                    searched += chunk.searched;
+                }
+                catch( const std::exception& ex )
+                {
+                    std::cout << "ERROR " << ex.what() << '\n';
+                }
+                pending.pop_front();
+            }
+        };
+    const auto submit = [&]( std::vector<std::string>& lines )
+        {
+            auto promise = std::make_shared<std::promise<LanesChunk>>();
+            pending.push_back( promise->get_future() );
+            auto chunk = std::make_shared<std::vector<std::string>>();
+            chunk->swap( lines );
+            executor.submit( [promise, chunk, &settings]( Sudoku::SolverContext& )
+                {
+                    try
+                    {
+                        promise->set_value( solveLanesChunk( *chunk, settings ) );
+                    }
+                    catch( const std::exception& )
+                    {
+                        promise->set_exception( std::current_exception() );
+                    }
+                } );
+            write( window );
+        };
+
+    std::vector<std::string> lines;
+    std::string line;
+    const auto start = std::chrono::steady_clock::now();
+    while( std::getline( file, line ) )
+    {
+        if( line.empty() || line[0] == '#' )
+            continue;
+        lines.push_back( line );
+        if( lines.size() == ChunkSize )
+            submit( lines );
+    }
+    if( !lines.empty() )
+        submit( lines );
+    write( 0 );
+    std::cout.flush();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cerr << "Solved " << solved << " of " << count << " puzzles in " << elapsed.count() << "s ("
+        << count / elapsed.count() << " puzzles/s, " << threads << " threads)" << std::endl;
+    std::cerr << "Settled by propagation: " << propagated << ", searched: " << searched << std::endl;
+    return 0;
+}
+
+/**
+* @brief Solves the puzzles of a file in the compact line format, writing the
+* outcome of each to the standard output in the requested format and in file
+* order, and the throughput to the standard error. A timeout applies to each
+* puzzle separately.
+*/
+int solveBatch( const std::string& filename, const Settings& settings )
+{
+    if( settings.lanes )
+    {
+        // the lanes engine only knows the standard 9x9 layout and the search
+        if( settings.cacheSize || !settings.store.empty() || !settings.portfolio.empty() || !settings.trace.empty() || settings.counters )
+        {
+            std::cerr << "The lanes engine doesn't support a cache, store, portfolio, trace or counters" << std::endl;
+            return 1;
+        }
+        return solveLanes( filename, settings );
+    }
+
+    std::ifstream file( filename );
+    if( !file.is_open() )
+    {
+        std::cerr << "Can't open file " << filename << std::endl;
+        return 2;
+    }
+
+    std::unique_ptr<Sudoku::SolutionLookup> lookup;
+    try
+    {
+        lookup = openLookup( settings );
+    }
+    catch( const std::exception& ex )
+    {
+        std::cerr << ex.what() << std::endl;
+        return 2;
+    }
+
+    const auto threads = settings.threads ? settings.threads : std::max( 1u, std::thread::hardware_concurrency() );
+    // bounds the memory held by the outcomes waiting for an earlier puzzle
+    const auto window = threads * 64;
+    Sudoku::Executor executor( threads, window );
+
+    std::deque<std::future<Sudoku::SolveResult>> pending;
+    std::size_t count = 0;
+    std::atomic<std::size_t> solved{ 0 };
+    std::mutex winsMutex;
+    std::vector<std::size_t> wins( settings.portfolio.size() );
+    std::mutex countersMutex;
+    Sudoku::PerfSample parseCounters;
+    Sudoku::PerfSample solveCounters;
+    Sudoku::PerfSample propagationCounters;
+    Sudoku::ResultWriter writer( []( const char* data, std::size_t size )
+        {
+            std::cout.write( data, size );
+            return static_cast< bool >( std::cout );
+        }, settings.format, settings.stats );
+    const auto write = [&pending, &writer]( std::size_t keep )
+        {
+            while( pending.size() > keep )
+            {
+                try
+                {
+                    writer.write( pending.front().get() );
+                }
+                catch( const std::exception& ex )
+                {
+                    writer.writeError( ex.what() );
+                }
+                pending.pop_front();
+            }
+        };
+
+    std::string line;
+    startTrace( settings );
+    startCounters( settings );
+    const auto start = std::chrono::steady_clock::now();
+    while( std::getline( file, line ) )
+    {
+        if( line.empty() || line[0] == '#' )
+            continue;
+
+        auto promise = std::make_shared<std::promise<Sudoku::SolveResult>>();
+        pending.push_back( promise->get_future() );
+        ++count;
+
+        auto* cache = lookup.get();
+        executor.submit( [promise, line, &settings, cache, &solved, &winsMutex, &wins, &countersMutex, &parseCounters, &solveCounters, &propagationCounters]( Sudoku::SolverContext& context )
+            {
+                try
+                {
+                    const auto parsed = Sudoku::PerfCounters::parsing();
+                    auto options = settings.options;
+                    if( settings.timeout.count() > 0 )
+                    {
+                        options.deadline = Sudoku::SolveOptions::Clock::now() +
+                            std::chrono::duration_cast< Sudoku::SolveOptions::Clock::duration >( settings.timeout );
+                    }
+
+                    if( !settings.portfolio.empty() )
+                    {
+                        const auto portfolio = Sudoku::solvePortfolio( Sudoku::parseLine( line ), options, settings.portfolio );
+                        context.result() = portfolio.result;
+                        if( portfolio.winner < wins.size() )
+                        {
+                            std::lock_guard<std::mutex> lock( winsMutex );
+                            ++wins[portfolio.winner];
+                        }
+                    }
+                    else if( settings.engine == Sudoku::Engine::Anneal )
+                        context.result() = Sudoku::anneal( Sudoku::parseLineValues( line ), options, settings.annealOptions );
+                    else if( settings.engine == Sudoku::Engine::Learn )
+                        context.result() = Sudoku::learn( Sudoku::parseLineValues( line ), options, settings.learnOptions );
+                    else if( cache )
+                        Sudoku::solve( Sudoku::parseLineValues( line ), options, context, *cache );
+                    else
+                        Sudoku::solve( Sudoku::parseLine( line ), options, context );
+
+                    const auto& result = context.result();
+                    solved += result.status == Sudoku::SolveStatus::Solved;
+                    if( Sudoku::PerfCounters::enabled() )
+                    {
+                        std::lock_guard<std::mutex> lock( countersMutex );
+                        parseCounters += Sudoku::PerfCounters::parsing() - parsed;
+                        solveCounters += result.stats.counters;
+                        propagationCounters += result.stats.propagationCounters;
+                    }
+                    promise->set_value( result );
+                }
+                catch( const std::exception& )
+                {
+                    promise->set_exception( std::current_exception() );
+                }
+            } );
+        write( window );
+    }
+    write( 0 );
+    writer.flush();
+    std::cout.flush();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    writeTrace( settings );
+
+    std::cerr << "Solved " << solved << " of " << count << " puzzles in " << elapsed.count() << "s ("
+        << count / elapsed.count() << " puzzles/s, " << threads << " threads)" << std::endl;
+    for( std::size_t i = 0; i < wins.size(); ++i )
+    {
+        std::cerr << "Won by " << Sudoku::toString( settings.portfolio[i] ) << ": " << wins[i] << std::endl;
+    }
+    writeCounters( std::cerr, parseCounters, solveCounters, propagationCounters );
+    return 0;
+}
+
+/**
+* @brief Generates puzzles and writes them to the standard output in the
+* compact line format, reporting the throughput on the standard error.
+*/
+int generatePuzzles( int argc, char* argv[] )
+{
+    Sudoku::GeneratorOptions options;
+    std::size_t count = 1;
+    std::size_t threads = std::max( 1u, std::thread::hardware_concurrency() );
+
+    try
+    {
+        options.blockSize = std::stoull( argv[2], nullptr, 0 );
+        for( int i = 3; i < argc; i += 2 )
+        {
+            const std::string option = argv[i];
+            if( i + 1 >= argc )
+            {
+                throw std::invalid_argument( "Missing value for " + option );
+            }
+
+            const auto value = std::stoull( argv[i + 1], nullptr, 0 );
+            if( option == "--count" )
+                count = value;
+            else if( option == "--seed" )
+                options.seed = value;
+            else if( option == "--threads" )
+                threads = std::max<std::size_t>( 1, value );
+            else if( option == "--max-nodes" )
+                options.maxNodes = value;
+            else
+                throw std::invalid_argument( "Unknown option " + option );
+        }
+        if( options.blockSize < 2 )
+        {
+            throw std::invalid_argument( "Region side length must be at least 2" );
+        }
+    }
+    catch( const std::exception& ex )
+    {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    Sudoku::Executor executor( threads, threads * 2 );
+    Sudoku::Generator generator( options, executor );
+
+    std::size_t clues = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for( std::size_t i = 0; i < count; ++i )
+    {
+        const auto generated = generator.generate();
+        clues += generated.clues;
+        std::cout << Sudoku::toLine( generated.givens ) << '\n';
+    }
+    std::cout.flush();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cerr << "Generated " << count << " puzzles in " << elapsed.count() << "s ("
+        << count / elapsed.count() << " puzzles/s, " << threads << " threads), average clues: "
+        << ( count ? static_cast< double >( clues ) / count : 0.0 ) << std::endl;
+    return 0;
+}
+/**
+* @brief Rates the puzzles of a file in the compact line format, writing the
+* grade and hardest technique of each to the standard output and a technique
+* histogram of the whole file to the standard error.
+*/
+int ratePuzzles( const std::string& filename )
+{
+    std::ifstream file( filename );
+    if( !file.is_open() )
+    {
+        std::cerr << "Can't open file " << filename << std::endl;
+        return 2;
+    }
+
+    Sudoku::Rater rater;
+    std::array<std::size_t, static_cast< std::size_t >( Sudoku::Technique::Count )> histogram{};
+    std::size_t count = 0;
+    std::string line;
+    const auto start = std::chrono::steady_clock::now();
+
+    std::cout << std::fixed << std::setprecision( 2 );
+    while( std::getline( file, line ) )
+    {
+        if( line.empty() || line[0] == '#' )
+            continue;
+
+        try
+        {
+            const auto rating = rater.rate( Sudoku::parseLineValues( line ) );
+            for( std::size_t i = 0; i < histogram.size(); ++i )
+            {
+                histogram[i] += rating.histogram[i];
+            }
+            ++count;
+            std::cout << rating.grade << ' ' << Sudoku::toString( rating.hardest ) << '\n';
+        }
+        catch( const std::exception& ex )
+        {
+            std::cout << "ERROR " << ex.what() << '\n';
+        }
+    }
+    std::cout.flush();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cerr << "Rated " << count << " puzzles in " << elapsed.count() << "s ("
+        << count / elapsed.count() << " puzzles/s)" << std::endl;
+    for( std::size_t i = 0; i < histogram.size(); ++i )
+    {
+        if( histogram[i] )
+            std::cerr << "  " << Sudoku::toString( static_cast< Sudoku::Technique >( i ) ) << ": " << histogram[i] << std::endl;
+    }
+    return 0;
+}
+
+/**
+* @brief The outcome of verifying the lines of a chunk of a pairs file.
+*/
+struct VerifyChunk
+{
+    // a line per pair, in file order
+    std::string output;
+    // the number of each verdict, indexed by Sudoku::Verdict
+    std::array<std::size_t, 4> verdicts{};
+    std::size_t errors = 0;
+};
+
+/**
+* @brief Verifies the (puzzle, solution) pairs on the lines of a chunk, the
+* consecutive pairs of the same size in bulk.
+*/
+VerifyChunk verifyChunk( const std::string& text )
+{
+    // the pairs gathered before verifying them, so that they stay in the cache
+    constexpr std::size_t BulkSize = 128;
+    VerifyChunk chunk;
+    std::unique_ptr<Sudoku::Verifier> verifier;
+    Sudoku::Nums puzzle;
+    Sudoku::Nums solution;
+    Sudoku::Nums puzzles;
+    Sudoku::Nums solutions;
+    std::vector<Sudoku::Verdict> verdicts;
+    // verifies the pairs gathered so far, so that the output keeps the line order
+    const auto verifyPending = [&]()
+        {
+            if( solutions.empty() )
+                return;
+            verdicts.resize( solutions.size() / verifier->cellCount() );
+            verifier->verify( puzzles.data(), solutions.data(), verdicts.size(), verdicts.data() );
+            for( const auto verdict : verdicts )
+            {
+                ++chunk.verdicts[static_cast< std::size_t >( verdict )];
+                chunk.output += Sudoku::toString( verdict );
+                chunk.output += '\n';
+            }
+            puzzles.clear();
+            solutions.clear();
+        };
+
+    for( std::size_t begin = 0; begin < text.size(); )
+    {
+        auto end = text.find( '\n', begin );
+        if( end == std::string::npos )
+            end = text.size();
+        const auto line = text.data() + begin;
+        const auto size = end - begin;
+        begin = end + 1;
+        if( size == 0 || line[0] == '#' )
+            continue;
+
+        try
+        {
+            const auto blockSize = Sudoku::parsePairLine( line, size, puzzle, solution );
+            if( !verifier || verifier->layout().blockSize() != blockSize )
+            {
+                verifyPending();
+                verifier.reset( new Sudoku::Verifier( blockSize ) );
+            }
+            puzzles.insert( puzzles.end(), puzzle.begin(), puzzle.end() );
+            solutions.insert( solutions.end(), solution.begin(), solution.end() );
+            if( solutions.size() >= BulkSize * verifier->cellCount() )
+                verifyPending();
+        }
+        catch( const std::exception& ex )
+        {
+            verifyPending();
+            ++chunk.errors;
+            chunk.output += "ERROR ";
+            chunk.output += ex.what();
+            chunk.output += '\n';
+        }
+    }
+    verifyPending();
+    return chunk;
+}
+
+/**
+* @brief Checks the solutions of a file of (puzzle, solution) pairs, one per
+* line, writing the verdict of each to the standard output in file order and
+* the throughput to the standard error. Chunks of the file are verified in
+* parallel.
+* @return 0 if every solution is valid, 3 if not.
+*/
+int verifySolutions( int argc, char* argv[] )
+{
+    std::size_t threads = std::max( 1u, std::thread::hardware_concurrency() );
+    try
+    {
+        for( int i = 3; i < argc; i += 2 )
+        {
+            const std::string option = argv[i];
+            if( i + 1 >= argc )
+            {
+                throw std::invalid_argument( "Missing value for " + option );
+            }
+
+            if( option == "--threads" )
+                threads = std::max<std::size_t>( 1, std::stoull( argv[i + 1], nullptr, 0 ) );
+            else
+                throw std::invalid_argument( "Unknown option " + option );
+        }
+    }
+    catch( const std::exception& ex )
+    {
+        std::cerr << ex.what() << std::endl;
+        return 1;
+    }
+
+    std::ifstream file( argv[2], std::ios::binary );
+    if( !file.is_open() )
+    {
+        std::cerr << "Can't open file " << argv[2] << std::endl;
+        return 2;
+    }
+
+    // bounds the memory held by the chunks waiting for an earlier one
+    const auto window = threads * 4;
+    Sudoku::Executor executor( threads, window );
+    std::deque<std::future<VerifyChunk>> pending;
+    std::array<std::size_t, 4> verdicts{};
+    std::size_t errors = 0;
+    const auto write = [&pending, &verdicts, &errors]( std::size_t keep )
+        {
+            while( pending.size() > keep )
+            {
+                try
+                {
+                    const auto chunk = pending.front().get();
+                    std::cout.write( chunk.output.data(), chunk.output.size() );
+                    for( std::size_t i = 0; i < verdicts.size(); ++i )
+                    {
+                        verdicts[i] += chunk.verdicts[i];
+                    }
+                    errors += chunk.errors;
+                }
+                catch( const std::exception& ex )
+                {
+                    std::cout << "ERROR " << ex.what() << '\n';
+                    ++errors;
+                }
+                pending.pop_front();
+            }
+        };
+
+    constexpr std::size_t ChunkSize = std::size_t( 1 ) << 20;
+    std::string rest;
+    const auto start = std::chrono::steady_clock::now();
+    while( file )
+    {
+        std::string text;
+        text.swap( rest );
+        const auto kept = text.size();
+        text.resize( kept + ChunkSize );
+        file.read( &text[kept], ChunkSize );
+        text.resize( kept + file.gcount() );
+        if( file )
+        {
+            // the last line may go on in the next chunk
+            const auto last = text.rfind( '\n' );
+            if( last == std::string::npos )
+            {
+                text.swap( rest );
+                continue;
+            }
+            rest.assign( text, last + 1, std::string::npos );
+            text.resize( last + 1 );
+        }
+        if( text.empty() )
+            continue;
+
+        auto promise = std::make_shared<std::promise<VerifyChunk>>();
+        pending.push_back( promise->get_future() );
+        executor.submit( [promise, text]( Sudoku::SolverContext& )
+            {
+                try
+                {
+                    promise->set_value( verifyChunk( text ) );
+                }
+                catch( const std::exception& )
+                {
+                    promise->set_exception( std::current_exception() );
+                }
+            } );
+        write( window );
+    }
+    write( 0 );
+    std::cout.flush();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::size_t count = 0;
+    for( const auto verdict : verdicts )
+    {
+        count += verdict;
+    }
+    std::cerr << "Verified " << count << " grids in " << elapsed.count() << "s ("
+        << count / elapsed.count() << " grids/s, " << threads << " threads): "
+        << verdicts[static_cast< std::size_t >( Sudoku::Verdict::Valid )] << " valid, "
+        << verdicts[static_cast< std::size_t >( Sudoku::Verdict::Invalid )] << " invalid, "
+        << verdicts[static_cast< std::size_t >( Sudoku::Verdict::Incomplete )] << " incomplete, "
+        << verdicts[static_cast< std::size_t >( Sudoku::Verdict::Mismatch )] << " mismatched, "
+        << errors << " errors" << std::endl;
+    return verdicts[static_cast< std::size_t >( Sudoku::Verdict::Valid )] == count && errors == 0 ? 0 : 3;
+}
+}
 
 int main(int argc, char* argv[] )
 {
     if( argc < 3 )
     {
-        std::cerr << "Usage: " << argv[0] << " <region side length> <filename>" << std::endl << std::endl;
+        std::cerr << "Usage: " << argv[0] << " <region side length> <filename> [<solve options>]" << std::endl;
+        std::cerr << "       " << argv[0] << " --batch <puzzle file> [--threads <count>] [--format <line|grid|json>] [--stats <0|1>] [<solve options>]" << std::endl;
+        std::cerr << "       " << argv[0] << " --generate <region side length> [--count <count>] [--seed <seed>] [--threads <count>] [--max-nodes <count>]" << std::endl;
+        std::cerr << "       " << argv[0] << " --rate <puzzle file>" << std::endl;
+        std::cerr << "       " << argv[0] << " --verify <pairs file> [--threads <count>]" << std::endl;
+#ifdef SUDOKU_SERVER
+        std::cerr << "       " << argv[0] << " --serve <unix:path|tcp:port> [--threads <count>] [--timeout <seconds>] [--max-nodes <count>] [--cache <entries>]" << std::endl;
+#endif
+        std::cerr << "Solve options: [--timeout <seconds>] [--max-nodes <count>] [--cache <entries>]"
+#ifdef SUDOKU_STORE
+            " [--store <path>]"
+#endif
+            " [--engine <search|lanes|anneal|learn>] [--chains <count>] [--seed <seed>] [--restart-after <levels>]"
+            " [--restart-interval <conflicts>] [--value-order <ascending|random|lcv|history>] [--portfolio <count>]"
+            " [--trace <file>] [--counters <0|1>]" << std::endl;
+        std::cerr << std::endl;
         return 1;
     }
 
+    if( std::string( argv[1] ) == "--generate" )
+    {
+        return generatePuzzles( argc, argv );
+    }
+
+    if( std::string( argv[1] ) == "--rate" )
+    {
+        return ratePuzzles( argv[2] );
+    }
+
+    if( std::string( argv[1] ) == "--verify" )
+    {
+        return verifySolutions( argc, argv );
+    }
+
+    if( std::string( argv[1] ) == "--batch" )
+    {
+        Settings settings;
+        try
+        {
+            parseOptions( argc, argv, 3, settings );
+        }
+        catch( const std::exception& ex )
+        {
+            std::cerr << ex.what() << std::endl;
+            return 1;
+        }
+        return solveBatch( argv[2], settings );
+    }
+
+#ifdef SUDOKU_SERVER
+    if( std::string( argv[1] ) == "--serve" )
+    {
+        Sudoku::ServerConfig config;
+        config.address = argv[2];
+        try
+        {
+            Settings settings;
+            parseOptions( argc, argv, 3, settings );
+            if( !settings.store.empty() || settings.engine != Sudoku::Engine::Search || settings.lanes || !settings.portfolio.empty() || !settings.trace.empty() || settings.counters )
+            {
+                throw std::invalid_argument( "The server only supports the search engine without a store, trace or counters" );
+            }
+            config.timeout = settings.timeout;
+            config.threads = settings.threads;
+            config.cacheSize = settings.cacheSize;
+            config.maxNodes = settings.options.maxNodes;
+        }
+        catch( const std::exception& ex )
+        {
+            std::cerr << ex.what() << std::endl;
+            return 1;
+        }
+        return Sudoku::serve( config );
+    }
+#endif
+
     Sudoku::Num blockSize = 0;
+    Settings settings;
 
     try
     {
@@ -29,6 +996,8 @@ int main(int argc, char* argv[] )
         }
 
         blockSize = static_cast<Sudoku::Num>( size );
+
+        parseOptions( argc, argv, 3, settings );
     }
     catch( const std::exception& ex )
     {
@@ -36,10 +1005,19 @@ int main(int argc, char* argv[] )
         return 1;
     }
 
-    Sudoku::Board board( blockSize );
+    if( settings.lanes )
+    {
+        std::cerr << "The lanes engine only solves batches" << std::endl;
+        return 1;
+    }
+
+    Sudoku::Board::InputArray givens;
+    Sudoku::Layout layout( blockSize );
+    startCounters( settings );
     try
     {
-        board = Sudoku::parseFile( blockSize, argv[2] );
+        givens = Sudoku::parseFileValues( blockSize, argv[2] );
+        layout = Sudoku::parseFileLayout( blockSize, argv[2] );
     }
     catch( std::exception& ex )
     {
@@ -47,29 +1025,79 @@ int main(int argc, char* argv[] )
         return 2;
     }
 
-    const auto start = std::chrono::steady_clock::now();
-
-    auto s = Sudoku::solve( board );
-
-    const auto end = std::chrono::steady_clock::now();
-
-    if( s.isSolved() )
+    Sudoku::SolverContext context( blockSize );
+    auto winner = settings.portfolio.size();
+    std::size_t sharedHits = 0;
+    std::size_t sharedCollisions = 0;
+    startTrace( settings );
+    try
     {
-        std::cout << "solved sudoku!" << std::endl <<
-            s << std::endl;
+        const auto lookup = openLookup( settings );
+        if( !layout.isStandard() )
+        {
+            // the other engines and the cache only know the standard layout
+            if( settings.engine != Sudoku::Engine::Search || lookup || !settings.portfolio.empty() )
+                throw std::invalid_argument( "variants can only be solved by the search, without a cache or portfolio" );
+            Sudoku::solve( Sudoku::Board( layout, givens ), settings.options, context );
+        }
+        else if( !settings.portfolio.empty() )
+        {
+            const auto portfolio = Sudoku::solvePortfolio( Sudoku::Board( blockSize, givens ), settings.options, settings.portfolio );
+            context.result() = portfolio.result;
+            winner = portfolio.winner;
+            sharedHits = portfolio.sharedHits;
+            sharedCollisions = portfolio.sharedCollisions;
+        }
+        else if( settings.engine == Sudoku::Engine::Anneal )
+            context.result() = Sudoku::anneal( givens, settings.options, settings.annealOptions );
+        else if( settings.engine == Sudoku::Engine::Learn )
+            context.result() = Sudoku::learn( givens, settings.options, settings.learnOptions );
+        else if( lookup )
+            Sudoku::solve( givens, settings.options, context, *lookup );
+        else
+            Sudoku::solve( Sudoku::Board( blockSize, givens ), settings.options, context );
     }
-    else
+    catch( std::exception& ex )
+    {
+        std::cerr << "Failed to solve: " << ex.what() << std::endl << std::endl;
+        return 2;
+    }
+    writeTrace( settings );
+    const auto& result = context.result();
+
+    switch( result.status )
     {
+    case Sudoku::SolveStatus::Solved:
+        std::cout << "solved sudoku!" << std::endl <<
+            result.board << std::endl;
+        break;
+    case Sudoku::SolveStatus::DeadlineExceeded:
+        std::cout << "Timed out!" << std::endl;
+        break;
+    case Sudoku::SolveStatus::NodeLimitExceeded:
+        std::cout << "Node limit reached!" << std::endl;
+        break;
+    case Sudoku::SolveStatus::Cancelled:
+        std::cout << "Cancelled!" << std::endl;
+        break;
+    default:
         std::cout << "Could not solve!" << std::endl;
+        break;
     }
-    
-    std::chrono::duration<double> elapsed_seconds = end - start;
+
+    const auto& elapsed_seconds = result.stats.elapsed;
     
     auto hours = std::chrono::duration_cast< std::chrono::hours >( elapsed_seconds ).count();
     auto minutes = std::chrono::duration_cast< std::chrono::minutes >( elapsed_seconds ).count() % 60;
     auto seconds = std::chrono::duration_cast< std::chrono::seconds >( elapsed_seconds ).count() % 60;
 
     std::cout << "Took " << hours << "h " << minutes << "m " << seconds << "s" << std::endl;
+    std::cout << "Nodes: " << result.stats.nodes << ", max depth: " << result.stats.maxDepth << std::endl;
+    if( winner < settings.portfolio.size() )
+        std::cout << "Won by " << Sudoku::toString( settings.portfolio[winner] ) << std::endl;
+    if( sharedHits + sharedCollisions > 0 )
+        std::cout << "Shared states: " << sharedHits << " hits, " << sharedCollisions << " collisions" << std::endl;
+    writeCounters( std::cout, Sudoku::PerfCounters::parsing(), result.stats.counters, result.stats.propagationCounters );
 
     return 0;
 }
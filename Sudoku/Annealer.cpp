@@ -0,0 +1,633 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "Annealer.h"
+
+using Sudoku::AnnealOptions;
+using Sudoku::Board;
+using Sudoku::Num;
+using Sudoku::SolveOptions;
+using Sudoku::SolveResult;
+using Sudoku::SolveStatus;
+
+namespace
+{
+using Value = std::uint16_t;
+
+/**
+* @brief A swap adds at most one missing value to each of the 2 rows and 2
+* columns it changes, and a move is at most two swaps.
+*/
+constexpr int MaxDelta = 8;
+/**
+* @brief Number of moves between two checks of the limits.
+*/
+constexpr std::size_t CheckInterval = 1024;
+/**
+* @brief Number of random swaps sampled to set the starting temperature.
+*/
+constexpr std::size_t TemperatureSamples = 200;
+constexpr std::size_t NotFree = static_cast< std::size_t >( -1 );
+
+/**
+* @brief The part of the problem shared by every chain: the values fixed by
+* the givens and, block by block, the free cells and the values missing from
+* them.
+*/
+struct Puzzle
+{
+    std::size_t side = 0;
+    std::size_t dim = 0;
+    std::vector<Value> fixed;
+    std::vector<Value> rows;
+    std::vector<Value> columns;
+    // free cells grouped by block, blockStart[b] to blockStart[b + 1]
+    std::vector<std::size_t> free;
+    std::vector<Value> missing;
+    std::vector<std::size_t> blockStart;
+    // the block of each free cell, by position in free
+    std::vector<std::size_t> blockOf;
+    // the position in free of each cell, NotFree for fixed cells
+    std::vector<std::size_t> position;
+    // allowed[position * ( dim + 1 ) + value] tells if the free cell at that
+    // position in free may take the value, from the possibilities left by the givens
+    std::vector<char> allowed;
+
+    explicit Puzzle( const Board& board )
+    {
+        side = board.blockSize();
+        dim = board.dimension();
+        fixed.resize( dim * dim );
+        rows.resize( dim * dim );
+        columns.resize( dim * dim );
+        for( std::size_t i = 0; i < dim; ++i )
+        {
+            for( std::size_t j = 0; j < dim; ++j )
+            {
+                fixed[i * dim + j] = static_cast< Value >( board.at( i, j ) );
+                rows[i * dim + j] = static_cast< Value >( i );
+                columns[i * dim + j] = static_cast< Value >( j );
+            }
+        }
+
+        std::vector<char> present( dim + 1 );
+        for( std::size_t block = 0; block < dim; ++block )
+        {
+            blockStart.push_back( free.size() );
+            std::fill( present.begin(), present.end(), 0 );
+
+            const auto top = block / side * side;
+            const auto left = block % side * side;
+            for( auto i = top; i < top + side; ++i )
+            {
+                for( auto j = left; j < left + side; ++j )
+                {
+                    const auto cell = i * dim + j;
+                    present[fixed[cell]] = 1;
+                    if( !fixed[cell] )
+                    {
+                        free.push_back( cell );
+                        blockOf.push_back( block );
+                    }
+                }
+            }
+            for( std::size_t value = 1; value <= dim; ++value )
+            {
+                if( !present[value] )
+                    missing.push_back( static_cast< Value >( value ) );
+            }
+        }
+        blockStart.push_back( free.size() );
+
+        position.assign( dim * dim, NotFree );
+        for( std::size_t i = 0; i < free.size(); ++i )
+        {
+            position[free[i]] = i;
+        }
+
+        allowed.resize( free.size() * ( dim + 1 ) );
+        for( std::size_t position = 0; position < free.size(); ++position )
+        {
+            const auto row = free[position] / dim;
+            const auto column = free[position] % dim;
+            for( const auto value : board.candidates( row, column ) )
+            {
+                allowed[position * ( dim + 1 ) + value] = 1;
+            }
+        }
+    }
+
+    bool allows( std::size_t freePosition, Value value ) const noexcept
+    {
+        return allowed[freePosition * ( dim + 1 ) + value] != 0;
+    }
+    /**
+    * @brief Gets a cell of a unit: rows are the units 0 to dim - 1, columns
+    * the units dim to 2 * dim - 1.
+    */
+    std::size_t cell( std::size_t unit, std::size_t index ) const noexcept
+    {
+        return unit < dim ? unit * dim + index : index * dim + unit - dim;
+    }
+};
+
+/**
+* @brief The limits checked by every chain, and the flag raised by the first
+* chain reaching a solution.
+*/
+struct Limits
+{
+    const SolveOptions& options;
+    std::atomic<bool> solved{ false };
+
+    explicit Limits( const SolveOptions& solveOptions ) :
+        options( solveOptions )
+    {
+    }
+};
+
+/**
+* @brief An annealing chain: a fill of the free cells that keeps every block
+* valid, and the count of each value in each row and column. The cost is the
+* number of values missing from the rows and columns, 0 for a solution.
+*/
+class Chain
+{
+public:
+    Chain( const Puzzle& puzzle, const AnnealOptions& options, std::uint64_t seed ) :
+        m_puzzle( puzzle ),
+        m_options( options ),
+        m_random( seed ),
+        m_values( puzzle.fixed ),
+        m_counts( 2 * puzzle.dim * ( puzzle.dim + 1 ) ),
+        m_conflictIndex( m_counts.size(), NotFree ),
+        m_owners( puzzle.dim + 1 ),
+        m_visited( puzzle.dim + 1 )
+    {
+        m_conflicts.reserve( m_counts.size() );
+    }
+
+    /**
+    * @brief Anneals until a solution is found, another chain finds one or a
+    * limit is reached. The puzzle is unsolvable if the free cells of a block
+    * can't take its missing values.
+    */
+    SolveStatus run( Limits& limits )
+    {
+        if( m_puzzle.free.empty() )
+            return SolveStatus::Solved;
+        if( !restart() )
+            return SolveStatus::Unsolvable;
+
+        std::uniform_real_distribution<double> uniform( 0.0, 1.0 );
+        const auto maxMoves = limits.options.maxNodes != 0 ? limits.options.maxNodes : static_cast< std::size_t >( -1 );
+        std::size_t levelLength = 0;
+        for( std::size_t block = 0; block < m_puzzle.dim; ++block )
+        {
+            const auto count = m_puzzle.blockStart[block + 1] - m_puzzle.blockStart[block];
+            levelLength += count * count;
+        }
+
+        for( ;; )
+        {
+            if( m_cost == 0 )
+                return SolveStatus::Solved;
+
+            for( std::size_t step = 0; step < levelLength; ++step )
+            {
+                if( m_moves == maxMoves )
+                    return SolveStatus::NodeLimitExceeded;
+                SolveStatus status;
+                if( m_moves % CheckInterval == 0 && limitReached( limits, status ) )
+                    return status;
+                ++m_moves;
+
+                // a free cell in conflict and another one of its block, whose
+                // value it may take
+                const auto first = pickConflicted();
+                const auto block = m_puzzle.blockOf[first];
+                const auto start = m_puzzle.blockStart[block];
+                const auto count = m_puzzle.blockStart[block + 1] - start;
+                if( count < 2 )
+                    continue;
+                auto second = start + std::uniform_int_distribution<std::size_t>( 0, count - 2 )( m_random );
+                second += second >= first;
+
+                const auto a = m_puzzle.free[first];
+                const auto b = m_puzzle.free[second];
+                if( !m_puzzle.allows( first, m_values[b] ) )
+                    continue;
+
+                // Swap their values, or if the second cell can't take the value
+                // of the first, rotate the values of three cells. Swaps alone
+                // can't reach every fill within the possible values.
+                auto third = second;
+                int delta = 0;
+                if( m_puzzle.allows( second, m_values[a] ) )
+                {
+                    delta = swap( a, b );
+                }
+                else
+                {
+                    third = start + std::uniform_int_distribution<std::size_t>( 0, count - 1 )( m_random );
+                    if( third == first || third == second )
+                        continue;
+                    const auto c = m_puzzle.free[third];
+                    if( !m_puzzle.allows( second, m_values[c] ) || !m_puzzle.allows( third, m_values[a] ) )
+                        continue;
+                    delta = swap( a, b ) + swap( b, c );
+                }
+
+                if( delta <= 0 || uniform( m_random ) < m_accept[delta] )
+                {
+                    m_cost += delta;
+                    if( m_cost == 0 )
+                        return SolveStatus::Solved;
+                }
+                else
+                {
+                    if( third != second )
+                        swap( b, m_puzzle.free[third] );
+                    swap( a, b );
+                }
+            }
+
+            if( m_cost < m_bestCost )
+            {
+                m_bestCost = m_cost;
+                m_stale = 0;
+            }
+            else if( ++m_stale >= m_options.restartAfter )
+            {
+                ++m_restarts;
+                restart();
+                continue;
+            }
+            setTemperature( m_temperature * m_options.cooling );
+        }
+    }
+
+    const std::vector<Value>& values() const noexcept
+    {
+        return m_values;
+    }
+    std::size_t moves() const noexcept
+    {
+        return m_moves;
+    }
+    std::size_t restarts() const noexcept
+    {
+        return m_restarts;
+    }
+
+private:
+    const Puzzle& m_puzzle;
+    const AnnealOptions& m_options;
+    std::mt19937_64 m_random;
+    std::vector<Value> m_values;
+    // count of each value in each unit, see Puzzle::cell()
+    std::vector<Value> m_counts;
+    // the unit values counted more than once, and their index in m_conflicts
+    std::vector<std::size_t> m_conflicts;
+    std::vector<std::size_t> m_conflictIndex;
+    std::vector<Value> m_shuffled;
+    // block filling state: the position given each value and the values tried
+    std::vector<std::size_t> m_owners;
+    std::vector<std::size_t> m_visited;
+    std::size_t m_visit = 0;
+    int m_cost = 0;
+    int m_bestCost = 0;
+    std::size_t m_stale = 0;
+    double m_temperature = 0;
+    // probability of accepting a move raising the cost by its index
+    double m_accept[MaxDelta + 1] = {};
+    std::size_t m_moves = 0;
+    std::size_t m_restarts = 0;
+
+    bool limitReached( const Limits& limits, SolveStatus& status ) const
+    {
+        const auto& options = limits.options;
+        if( limits.solved.load( std::memory_order_relaxed ) || options.cancellation.cancelled() )
+            status = SolveStatus::Cancelled;
+        else if( SolveOptions::Clock::now() >= options.deadline )
+            status = SolveStatus::DeadlineExceeded;
+        else
+            return false;
+        return true;
+    }
+
+    /**
+    * @brief Picks a free cell whose value is repeated in its row or column.
+    * There is one as long as the cost is not 0, since the fixed cells don't
+    * conflict with each other.
+    * @return the position of the cell in free.
+    */
+    std::size_t pickConflicted()
+    {
+        const auto key = m_conflicts[std::uniform_int_distribution<std::size_t>( 0, m_conflicts.size() - 1 )( m_random )];
+        const auto unit = key / ( m_puzzle.dim + 1 );
+        const auto value = key % ( m_puzzle.dim + 1 );
+
+        std::size_t chosen = NotFree;
+        std::size_t found = 0;
+        for( std::size_t i = 0; i < m_puzzle.dim; ++i )
+        {
+            const auto cell = m_puzzle.cell( unit, i );
+            const auto position = m_puzzle.position[cell];
+            if( m_values[cell] == value && position != NotFree &&
+                std::uniform_int_distribution<std::size_t>( 0, found++ )( m_random ) == 0 )
+            {
+                chosen = position;
+            }
+        }
+        return chosen;
+    }
+
+    /**
+    * @brief Swaps the values of two cells of a block and updates the counts.
+    * @return the change of the cost.
+    */
+    int swap( std::size_t a, std::size_t b ) noexcept
+    {
+        const auto x = m_values[a];
+        const auto y = m_values[b];
+        m_values[a] = y;
+        m_values[b] = x;
+
+        const auto dim = m_puzzle.dim;
+        return move( m_puzzle.rows[a], x, y ) +
+            move( m_puzzle.rows[b], y, x ) +
+            move( dim + m_puzzle.columns[a], x, y ) +
+            move( dim + m_puzzle.columns[b], y, x );
+    }
+
+    /**
+    * @brief Replaces a value by another in a unit.
+    * @return the change of the number of values missing from it.
+    */
+    int move( std::size_t unit, Value from, Value to ) noexcept
+    {
+        const auto base = unit * ( m_puzzle.dim + 1 );
+        int delta = 0;
+
+        const auto left = --m_counts[base + from];
+        if( left == 0 )
+            ++delta;
+        else if( left == 1 )
+            resolve( base + from );
+
+        const auto had = m_counts[base + to]++;
+        if( had == 0 )
+            --delta;
+        else if( had == 1 )
+            conflict( base + to );
+        return delta;
+    }
+
+    void conflict( std::size_t key ) noexcept
+    {
+        m_conflictIndex[key] = m_conflicts.size();
+        m_conflicts.push_back( key );
+    }
+
+    void resolve( std::size_t key ) noexcept
+    {
+        const auto index = m_conflictIndex[key];
+        m_conflicts[index] = m_conflicts.back();
+        m_conflictIndex[m_conflicts[index]] = index;
+        m_conflicts.pop_back();
+        m_conflictIndex[key] = NotFree;
+    }
+
+    /**
+    * @brief Fills the free cells of every block with a random permutation of
+    * its missing values, each cell taking one of its possible values, then
+    * sets the starting temperature to the standard deviation of the cost
+    * change of random swaps.
+    * @return False if the cells of a block can't take its missing values.
+    */
+    bool restart()
+    {
+        const auto dim = m_puzzle.dim;
+        for( std::size_t block = 0; block < dim; ++block )
+        {
+            if( !fill( block ) )
+                return false;
+        }
+
+        std::fill( m_counts.begin(), m_counts.end(), 0 );
+        for( std::size_t cell = 0; cell < m_values.size(); ++cell )
+        {
+            ++m_counts[m_puzzle.rows[cell] * ( dim + 1 ) + m_values[cell]];
+            ++m_counts[( dim + m_puzzle.columns[cell] ) * ( dim + 1 ) + m_values[cell]];
+        }
+        m_cost = 0;
+        m_conflicts.clear();
+        std::fill( m_conflictIndex.begin(), m_conflictIndex.end(), NotFree );
+        for( std::size_t unit = 0; unit < 2 * dim; ++unit )
+        {
+            for( std::size_t value = 1; value <= dim; ++value )
+            {
+                const auto key = unit * ( dim + 1 ) + value;
+                m_cost += m_counts[key] == 0;
+                if( m_counts[key] > 1 )
+                    conflict( key );
+            }
+        }
+        m_bestCost = m_cost;
+        m_stale = 0;
+
+        std::uniform_int_distribution<std::size_t> pickFree( 0, m_puzzle.free.size() - 1 );
+        double sum = 0, squares = 0;
+        std::size_t samples = 0;
+        for( std::size_t i = 0; i < TemperatureSamples; ++i )
+        {
+            const auto first = pickFree( m_random );
+            const auto block = m_puzzle.blockOf[first];
+            const auto start = m_puzzle.blockStart[block];
+            const auto count = m_puzzle.blockStart[block + 1] - start;
+            if( count < 2 )
+                continue;
+            const auto second = start + std::uniform_int_distribution<std::size_t>( 0, count - 1 )( m_random );
+            if( second == first )
+                continue;
+
+            const auto a = m_puzzle.free[first];
+            const auto b = m_puzzle.free[second];
+            if( !m_puzzle.allows( first, m_values[b] ) || !m_puzzle.allows( second, m_values[a] ) )
+                continue;
+            const auto delta = swap( a, b );
+            swap( a, b );
+            sum += delta;
+            squares += delta * delta;
+            ++samples;
+        }
+        const auto mean = samples ? sum / samples : 0.0;
+        const auto variance = samples ? squares / samples - mean * mean : 0.0;
+        setTemperature( std::max( std::sqrt( std::max( variance, 0.0 ) ), 0.5 ) );
+        return true;
+    }
+
+    /**
+    * @brief Gives the missing values of a block to its free cells, as a
+    * random perfect matching of the cells to their possible values.
+    * @return False if there is no such matching.
+    */
+    bool fill( std::size_t block )
+    {
+        const auto start = m_puzzle.blockStart[block];
+        const auto end = m_puzzle.blockStart[block + 1];
+        m_shuffled.assign( m_puzzle.missing.begin() + start, m_puzzle.missing.begin() + end );
+        std::shuffle( m_shuffled.begin(), m_shuffled.end(), m_random );
+        for( auto value : m_shuffled )
+        {
+            m_owners[value] = end;
+        }
+
+        for( auto position = start; position < end; ++position )
+        {
+            ++m_visit;
+            if( !augment( position, end ) )
+                return false;
+        }
+        for( auto value : m_shuffled )
+        {
+            m_values[m_puzzle.free[m_owners[value]]] = value;
+        }
+        return true;
+    }
+
+    /**
+    * @brief Finds a value for a cell, moving the cells holding the values it
+    * may take to other values if needed.
+    * @param position the position of the cell in free
+    * @param none the owner of values given to no cell yet
+    * @return True if the cell was given a value.
+    */
+    bool augment( std::size_t position, std::size_t none )
+    {
+        for( auto value : m_shuffled )
+        {
+            if( !m_puzzle.allows( position, value ) || m_visited[value] == m_visit )
+                continue;
+
+            m_visited[value] = m_visit;
+            if( m_owners[value] == none || augment( m_owners[value], none ) )
+            {
+                m_owners[value] = position;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void setTemperature( double temperature ) noexcept
+    {
+        m_temperature = temperature;
+        for( int delta = 0; delta <= MaxDelta; ++delta )
+        {
+            m_accept[delta] = std::exp( -delta / temperature );
+        }
+    }
+};
+
+/**
+* @brief Mixes the seed of the solve with the index of a chain, so chains with
+* neighbouring seeds don't run correlated generators.
+*/
+std::uint64_t chainSeed( std::uint64_t seed, std::size_t chain ) noexcept
+{
+    auto z = seed + ( chain + 1 ) * 0x9E3779B97F4A7C15ull;
+    z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+    z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBull;
+    return z ^ ( z >> 31 );
+}
+}
+
+SolveResult Sudoku::anneal( const Board::InputArray& givens, const SolveOptions& options, const AnnealOptions& annealOptions )
+{
+    const auto start = SolveOptions::Clock::now();
+    const auto dim = static_cast< Num >( givens.size() );
+    Num blockSize = 1;
+    while( blockSize * blockSize < dim )
+    {
+        ++blockSize;
+    }
+    if( dim == 0 || blockSize * blockSize != dim || dim > 0xFFFF ||
+        std::any_of( givens.begin(), givens.end(), [dim]( const Nums& row ) { return row.size() != dim; } ) )
+    {
+        throw std::invalid_argument( "unsupported board dimension: " + std::to_string( dim ) );
+    }
+
+    // the cells forced by the givens are fixed before annealing
+    Board board( blockSize, givens );
+    SolveResult result{ SolveStatus::Unsolvable, board, {} };
+    if( !board.isValid() )
+    {
+        result.stats.elapsed = SolveOptions::Clock::now() - start;
+        return result;
+    }
+
+    const Puzzle puzzle( board );
+    Limits limits( options );
+    std::vector<Chain> chains;
+    const auto count = std::max<std::size_t>( 1, annealOptions.chains );
+    chains.reserve( count );
+    for( std::size_t i = 0; i < count; ++i )
+    {
+        chains.emplace_back( puzzle, annealOptions, chainSeed( options.seed, i ) );
+    }
+
+    std::vector<SolveStatus> statuses( count, SolveStatus::Cancelled );
+    std::mutex mutex;
+    std::size_t winner = count;
+    const auto runChain = [&]( std::size_t i )
+        {
+            statuses[i] = chains[i].run( limits );
+            if( statuses[i] == SolveStatus::Solved )
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                if( winner == count )
+                    winner = i;
+                limits.solved = true;
+            }
+        };
+
+    std::vector<std::thread> threads;
+    for( std::size_t i = 1; i < count; ++i )
+    {
+        threads.emplace_back( runChain, i );
+    }
+    runChain( 0 );
+    for( auto& thread : threads )
+    {
+        thread.join();
+    }
+
+    for( const auto& chain : chains )
+    {
+        result.stats.nodes += chain.moves();
+        result.stats.maxDepth += chain.restarts();
+    }
+
+    if( winner != count )
+    {
+        const auto& values = chains[winner].values();
+        result.status = SolveStatus::Solved;
+        result.board = Board( blockSize, values.begin(), values.end() );
+    }
+    else
+    {
+        // every chain stopped on the same limit, unless the caller cancelled
+        result.status = statuses[0];
+    }
+
+    result.stats.elapsed = SolveOptions::Clock::now() - start;
+    return result;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+
+#include "Board.h"
+#include "SolveOptions.h"
+
+namespace Sudoku
+{
+
+/**
+* @brief Settings of the simulated annealing engine.
+*/
+struct AnnealOptions
+{
+    /**
+    * @brief Number of independent chains, each run on its own thread.
+    */
+    std::size_t chains = 1;
+    /**
+    * @brief A chain restarts from a new random fill after this many
+    * temperature levels without improving its best cost.
+    */
+    std::size_t restartAfter = 200;
+    /**
+    * @brief Factor applied to the temperature after each level, below 1.
+    */
+    double cooling = 0.99;
+};
+
+/**
+* @brief Solves a puzzle by stochastic local search rather than backtracking,
+* which scales to boards too large for the search to explore (49x49 and up).
+*
+* The cells the givens force are fixed first. Each block is then filled with a
+* permutation of its missing values, every cell taking one of its possible
+* values, so blocks never conflict. Simulated annealing then minimizes the
+* number of values missing from rows and columns: a move swaps the values of a
+* conflicting cell and another cell of its block, or rotates the values of
+* three cells of the block when a swap would leave the possible values. The
+* cost is updated incrementally on every move. A chain that stops improving
+* restarts from a new random fill.
+*
+* Several chains run in parallel, seeded from SolveOptions::seed, and the solve
+* returns as soon as one of them reaches zero conflicts. Each chain is
+* reproducible from the seed, but which chain finishes first depends on
+* thread scheduling.
+*
+* Local search can't prove that a puzzle has no solution: unless the givens
+* leave a block unable to take its missing values, the solve only stops on a
+* solution or on one of the limits of the options. SolveOptions::maxNodes
+* bounds the moves tried by each chain and SolveOptions::valueOrder is ignored.
+* The statistics report the moves tried by all chains as nodes and the number
+* of restarts as maxDepth.
+*
+* @param givens the values of the puzzle, 0 denoting empty cells
+* @param options the limits to apply to the solve and the seed of the chains
+* @param annealOptions the settings of the annealing
+* @return The outcome of the solve along with its statistics.
+* @throw std::invalid_argument if the givens are not a valid board
+*/
+SolveResult anneal( const Board::InputArray& givens, const SolveOptions& options = {}, const AnnealOptions& annealOptions = {} );
+
+} // namespace
@@ -0,0 +1,300 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+
+#include "BatchSolver.h"
+#include "Solver.h"
+
+using Sudoku::BatchSolver;
+using Sudoku::Num;
+
+constexpr std::size_t BatchSolver::Lanes;
+constexpr Num BatchSolver::Cells;
+
+namespace
+{
+constexpr Num Dimension = 9;
+constexpr std::uint16_t AllValues = ( 1 << Dimension ) - 1;
+
+using Units = std::array<std::array<std::uint8_t, Dimension>, 3 * Dimension>;
+
+/**
+* @brief Gets the cells of the rows, columns and quadrants of a 9x9 board.
+*/
+const Units& standardUnits()
+{
+    static const Units units = []()
+        {
+            Units table;
+            for( Num unit = 0; unit < Dimension; ++unit )
+            {
+                for( Num position = 0; position < Dimension; ++position )
+                {
+                    table[unit][position] = static_cast< std::uint8_t >( unit * Dimension + position );
+                    table[Dimension + unit][position] = static_cast< std::uint8_t >( position * Dimension + unit );
+                    const auto row = unit / 3 * 3 + position / 3;
+                    const auto column = unit % 3 * 3 + position % 3;
+                    table[2 * Dimension + unit][position] = static_cast< std::uint8_t >( row * Dimension + column );
+                }
+            }
+            return table;
+        }();
+    return units;
+}
+
+/**
+* @brief The three cells a quadrant shares with a row or column, and the other
+* cells of each.
+*/
+struct Intersection
+{
+    std::array<std::uint8_t, 3> shared;
+    std::array<std::uint8_t, 6> quadrant;
+    std::array<std::uint8_t, 6> line;
+};
+
+using Intersections = std::array<Intersection, 6 * Dimension>;
+
+/**
+* @brief Gets the intersections of each quadrant with its rows and columns.
+*/
+const Intersections& standardIntersections()
+{
+    static const Intersections intersections = []()
+        {
+            const auto& units = standardUnits();
+            Intersections table;
+            std::size_t index = 0;
+            for( Num quadrant = 0; quadrant < Dimension; ++quadrant )
+            {
+                const auto& quadrantCells = units[2 * Dimension + quadrant];
+                for( Num offset = 0; offset < 3; ++offset )
+                {
+                    const Num lines[] = { quadrant / 3 * 3 + offset, Dimension + quadrant % 3 * 3 + offset };
+                    for( const auto line : lines )
+                    {
+                        auto& intersection = table[index++];
+                        const auto& lineCells = units[line];
+                        std::size_t shared = 0;
+                        std::size_t quadrantRest = 0;
+                        std::size_t lineRest = 0;
+                        for( const auto cell : quadrantCells )
+                        {
+                            if( std::find( lineCells.begin(), lineCells.end(), cell ) != lineCells.end() )
+                                intersection.shared[shared++] = cell;
+                            else
+                                intersection.quadrant[quadrantRest++] = cell;
+                        }
+                        for( const auto cell : lineCells )
+                        {
+                            if( std::find( quadrantCells.begin(), quadrantCells.end(), cell ) == quadrantCells.end() )
+                                intersection.line[lineRest++] = cell;
+                        }
+                    }
+                }
+            }
+            return table;
+        }();
+    return intersections;
+}
+
+/**
+* @brief Gets the value of a cell with a single candidate.
+*/
+Num valueOf( std::uint16_t candidates ) noexcept
+{
+    Num value = 1;
+    while( !( candidates & 1 ) )
+    {
+        candidates >>= 1;
+        ++value;
+    }
+    return value;
+}
+
+bool isSingle( std::uint16_t candidates ) noexcept
+{
+    return ( candidates & ( candidates - 1 ) ) == 0;
+}
+}
+
+
+BatchSolver::BatchSolver() :
+    m_context( 3 ),
+    m_givens( Cells )
+{
+}
+
+
+void BatchSolver::solve( const Num* puzzles, std::size_t count, Num* solutions, SolveStatus* statuses, const SolveOptions& options, SolveStats* stats )
+{
+    for( std::size_t first = 0; first < count; first += Lanes )
+    {
+        const auto start = SolveOptions::Clock::now();
+        // the lanes past the last puzzle hold empty boards, which propagation leaves alone
+        const auto lanes = std::min( Lanes, count - first );
+        for( Num cell = 0; cell < Cells; ++cell )
+        {
+            for( std::size_t lane = 0; lane < Lanes; ++lane )
+            {
+                const auto value = lane < lanes ? puzzles[( first + lane ) * Cells + cell] : 0;
+                if( value > Dimension )
+                    throw std::invalid_argument( "Value " + std::to_string( value ) + " out of range" );
+                m_candidates[cell][lane] = value ? static_cast< Lane >( 1 << ( value - 1 ) ) : AllValues;
+            }
+        }
+        std::fill( std::begin( m_contradictions ), std::end( m_contradictions ), 0 );
+        propagate();
+        const std::chrono::duration<double> elapsed = SolveOptions::Clock::now() - start;
+
+        for( std::size_t lane = 0; lane < lanes; ++lane )
+        {
+            const auto* puzzle = puzzles + ( first + lane ) * Cells;
+            auto* solution = solutions + ( first + lane ) * Cells;
+            auto& status = statuses[first + lane];
+            bool contradiction = m_contradictions[lane] != 0;
+            bool complete = true;
+            for( Num cell = 0; cell < Cells; ++cell )
+            {
+                const auto candidates = m_candidates[cell][lane];
+                contradiction |= candidates == 0;
+                complete &= isSingle( candidates );
+                m_givens[cell] = isSingle( candidates ) && candidates ? valueOf( candidates ) : 0;
+            }
+
+            if( contradiction || complete )
+            {
+                // with no repeated value in any unit, a complete board is a solution
+                status = contradiction ? SolveStatus::Unsolvable : SolveStatus::Solved;
+                const auto* values = contradiction ? puzzle : m_givens.data();
+                std::copy( values, values + Cells, solution );
+                if( stats )
+                {
+                    stats[first + lane] = SolveStats{};
+                    stats[first + lane].elapsed = elapsed;
+                }
+                ++m_propagated;
+                continue;
+            }
+
+            const auto& result = Sudoku::solve( Board( 3, m_givens.data() ), options, m_context );
+            status = result.status;
+            for( Num cell = 0; cell < Cells; ++cell )
+            {
+                solution[cell] = status == SolveStatus::Solved ? result.board.at( cell / Dimension, cell % Dimension ) : puzzle[cell];
+            }
+            if( stats )
+            {
+                stats[first + lane] = result.stats;
+                stats[first + lane].elapsed += elapsed;
+            }
+            ++m_searched;
+        }
+    }
+}
+
+
+void BatchSolver::propagate() noexcept
+{
+    while( pass() )
+    {
+    }
+}
+
+
+BatchSolver::Lane BatchSolver::pass() noexcept
+{
+    Lane changed[Lanes] = {};
+    for( const auto& unit : standardUnits() )
+    {
+        // the values in one cell of the unit or more, in two or more, and
+        // those assigned
+        Lane once[Lanes] = {};
+        Lane twice[Lanes] = {};
+        Lane assigned[Lanes] = {};
+        Lane repeated[Lanes] = {};
+        for( const auto cell : unit )
+        {
+            const auto* candidates = m_candidates[cell];
+            for( std::size_t lane = 0; lane < Lanes; ++lane )
+            {
+                const Lane value = candidates[lane];
+                const Lane single = isSingle( value ) ? value : 0;
+                repeated[lane] |= assigned[lane] & single;
+                assigned[lane] |= single;
+                twice[lane] |= once[lane] & value;
+                once[lane] |= value;
+            }
+        }
+
+        for( const auto cell : unit )
+        {
+            auto* candidates = m_candidates[cell];
+            for( std::size_t lane = 0; lane < Lanes; ++lane )
+            {
+                const Lane value = candidates[lane];
+                // naked singles leave the other cells, hidden singles take their cell
+                const Lane naked = isSingle( value ) ? value : value & ~assigned[lane];
+                const Lane hidden = naked & once[lane] & ~twice[lane];
+                const Lane next = hidden ? hidden : naked;
+                // a cell can't take two values
+                m_contradictions[lane] |= hidden & ( hidden - 1 );
+                changed[lane] |= next ^ value;
+                candidates[lane] = next;
+            }
+        }
+
+        for( std::size_t lane = 0; lane < Lanes; ++lane )
+        {
+            m_contradictions[lane] |= repeated[lane] | ( AllValues & ~once[lane] );
+        }
+    }
+
+    // a value of a quadrant only in the cells it shares with a line can't be
+    // in the rest of the line (pointing), and the other way around (claiming)
+    for( const auto& intersection : standardIntersections() )
+    {
+        Lane shared[Lanes] = {};
+        Lane quadrant[Lanes] = {};
+        Lane line[Lanes] = {};
+        for( const auto cell : intersection.shared )
+        {
+            for( std::size_t lane = 0; lane < Lanes; ++lane )
+            {
+                shared[lane] |= m_candidates[cell][lane];
+            }
+        }
+        for( std::size_t position = 0; position < intersection.quadrant.size(); ++position )
+        {
+            const auto* inQuadrant = m_candidates[intersection.quadrant[position]];
+            const auto* inLine = m_candidates[intersection.line[position]];
+            for( std::size_t lane = 0; lane < Lanes; ++lane )
+            {
+                quadrant[lane] |= inQuadrant[lane];
+                line[lane] |= inLine[lane];
+            }
+        }
+        for( std::size_t position = 0; position < intersection.quadrant.size(); ++position )
+        {
+            auto* inQuadrant = m_candidates[intersection.quadrant[position]];
+            auto* inLine = m_candidates[intersection.line[position]];
+            for( std::size_t lane = 0; lane < Lanes; ++lane )
+            {
+                const Lane claimed = inQuadrant[lane] & ~( shared[lane] & ~line[lane] );
+                const Lane pointed = inLine[lane] & ~( shared[lane] & ~quadrant[lane] );
+                changed[lane] |= ( claimed ^ inQuadrant[lane] ) | ( pointed ^ inLine[lane] );
+                inQuadrant[lane] = claimed;
+                inLine[lane] = pointed;
+            }
+        }
+    }
+
+    Lane any = 0;
+    for( std::size_t lane = 0; lane < Lanes; ++lane )
+    {
+        any |= changed[lane];
+    }
+    return any;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "SolveOptions.h"
+#include "SolverContext.h"
+
+namespace Sudoku
+{
+
+/**
+* @brief Solves standard 9x9 puzzles Lanes at a time, for high volumes of easy
+* puzzles whose cost is mostly the setup of a board and branchy propagation.
+*
+* The candidates of all the puzzles are kept cell by cell, a lane per puzzle,
+* and naked and hidden singles and locked candidates are propagated on all the
+* lanes at once with branch free loops the compiler vectorizes. Most easy puzzles are solved or
+* found unsolvable that way; the others are handed to solve() with the values
+* deduced as givens. Not thread safe: use a solver per thread.
+*/
+class BatchSolver
+{
+public:
+    /**
+    * @brief The number of puzzles propagated together.
+    */
+    static constexpr std::size_t Lanes = 16;
+    /**
+    * @brief The number of cells of a puzzle.
+    */
+    static constexpr Num Cells = 81;
+
+    BatchSolver();
+
+    /**
+    * @brief Solves puzzles stored one after another. Puzzles whose givens
+    * repeat a value in a unit are unsolvable.
+    * @param puzzles the count puzzles, each Cells values in row order, 0 for
+    * an empty cell
+    * @param solutions receives the solution of each puzzle, or its values if
+    * it wasn't solved
+    * @param statuses receives the outcome of each puzzle
+    * @param options the limits and heuristics of the puzzles that need search
+    * @param stats if not null, receives the statistics of each puzzle: the
+    * time of its group of Lanes, plus that of its search if it needed one
+    * @throw std::invalid_argument if a value is over 9
+    */
+    void solve( const Num* puzzles, std::size_t count, Num* solutions, SolveStatus* statuses, const SolveOptions& options = {}, SolveStats* stats = nullptr );
+
+    /**
+    * @brief Gets the number of puzzles settled by propagation alone so far.
+    */
+    std::size_t propagated() const noexcept
+    {
+        return m_propagated;
+    }
+    /**
+    * @brief Gets the number of puzzles handed to the search so far.
+    */
+    std::size_t searched() const noexcept
+    {
+        return m_searched;
+    }
+
+private:
+    using Lane = std::uint16_t;
+
+    SolverContext m_context;
+    // the candidates of each cell, one bit per value, for each lane
+    alignas( 64 ) Lane m_candidates[Cells][Lanes];
+    // set in the lanes of puzzles found contradictory
+    Lane m_contradictions[Lanes];
+    std::size_t m_propagated = 0;
+    std::size_t m_searched = 0;
+    Nums m_givens;
+
+    /**
+    * @brief Propagates singles and locked candidates on all the lanes until
+    * none changes.
+    */
+    void propagate() noexcept;
+    /**
+    * @brief Runs a propagation pass over the units and their intersections.
+    * @return Nonzero if a lane changed.
+    */
+    Lane pass() noexcept;
+};
+
+} // namespace
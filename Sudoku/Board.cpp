@@ -1,30 +1,133 @@
+#include <algorithm>
+#include <memory>
 #include <stdexcept>
+#include <string>
 
 #include "Board.h"
+#include "PerfCounters.h"
+#include "Trace.h"
 #include "Utils.h"
 
 using Sudoku::Board;
 using Sudoku::Num;
 using Sudoku::Cell;
+using Sudoku::Candidates;
 using Sudoku::CoordPossibilitiesList;
+using Sudoku::Layout;
+using Sudoku::UnitCells;
+
+namespace
+{
+/**
+* @brief Gets the layout of standard boards of a block size. Boards are
+* constructed all the time, so each thread builds it once and shares it.
+*/
+std::shared_ptr<const Layout> standardLayout( Num blockSize )
+{
+    thread_local std::vector<std::shared_ptr<const Layout>> layouts;
+    if( layouts.size() <= blockSize )
+        layouts.resize( blockSize + 1 );
+
+    auto& layout = layouts[blockSize];
+    if( !layout )
+        layout = std::make_shared<const Layout>( blockSize );
+    return layout;
+}
+
+/**
+* @brief Gets the values of the cells of a board of a dimension.
+* @throw std::invalid_argument if there isn't a value per cell
+*/
+const Num* cellValues( const Sudoku::Nums& values, Num dimension )
+{
+    const auto cells = static_cast< std::size_t >( dimension ) * dimension;
+    if( values.size() != cells )
+        throw std::invalid_argument( "expected " + std::to_string( cells ) + " values" );
+    return values.data();
+}
+}
+
 
 Board::Board( Num dims ) :
+    m_layout( standardLayout( dims ) ),
     m_blockSide( dims ),
     m_dimension( m_blockSide* m_blockSide ),
-    m_board( m_dimension, Cells( m_dimension, Cell( m_dimension ) ) )
+    m_cells( m_dimension * m_dimension, Cell( m_dimension ) )
 {
+    rebuildPlaces();
 }
 
 
 Board::Board( Num dims, const Board::InputArray& values ) :
+    m_layout( standardLayout( dims ) ),
+    m_blockSide( dims ),
+    m_dimension( m_blockSide* m_blockSide ),
+    m_cells( m_dimension * m_dimension, Cell( m_dimension ) )
+{
+    assign( [&values]( Num i, Num j ) { return values[i][j]; } );
+}
+
+
+Board::Board( const Layout& layout ) :
+    m_layout( std::make_shared<const Layout>( layout ) ),
+    m_blockSide( layout.blockSize() ),
+    m_dimension( layout.dimension() ),
+    m_cells( m_dimension * m_dimension, Cell( m_dimension ) )
+{
+    rebuildPlaces();
+    updatePossibleValues();
+}
+
+
+Board::Board( const Layout& layout, const InputArray& values ) :
+    m_layout( std::make_shared<const Layout>( layout ) ),
+    m_blockSide( layout.blockSize() ),
+    m_dimension( layout.dimension() ),
+    m_cells( m_dimension * m_dimension, Cell( m_dimension ) )
+{
+    assign( [&values]( Num i, Num j ) { return values[i][j]; } );
+}
+
+
+Board::Board( Num dims, const Nums& values ) :
+    Board( dims, cellValues( values, dims * dims ) )
+{
+}
+
+
+Board::Board( const Layout& layout, const Nums& values ) :
+    Board( layout, cellValues( values, layout.dimension() ) )
+{
+}
+
+
+Board::Board( Num dims, const Num* values ) :
+    m_layout( standardLayout( dims ) ),
     m_blockSide( dims ),
     m_dimension( m_blockSide* m_blockSide ),
-    m_board( m_dimension, Cells( m_dimension, Cell( m_dimension ) ) )
+    m_cells( m_dimension * m_dimension, Cell( m_dimension ) )
+{
+    assign( [this, values]( Num i, Num j ) { return values[i * m_dimension + j]; } );
+}
+
+
+Board::Board( const Layout& layout, const Num* values ) :
+    m_layout( std::make_shared<const Layout>( layout ) ),
+    m_blockSide( layout.blockSize() ),
+    m_dimension( layout.dimension() ),
+    m_cells( m_dimension * m_dimension, Cell( m_dimension ) )
+{
+    assign( [this, values]( Num i, Num j ) { return values[i * m_dimension + j]; } );
+}
+
+
+template<typename Value>
+void Board::assign( Value&& value )
 {
     performInCells(
-        [this, &values]( auto i, auto j, Cell& cell )
+        [this, &value]( auto i, auto j, Cell& cell )
         {
-            auto& val = values[i][j];
+            const auto val = value( i, j );
             checkValue( m_dimension, val );
 
             if( val != 0 )
@@ -34,6 +137,7 @@ Board::Board( Num dims, const Board::InputArray& values ) :
             return true;
         }
     );
+    rebuildPlaces();
 
     if( !isValid() )
         throw std::invalid_argument( "board has invalid values" );
@@ -49,31 +153,107 @@ Board::Board( const Board& other )
 
 Board& Board::operator=( const Board& other )
 {
-    this->m_board = other.m_board;
+    this->m_layout = other.m_layout;
+    this->m_cells = other.m_cells;
+    this->m_places = other.m_places;
     this->m_blockSide = other.m_blockSide;
     this->m_dimension = other.m_dimension;
+    // recorded changes point into the other board's cells
+    this->m_recording = false;
+    this->m_trail.clear();
     return *this;
 }
 
+// the cells keep their storage, so the recorded changes still point into them
+Board::Board( Board&& other ) noexcept = default;
+
+Board& Board::operator=( Board&& other ) noexcept = default;
+
 Num Board::at( Num row, Num col ) const
 {
     checkCoords( m_dimension, row, col );
-    return m_board[row][col].getVal();
+    return m_cells[row * m_dimension + col].getVal();
 }
 
 
 Cell Board::cell( Num row, Num col ) const
 {
     checkCoords( m_dimension, row, col );
-    return m_board[row][col];
+    return m_cells[row * m_dimension + col];
+}
+
+
+const Cell& Board::cellRef( Num row, Num col ) const
+{
+    checkCoords( m_dimension, row, col );
+    return m_cells[row * m_dimension + col];
+}
+
+
+Candidates Board::candidates( Num row, Num col ) const
+{
+    return cellRef( row, col ).candidates();
+}
+
+
+UnitCells Board::unitCells( std::size_t unit ) const
+{
+    if( unit >= m_layout->unitCount() )
+        throw std::out_of_range( "invalid unit: " + std::to_string( unit ) );
+    return UnitCells( m_cells.data(), m_layout->unit( unit ), m_dimension );
 }
 
 
 void Board::set( Num row, Num col, Num number )
 {
     checkCoords( m_dimension, row, col );
-    m_board[row][col].setVal( number );
+    checkValue( m_dimension, number );
+    TraceScope trace( "set", "cell", row * m_dimension + col );
+    place( row, col, number );
+    updatePossibleValues();
+}
+
+
+void Board::place( Num row, Num col, Num number )
+{
+    checkCoords( m_dimension, row, col );
+    checkValue( m_dimension, number );
 
+    auto& cell = m_cells[row * m_dimension + col];
+    bool present = false;
+    for( const auto n : cell.candidates() )
+    {
+        if( n != number )
+        {
+            updatePlaces( cell, n, false );
+            if( m_recording )
+                m_trail.push_back( { &cell, n, false } );
+        }
+        else
+        {
+            present = true;
+        }
+    }
+    if( !present )
+    {
+        updatePlaces( cell, number, true );
+        if( m_recording )
+            m_trail.push_back( { &cell, number, true } );
+    }
+    cell.setVal( number );
+}
+
+
+bool Board::exclude( Num row, Num col, Num number )
+{
+    checkCoords( m_dimension, row, col );
+    checkValue( m_dimension, number );
+    return eliminate( m_cells[row * m_dimension + col], number );
+}
+
+
+void Board::propagate() noexcept
+{
     updatePossibleValues();
 }
 
@@ -102,6 +282,97 @@ CoordPossibilitiesList Board::sortedPossibilities()
 }
 
 
+bool Board::mostConstrainedCell( Num& row, Num& col ) const noexcept
+{
+    bool found = false;
+    std::size_t best = 0;
+
+    performInCells(
+        [&]( auto i, auto j, const Cell& cell )
+        {
+            const auto count = cell.count();
+            if( count != 1 && ( !found || count < best ) )
+            {
+                found = true;
+                best = count;
+                row = i;
+                col = j;
+            }
+            // a cell with no possibilities can't be beaten
+            return !found || best != 0;
+        } );
+
+    return found;
+}
+
+
+Num Board::possibility( Num row, Num col, std::size_t index ) const
+{
+    checkCoords( m_dimension, row, col );
+    return m_cells[row * m_dimension + col].possibility( index );
+}
+
+
+void Board::countPeerPossibilities( Num row, Num col, std::vector<std::size_t>& counts ) const
+{
+    checkCoords( m_dimension, row, col );
+    counts.assign( m_dimension + 1, 0 );
+
+    const auto count = [&counts]( const Cell& cell )
+        {
+            if( cell.count() < 2 )
+                return;
+            for( const auto n : cell.candidates() )
+            {
+                ++counts[n];
+            }
+        };
+
+    const auto index = row * m_dimension + col;
+    const auto units = m_layout->memberships( index );
+    for( auto unit = units.first; unit != units.second; ++unit )
+    {
+        const auto* cells = m_layout->unit( unit->unit );
+        for( Num i = 0; i < m_dimension; ++i )
+        {
+            // a peer sharing several units with the cell counts in the first
+            const auto peer = cells[i];
+            const auto counted = std::any_of( units.first, unit,
+                [this, peer]( const Layout::Membership& earlier ) { return m_layout->contains( earlier.unit, peer ); } );
+            if( peer != index && !counted )
+                count( m_cells[peer] );
+        }
+    }
+}
+
+
+void Board::recordChanges( bool enable )
+{
+    m_recording = enable;
+    m_trail.clear();
+    if( enable )
+    {
+        // worst case: every possibility of every cell is removed once
+        m_trail.reserve( m_dimension * m_dimension * m_dimension );
+    }
+}
+
+
+void Board::rollback( std::size_t checkpoint )
+{
+    while( m_trail.size() > checkpoint )
+    {
+        const auto& change = m_trail.back();
+        if( change.added )
+            change.cell->remove( change.value );
+        else
+            change.cell->restore( change.value );
+        updatePlaces( *change.cell, change.value, !change.added );
+        m_trail.pop_back();
+    }
+}
+
+
 bool Board::isValid()
 {
     bool result = true;
@@ -109,50 +380,37 @@ bool Board::isValid()
     performInCells(
         [&result, this]( auto i, auto j, auto& cell )
         {
-            if( cell.possibilities().empty() )
+            if( cell.count() == 0 )
             {
                 m_offendingVal = std::make_tuple( i, j, ( Num )0, ( Num )0, ( Num )0 );
                 result = false;
-                return false;
-            }
-
-            if( cell.hasVal() )
-            {
-                auto val = cell.getVal();
-                // search in row and column for same value
-                for( Num k = 0; k < m_dimension; ++k )
-                {
-                    if( k != i )
-                    {
-                        auto& cell2 = m_board[k][j];
-                        if( cell2.hasVal() && val == cell2.getVal() )
-                        {
-                            m_offendingVal = std::make_tuple( i, j, k, j, val );
-                            result = false;
-                            break;
-                        }
-                    }
-                    if( k != j )
-                    {
-                        auto& cell2 = m_board[i][k];
-                        if( cell2.hasVal() && val == cell2.getVal() )
-                        {
-                            m_offendingVal = std::make_tuple( i, j, i, k, val );
-                            result = false;
-                            break;
-                        }
-                    }
-                }
             }
             return result;
         }
     );
-    for( Num i = 0; i < m_dimension; ++i )
+
+    const auto units = m_layout->unitCount();
+    for( std::size_t unit = 0; result && unit < units; ++unit )
+    {
+        result = validateUnit( unit );
+    }
+    for( std::size_t cage = 0; result && cage < m_layout->cages().size(); ++cage )
     {
-        if( !validateQuadrant( i ) )
+        result = validateCage( cage );
+    }
+
+    // a value no cell of a unit can take
+    for( std::size_t unit = 0; result && !m_places.empty() && unit < units; ++unit )
+    {
+        for( Num value = 1; value <= m_dimension; ++value )
         {
-            result = false;
-            break;
+            if( m_places[unit * ( m_dimension + 1 ) + value] == 0 )
+            {
+                const auto first = m_layout->unit( unit )[0];
+                m_offendingVal = std::make_tuple( first / m_dimension, first % m_dimension, ( Num )0, ( Num )0, value );
+                result = false;
+                break;
+            }
         }
     }
 
@@ -180,54 +438,48 @@ bool Board::isSolved() const noexcept
 
 std::vector<Cell*> Board::getRowCells( Num row )
 {
-    std::vector<Cell*> result;
-
-    for( Num i = 0; i < m_dimension; ++i )
-    {
-        Cell* cellPtr = m_board[row].data() + i;
-        result.push_back( cellPtr );
-    }
-
-    return result;
+    checkCoords( m_dimension, row, 0 );
+    collectUnit( row );
+    return m_group;
 }
 
 
 std::vector<Cell*> Board::getColCells( Num col )
 {
-    std::vector<Cell*> result;
-
-    for( Num i = 0; i < m_dimension; ++i )
-    {
-        Cell* cellPtr = m_board[i].data() + col;
-        result.push_back( cellPtr );
-    }
-    return result;
+    checkCoords( m_dimension, 0, col );
+    collectUnit( m_dimension + col );
+    return m_group;
 }
 
 
 std::vector<Cell*> Board::getQuadrantCells( Num quadrant )
 {
-    std::vector<Cell*> result;
+    checkCoords( m_dimension, quadrant, 0 );
+    collectUnit( 2 * m_dimension + quadrant );
+    return m_group;
+}
 
-    performInQuadrant( quadrant, [&result, this]( auto i, auto j, Cell& )
-        {
-            Cell* cellPtr = m_board[i].data() + j;
-            result.push_back( cellPtr );
-            return true;
-        } );
-    return result;
+
+void Board::collectUnit( std::size_t unit )
+{
+    m_group.clear();
+    const auto* cells = m_layout->unit( unit );
+    for( Num i = 0; i < m_dimension; ++i )
+    {
+        m_group.push_back( &m_cells[cells[i]] );
+    }
 }
 
 
 bool Board::operator==( const Board& rhs ) const
 {
-    for( Num i = 0; i < m_dimension; ++i )
+    if( m_dimension != rhs.m_dimension )
+        return false;
+
+    for( std::size_t i = 0; i < m_cells.size(); ++i )
     {
-        for( Num j = 0; j < m_dimension; ++j )
-        {
-            if( at( i, j ) != rhs.at( i, j ) )
-                return false;
-        }
+        if( m_cells[i].getVal() != rhs.m_cells[i].getVal() )
+            return false;
     }
 
     return true;
@@ -240,213 +492,477 @@ bool Board::operator!=( const Board& rhs ) const
 }
 
 
-void Board::performInCells( std::function<bool( const Num, const Num, Cell& )> func )
+template<typename Func>
+void Board::performInCells( Func&& func )
 {
     for( Num i = 0; i < m_dimension; ++i )
     {
         for( Num j = 0; j < m_dimension; ++j )
         {
-            if( !func( i, j, m_board[i][j] ) )
+            if( !func( i, j, m_cells[i * m_dimension + j] ) )
                 return;
         }
     }
 }
 
-void Board::performInCells( std::function<bool( const Num, const Num, const Cell& )> func ) const
+template<typename Func>
+void Board::performInCells( Func&& func ) const
 {
     for( Num i = 0; i < m_dimension; ++i )
     {
         for( Num j = 0; j < m_dimension; ++j )
         {
-            if( !func( i, j, m_board[i][j] ) )
+            if( !func( i, j, m_cells[i * m_dimension + j] ) )
                 return;
         }
     }
 }
 
-void Board::performInQuadrant( Num quadrant, std::function<bool( const Num row, const Num col, Cell& )> func )
-{
-    const Num rowMult = quadrant / m_blockSide;
-    const Num colMult = quadrant % m_blockSide;
-
-    const Num startRow = rowMult * m_blockSide;
-    const Num startCol = colMult * m_blockSide;
-
-    for( Num i = startRow; i < startRow + m_blockSide; ++i )
-    {
-        for( Num j = startCol; j < startCol + m_blockSide; ++j )
-        {
-            if( !func( i, j, m_board[i][j] ) )
-                return;
-        }
-    }
-}
-
-bool Board::validateQuadrant( Num quadrant )
+bool Board::validateUnit( std::size_t unit )
 {
     bool found = false;
-    std::map<Num, std::pair<Num, Num>> values;
-    performInQuadrant( quadrant,
-        [this, &found, &values]( auto k, auto l, auto& cell )
+    // position where each value was first seen, m_dimension if not seen yet
+    m_seen.assign( m_dimension + 1, std::make_pair( m_dimension, m_dimension ) );
+    const auto* cells = m_layout->unit( unit );
+    for( Num i = 0; i < m_dimension && !found; ++i )
+    {
+        const auto& cell = m_cells[cells[i]];
+        if( cell.hasVal() )
         {
-            if( cell.hasVal() )
+            const auto k = cells[i] / m_dimension;
+            const auto l = cells[i] % m_dimension;
+            auto val = cell.getVal();
+            auto& seen = m_seen[val];
+            if( seen.first != m_dimension )
             {
-                auto val = cell.getVal();
-                if( values.find( val ) != values.end() )
-                {
-                    m_offendingVal = std::make_tuple( k, l, std::get<0>( values[val] ), std::get<1>( values[val] ), val );
-                    found = true;
-                }
-                else
-                {
-                    values[val] = std::make_pair( k, l );
-                }
+                m_offendingVal = std::make_tuple( k, l, seen.first, seen.second, val );
+                found = true;
             }
-            return !found;
-        } );
+            else
+            {
+                seen = std::make_pair( k, l );
+            }
+        }
+    }
 
     return !found;
 }
 
 void Board::updatePossibleValues() noexcept
 {
+    TraceScope trace( "propagate" );
+    PerfScope counters( PerfCounters::propagation() );
+    std::uint64_t passes = 0;
+    const auto units = m_layout->unitCount();
     bool gotUpdate = false;
     do
     {
+        ++passes;
         gotUpdate = false;
+        // the row, column and region of each index in turn, then the others
         for( Num i = 0; i < m_dimension; ++i )
         {
-            gotUpdate |= updateInRow( i );
-            gotUpdate |= updateInCol( i );
-            gotUpdate |= updateInQuadrant( i );
+            gotUpdate |= updateInUnit( i );
+            gotUpdate |= updateInUnit( m_dimension + i );
+            gotUpdate |= updateInUnit( 2 * m_dimension + i );
+        }
+        for( auto unit = 3 * m_dimension; unit < units; ++unit )
+        {
+            gotUpdate |= updateInUnit( unit );
+        }
 
-            for( Num j = 0; j < i; ++j )
+        // once a value has no place left in a unit the board is invalid, and
+        // what the masks would deduce from it is meaningless
+        if( !m_places.empty() && !hasEmptyPlaces() )
+        {
+            gotUpdate |= updateHiddenSingles();
+            gotUpdate |= updateBoxLines();
+            for( std::size_t cage = 0; cage < m_layout->cages().size(); ++cage )
             {
-                gotUpdate |= updateGroup( getRowCells( j ) );
-                gotUpdate |= updateGroup( getColCells( j ) );
-                gotUpdate |= updateGroup( getQuadrantCells( j ) );
+                gotUpdate |= updateCage( cage );
             }
         }
+
+        // each unit once per pass: the loop runs again while anything changes
+        for( Num i = 0; i < m_dimension; ++i )
+        {
+            collectUnit( i );
+            gotUpdate |= updateGroup( m_group );
+            collectUnit( m_dimension + i );
+            gotUpdate |= updateGroup( m_group );
+            collectUnit( 2 * m_dimension + i );
+            gotUpdate |= updateGroup( m_group );
+        }
+        for( auto unit = 3 * m_dimension; unit < units; ++unit )
+        {
+            collectUnit( unit );
+            gotUpdate |= updateGroup( m_group );
+        }
     }
     while( gotUpdate );
+    trace.setArg( "passes", passes );
 }
 
-bool Board::updateInRow( Num row ) noexcept
+bool Board::updateInUnit( std::size_t unit ) noexcept
 {
     bool updatedOne = false;
 
-    Nums existingNumbers;
+    auto& existingNumbers = m_values;
+    existingNumbers.clear();
+    const auto* cells = m_layout->unit( unit );
     for( Num i = 0; i < m_dimension; ++i )
     {
-        if( m_board[row][i].hasVal() )
+        const auto& cell = m_cells[cells[i]];
+        if( cell.hasVal() )
         {
-            existingNumbers.push_back( m_board[row][i].getVal() );
+            existingNumbers.push_back( cell.getVal() );
         }
     }
 
     for( Num i = 0; i < m_dimension; ++i )
     {
-        auto& cell = m_board[row][i];
+        auto& cell = m_cells[cells[i]];
         if( !cell.hasVal() )
         {
-            updatedOne |= cell.remove( existingNumbers );
+            updatedOne |= eliminate( cell, existingNumbers );
         }
     }
 
     return updatedOne;
 }
 
-bool Board::updateInCol( Num col ) noexcept
+bool Board::updateGroup( const std::vector<Cell*>& group ) noexcept
 {
-    Nums existingNumbers;
     bool updatedOne = false;
 
-    for( Num i = 0; i < m_dimension; ++i )
+    // find 2, 3, and 4 subgroups of cells in the provided group
+    // with the same possibilities. E.g. two cells with possibilities = { 1, 2},
+    // three cells with possibilities = {1, 2, 4}.
+    for( Num i = 2; i < m_dimension / 2; ++i )
     {
-        if( m_board[i][col].hasVal() )
+        auto& cellsWithSamePossibilities = m_subgroup;
+        cellsWithSamePossibilities.clear();
+        for( auto cell : group )
         {
-            existingNumbers.push_back( m_board[i][col].getVal() );
+            if( cell->count() == i )
+            {
+                cellsWithSamePossibilities.push_back( cell );
+            }
+        }
+        if( cellsWithSamePossibilities.size() == i )
+        {
+            bool allEqual = std::all_of( ++( cellsWithSamePossibilities.begin() ), cellsWithSamePossibilities.end(),
+                [&cellsWithSamePossibilities]( auto cell )
+                {
+                    return *cell == *cellsWithSamePossibilities.front();
+                }
+            );
+
+            if( allEqual )
+            {
+                auto& possibilitiesToRemove = m_values;
+                possibilitiesToRemove.clear();
+                const auto front = cellsWithSamePossibilities.front();
+                for( std::size_t k = 0; k < front->count(); ++k )
+                {
+                    possibilitiesToRemove.push_back( front->possibility( k ) );
+                }
+
+                for( auto cell : group )
+                {
+                    // if the cellsWithSamePossibilities vector does not contain 'cell'
+                    if( std::find( cellsWithSamePossibilities.begin(), cellsWithSamePossibilities.end(), cell ) == cellsWithSamePossibilities.end() )
+                    {
+                        updatedOne |= eliminate( *cell, possibilitiesToRemove );
+                    }
+                }
+            }
         }
     }
-    for( Num i = 0; i < m_dimension; ++i )
+    return updatedOne;
+}
+
+bool Board::eliminate( Cell& cell, const Nums& values ) noexcept
+{
+    bool removed = false;
+    for( auto n : values )
     {
-        if( !m_board[i][col].hasVal() )
+        removed |= eliminate( cell, n );
+    }
+    return removed;
+}
+
+
+bool Board::eliminate( Cell& cell, Num value ) noexcept
+{
+    if( !cell.remove( value ) )
+        return false;
+
+    updatePlaces( cell, value, false );
+    if( m_recording )
+        m_trail.push_back( { &cell, value, false } );
+    return true;
+}
+
+
+void Board::updatePlaces( const Cell& cell, Num value, bool possible ) noexcept
+{
+    if( m_places.empty() )
+        return;
+
+    const auto index = static_cast< Num >( &cell - m_cells.data() );
+    const auto units = m_layout->memberships( index );
+    auto* places = m_places.data() + value;
+    const auto stride = m_dimension + 1;
+    for( auto unit = units.first; unit != units.second; ++unit )
+    {
+        auto& mask = places[unit->unit * stride];
+        if( possible )
+            mask |= Mask( 1 ) << unit->position;
+        else
+            mask &= ~( Mask( 1 ) << unit->position );
+    }
+
+    const auto cages = m_layout->cageMemberships( index );
+    places += m_layout->unitCount() * stride;
+    for( auto cage = cages.first; cage != cages.second; ++cage )
+    {
+        auto& mask = places[cage->unit * stride];
+        if( possible )
+            mask |= Mask( 1 ) << cage->position;
+        else
+            mask &= ~( Mask( 1 ) << cage->position );
+    }
+}
+
+
+void Board::rebuildPlaces()
+{
+    m_places.clear();
+    if( m_dimension > Layout::MaxMaskDimension )
+        return;
+
+    m_places.assign( ( m_layout->unitCount() + m_layout->cages().size() ) * ( m_dimension + 1 ), 0 );
+    for( const auto& cell : m_cells )
+    {
+        for( std::size_t i = 0; auto n = cell.possibility( i ); ++i )
         {
-            updatedOne |= m_board[i][col].remove( existingNumbers );
+            updatePlaces( cell, n, true );
         }
     }
+}
 
-    return updatedOne;
+
+bool Board::hasEmptyPlaces() const noexcept
+{
+    // the slot of value 0 starts each unit, and is never set; cages don't
+    // hold every value, so their masks are left out
+    const auto stride = m_dimension + 1;
+    const auto end = m_layout->unitCount() * stride;
+    for( std::size_t unit = 0; unit < end; unit += stride )
+    {
+        if( std::find( m_places.begin() + unit + 1, m_places.begin() + unit + stride, Mask( 0 ) ) != m_places.begin() + unit + stride )
+            return true;
+    }
+    return false;
 }
 
 
-bool Board::updateInQuadrant( Num quadrant ) noexcept
+bool Board::updateHiddenSingles() noexcept
 {
-    Nums existingNumbers;
     bool updatedOne = false;
+    const auto stride = m_dimension + 1;
+    const auto units = m_layout->unitCount();
 
-    performInQuadrant( quadrant,
-        [this, &existingNumbers]( auto, auto, auto& cell )
+    for( std::size_t unit = 0; unit < units; ++unit )
+    {
+        const auto* cells = m_layout->unit( unit );
+        for( Num value = 1; value <= m_dimension; ++value )
         {
-            if( cell.hasVal() )
+            const auto places = m_places[unit * stride + value];
+            if( places == 0 || ( places & ( places - 1 ) ) != 0 )
+                continue;
+
+            Num position = 0;
+            while( !( places & ( Mask( 1 ) << position ) ) )
             {
-                existingNumbers.push_back( cell.getVal() );
+                ++position;
             }
-            return true;
-        } );
 
-    performInQuadrant( quadrant,
-        [this, &existingNumbers, &updatedOne]( auto, auto, auto& cell )
-        {
-            if( !cell.hasVal() )
+            auto& cell = m_cells[cells[position]];
+            if( cell.count() < 2 )
+                continue;
+
+            auto& others = m_values;
+            others.clear();
+            for( std::size_t i = 0; auto n = cell.possibility( i ); ++i )
             {
-                updatedOne |= cell.remove( existingNumbers );
+                if( n != value )
+                    others.push_back( n );
             }
-            return true;
-        } );
-
+            updatedOne |= eliminate( cell, others );
+        }
+    }
     return updatedOne;
 }
 
-bool Board::updateGroup( const std::vector<Cell*>& group ) noexcept
+
+bool Board::updateBoxLines() noexcept
 {
     bool updatedOne = false;
+    const auto stride = m_dimension + 1;
 
-    // find 2, 3, and 4 subgroups of cells in the provided group
-    // with the same possibilities. E.g. two cells with possibilities = { 1, 2},
-    // three cells with possibilities = {1, 2, 4}.
-    for( Num i = 2; i < m_dimension / 2; ++i )
+    for( const auto& intersection : m_layout->intersections() )
     {
-        std::vector<Cell*> cellsWithSamePossibilities;
-        for( auto cell : group )
+        const auto* cells = m_layout->unit( intersection.other );
+        for( Num value = 1; value <= m_dimension; ++value )
         {
-            if( cell->possibilities().size() == i )
+            const auto places = m_places[intersection.unit * stride + value];
+            if( places == 0 || ( places & ~intersection.inUnit ) != 0 )
+                continue;
+
+            // the value goes where the units cross, so not in the rest of the other
+            const auto outside = m_places[intersection.other * stride + value] & ~intersection.inOther;
+            for( Num position = 0; position < m_dimension; ++position )
             {
-                cellsWithSamePossibilities.push_back( cell );
+                // assigned cells are left to the validation to report
+                auto& cell = m_cells[cells[position]];
+                if( ( outside & ( Mask( 1 ) << position ) ) && cell.count() > 1 )
+                    updatedOne |= eliminate( cell, value );
             }
         }
-        if( cellsWithSamePossibilities.size() == i )
+    }
+    return updatedOne;
+}
+
+
+bool Board::updateCage( std::size_t index ) noexcept
+{
+    bool updatedOne = false;
+    const auto stride = m_dimension + 1;
+    const auto& cage = m_layout->cages()[index];
+    const auto* cells = m_layout->cageCells( cage );
+    const auto* places = m_places.data() + ( m_layout->unitCount() + index ) * stride;
+
+    // the values still possible somewhere in the cage, and in each cell
+    Mask open = 0;
+    Mask cellValues[Layout::MaxMaskDimension] = {};
+    for( Num value = 1; value <= m_dimension; ++value )
+    {
+        auto positions = places[value];
+        if( positions == 0 )
+            continue;
+        open |= Mask( 1 ) << ( value - 1 );
+        for( Num position = 0; position < cage.size; ++position )
         {
-            bool allEqual = std::all_of( ++( cellsWithSamePossibilities.begin() ), cellsWithSamePossibilities.end(),
-                [&cellsWithSamePossibilities]( auto cell )
-                {
-                    return cell->possibilities() == cellsWithSamePossibilities.front()->possibilities();
-                }
-            );
+            if( positions & ( Mask( 1 ) << position ) )
+                cellValues[position] |= Mask( 1 ) << ( value - 1 );
+        }
+    }
+    Mask assigned = 0;
+    for( Num position = 0; position < cage.size; ++position )
+    {
+        const auto& cell = m_cells[cells[position]];
+        if( cell.count() == 1 )
+            assigned |= Mask( 1 ) << ( cell.possibility( 0 ) - 1 );
+    }
 
-            if( allEqual )
+    // the values of the sets that still fit, and the values all of them have
+    Mask allowed = 0;
+    Mask required = ~Mask( 0 );
+    const auto* combinations = m_layout->combinations( cage );
+    for( std::size_t i = 0; i < cage.combinationCount; ++i )
+    {
+        const auto combination = combinations[i];
+        if( ( combination & ~open ) != 0 || ( assigned & ~combination ) != 0 )
+            continue;
+        bool fits = true;
+        for( Num position = 0; fits && position < cage.size; ++position )
+        {
+            fits = ( cellValues[position] & combination ) != 0;
+        }
+        if( fits )
+        {
+            allowed |= combination;
+            required &= combination;
+        }
+    }
+    required &= allowed & ~assigned;
+
+    for( Num position = 0; position < cage.size; ++position )
+    {
+        // assigned cells are left to the validation to report
+        auto& cell = m_cells[cells[position]];
+        if( cell.count() < 2 )
+            continue;
+
+        const auto removed = cellValues[position] & ( ~allowed | assigned );
+        for( Num value = 1; value <= m_dimension; ++value )
+        {
+            if( removed & ( Mask( 1 ) << ( value - 1 ) ) )
+                updatedOne |= eliminate( cell, value );
+        }
+    }
+
+    // a value every set has, that only one cell can take
+    for( Num value = 1; required != 0 && value <= m_dimension; ++value )
+    {
+        const auto positions = places[value];
+        if( !( required & ( Mask( 1 ) << ( value - 1 ) ) ) || positions == 0 || ( positions & ( positions - 1 ) ) != 0 )
+            continue;
+
+        Num position = 0;
+        while( !( positions & ( Mask( 1 ) << position ) ) )
+        {
+            ++position;
+        }
+        auto& cell = m_cells[cells[position]];
+        for( Num other = 1; cell.count() > 1 && other <= m_dimension; ++other )
+        {
+            if( other != value )
+                updatedOne |= eliminate( cell, other );
+        }
+    }
+    return updatedOne;
+}
+
+
+bool Board::validateCage( std::size_t index )
+{
+    const auto& cage = m_layout->cages()[index];
+    const auto* cells = m_layout->cageCells( cage );
+
+    Mask seen = 0;
+    Num sum = 0;
+    Num assigned = 0;
+    for( Num position = 0; position < cage.size; ++position )
+    {
+        const auto cell = cells[position];
+        if( !m_cells[cell].hasVal() )
+            continue;
+
+        const auto value = m_cells[cell].getVal();
+        const auto bit = Mask( 1 ) << ( value - 1 );
+        if( seen & bit )
+        {
+            Num earlier = 0;
+            while( m_cells[cells[earlier]].getVal() != value )
             {
-                auto possibilitiesToRemove = cellsWithSamePossibilities.front()->possibilities();
-                for( auto cell : group )
-                {
-                    // if the cellsWithSamePossibilities vector does not contain 'cell'
-                    if( std::find( cellsWithSamePossibilities.begin(), cellsWithSamePossibilities.end(), cell ) == cellsWithSamePossibilities.end() )
-                    {
-                        updatedOne |= cell->remove( possibilitiesToRemove );
-                    }
-                }
+                ++earlier;
             }
+            const auto first = cells[earlier];
+            m_offendingVal = std::make_tuple( cell / m_dimension, cell % m_dimension, first / m_dimension, first % m_dimension, value );
+            return false;
         }
+        seen |= bit;
+        sum += value;
+        ++assigned;
     }
-    return updatedOne;
+
+    if( assigned == cage.size && sum != cage.sum )
+    {
+        m_offendingVal = std::make_tuple( cells[0] / m_dimension, cells[0] % m_dimension, ( Num )0, ( Num )0, ( Num )0 );
+        return false;
+    }
+    return true;
 }
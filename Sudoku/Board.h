@@ -1,10 +1,17 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
 #include <utility>
-#include <map>
-#include <functional>
+#include <vector>
 
 #include "Common.h"
 #include "Cell.h"
+#include "Layout.h"
 
 namespace Sudoku
 {
@@ -22,6 +29,102 @@ struct CoordPossibilities
 
 using CoordPossibilitiesList = std::vector<CoordPossibilities>;
 
+/**
+* @brief A read-only view of the cells of a unit, in the order of the layout.
+* It points into the board, so it is only valid while the board lives and
+* isn't assigned to.
+*/
+class UnitCells
+{
+public:
+    /**
+    * @brief Iterates over the cells of a unit.
+    */
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Cell;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Cell*;
+        using reference = const Cell&;
+
+        Iterator( const Cell* cells, const Num* position ) noexcept :
+            m_cells( cells ),
+            m_position( position )
+        {
+        }
+
+        const Cell& operator*() const noexcept
+        {
+            return m_cells[*m_position];
+        }
+        const Cell* operator->() const noexcept
+        {
+            return m_cells + *m_position;
+        }
+        Iterator& operator++() noexcept
+        {
+            ++m_position;
+            return *this;
+        }
+        Iterator operator++( int ) noexcept
+        {
+            auto previous = *this;
+            ++m_position;
+            return previous;
+        }
+        bool operator==( const Iterator& rhs ) const noexcept
+        {
+            return m_position == rhs.m_position;
+        }
+        bool operator!=( const Iterator& rhs ) const noexcept
+        {
+            return m_position != rhs.m_position;
+        }
+
+    private:
+        const Cell* m_cells;
+        const Num* m_position;
+    };
+
+    UnitCells( const Cell* cells, const Num* positions, Num size ) noexcept :
+        m_cells( cells ),
+        m_positions( positions ),
+        m_size( size )
+    {
+    }
+
+    Iterator begin() const noexcept
+    {
+        return Iterator( m_cells, m_positions );
+    }
+    Iterator end() const noexcept
+    {
+        return Iterator( m_cells, m_positions + m_size );
+    }
+    std::size_t size() const noexcept
+    {
+        return m_size;
+    }
+    const Cell& operator[]( std::size_t index ) const noexcept
+    {
+        return m_cells[m_positions[index]];
+    }
+    /**
+    * @brief Gets the index of a cell of the unit on the board, in row order.
+    */
+    Num position( std::size_t index ) const noexcept
+    {
+        return m_positions[index];
+    }
+
+private:
+    const Cell* m_cells;
+    const Num* m_positions;
+    Num m_size;
+};
+
 /**
 * @brief Represents the Sudoku board and provides operations to manipulate its values.
 */
@@ -38,6 +141,61 @@ public:
     */
     Board( Num dims, const InputArray& values );
     /**
+    * @brief Contructs an empty board of a variant, whose units are those of
+    * the layout, with the possibilities its cages leave.
+    */
+    explicit Board( const Layout& layout );
+    /**
+    * @brief Contructs a board of a variant with the values provided.
+    */
+    Board( const Layout& layout, const InputArray& values );
+    /**
+    * @brief Contructs a board with the values provided in row order, without
+    * the nested vectors of an InputArray.
+    * @throw std::invalid_argument if there isn't a value per cell, or the
+    * values are invalid
+    */
+    Board( Num dims, const Nums& values );
+    /**
+    * @brief Contructs a board of a variant with the values provided in row
+    * order, like Board( dims, values ).
+    */
+    Board( const Layout& layout, const Nums& values );
+    /**
+    * @brief Contructs a board with the values of a flat buffer in row order,
+    * e.g. a slice of a buffer holding many boards.
+    * @param values the dimension * dimension values, 0 for empty cells
+    * @throw std::invalid_argument if the values are invalid
+    */
+    Board( Num dims, const Num* values );
+    /**
+    * @brief Contructs a board of a variant with the values of a flat buffer,
+    * like Board( dims, values ).
+    */
+    Board( const Layout& layout, const Num* values );
+    /**
+    * @brief Contructs a board with the values of a range in row order, of any
+    * integer type, e.g. a buffer of narrower values. They are placed and then
+    * propagated once.
+    * @throw std::invalid_argument if there isn't a value per cell, or the
+    * values are invalid
+    */
+    template<typename Iterator>
+    Board( Num dims, Iterator first, Iterator last ) :
+        Board( dims )
+    {
+        if( static_cast< std::size_t >( std::distance( first, last ) ) != m_cells.size() )
+            throw std::invalid_argument( "expected " + std::to_string( m_cells.size() ) + " values" );
+        for( Num cell = 0; first != last; ++first, ++cell )
+        {
+            if( *first != 0 )
+                place( cell / m_dimension, cell % m_dimension, static_cast< Num >( *first ) );
+        }
+        if( !isValid() )
+            throw std::invalid_argument( "board has invalid values" );
+        propagate();
+    }
+    /**
     * @brief Copy constructor
     */
     Board( const Board& other );
@@ -46,6 +204,14 @@ public:
     */
     Board& operator=( const Board& other );
     /**
+    * @brief Move constructor. The change record moves along with the cells.
+    */
+    Board( Board&& other ) noexcept;
+    /**
+    * @brief Move assignment, like the move constructor.
+    */
+    Board& operator=( Board&& other ) noexcept;
+    /**
     * @brief Returns the assigned value for the specified cell. 0 is returned
     * for cells with no assigned value.
     *
@@ -65,6 +231,34 @@ public:
     */
     Cell cell( Num row, Num col ) const;
     /**
+    * @brief Returns the cell at the specified location without copying it.
+    *
+    * @param row the cell row
+    * @param col the cell column
+    * @return The cell, valid until the board is assigned to or destroyed
+    * @throw std::out_of_range if either coordinates are out of bounds
+    */
+    const Cell& cellRef( Num row, Num col ) const;
+    /**
+    * @brief Returns the possible values of the specified cell without
+    * copying them.
+    *
+    * @param row the cell row
+    * @param col the cell column
+    * @return A view of the values, valid until the cell changes
+    * @throw std::out_of_range if either coordinates are out of bounds
+    */
+    Candidates candidates( Num row, Num col ) const;
+    /**
+    * @brief Returns the cells of a unit of the layout without copying them:
+    * rows, then columns, then quadrants or regions, then any extra units.
+    *
+    * @param unit the unit, below layout().unitCount()
+    * @return A view of the unit's cells
+    * @throw std::out_of_range if the unit is out of bounds
+    */
+    UnitCells unitCells( std::size_t unit ) const;
+    /**
     * @brief Assigns a value to the cell at the specified location.
     *
     * @param row the cell row
@@ -75,6 +269,37 @@ public:
     */
     void set( Num row, Num col, Num number );
     /**
+    * @brief Assigns a value to a cell like set(), without propagating it:
+    * the other cells keep their possibilities until propagate() is called.
+    * Lets many values be placed, e.g. when loading or replaying a game, for
+    * a single propagation.
+    *
+    * @param row the cell row
+    * @param col the cell column
+    * @param number the value to assign
+    * @throw std::out_of_range if either coordinates are out of bounds
+    * @throw std::invalid_argument if value is invalid
+    */
+    void place( Num row, Num col, Num number );
+    /**
+    * @brief Removes a possible value from a cell, without propagating it,
+    * see place().
+    *
+    * @param row the cell row
+    * @param col the cell column
+    * @param number the value to remove
+    * @return True if the value was possible, false otherwise.
+    * @throw std::out_of_range if either coordinates are out of bounds
+    * @throw std::invalid_argument if value is invalid
+    */
+    bool exclude( Num row, Num col, Num number );
+    /**
+    * @brief Propagates the values placed and excluded since the last
+    * propagation. Check isValid() afterwards: placed values aren't checked
+    * against each other.
+    */
+    void propagate() noexcept;
+    /**
     * @brief Returns a list of coordinates to possible numbers sorted by
     * possibility list size in ascending order
     * @return a list of coordinates to possible numbers sorted by
@@ -82,14 +307,64 @@ public:
     */
     CoordPossibilitiesList sortedPossibilities();
     /**
+    * @brief Finds the unassigned cell with the fewest possible values.
+    * @param row receives the cell row
+    * @param col receives the cell column
+    * @return True if an unassigned cell was found, false otherwise.
+    */
+    bool mostConstrainedCell( Num& row, Num& col ) const noexcept;
+    /**
+    * @brief Returns a possible value of the specified cell without copying
+    * its possibility list.
+    *
+    * @param row the cell row
+    * @param col the cell column
+    * @param index the position of the value, in ascending order
+    * @return The possible value, or 0 if index is out of range
+    * @throw std::out_of_range if either coordinates are out of bounds
+    */
+    Num possibility( Num row, Num col, std::size_t index ) const;
+    /**
+    * @brief Counts, for each value, the unassigned peers of a cell (the other
+    * cells of its units) that can still take it, i.e. how
+    * many possibilities assigning the value to the cell would remove.
+    *
+    * @param row the cell row
+    * @param col the cell column
+    * @param counts receives the count of each value at its index, resized
+    * to dimension() + 1
+    * @throw std::out_of_range if either coordinates are out of bounds
+    */
+    void countPeerPossibilities( Num row, Num col, std::vector<std::size_t>& counts ) const;
+    /**
+    * @brief Starts or stops recording changes to cell possibilities, so they
+    * can later be undone with rollback(). Stopping discards the record.
+    * @param enable true to start recording, false to stop
+    */
+    void recordChanges( bool enable );
+    /**
+    * @brief Returns a marker for the current position in the change record.
+    * @return a marker to pass to rollback()
+    */
+    std::size_t checkpoint() const noexcept
+    {
+        return m_trail.size();
+    }
+    /**
+    * @brief Undoes every recorded change made after the checkpoint was taken.
+    * @param checkpoint a marker returned by checkpoint()
+    */
+    void rollback( std::size_t checkpoint );
+    /**
     * @brief Checks if the board's values are valid, i.e. there are no duplicate
-    * values in rows/columns/quadrants or no possible values for some cell.
+    * values in units or no possible values for some cell.
     * @return true if the board's configuration is valid, false otherwise.
     */
     bool isValid();
     /**
-    * @brief Checks if the board is solved, that is, all cells are assigned a value
-    * and there are no repeated values in rows/columns/quadrants.
+    * @brief Checks if the board is solved, that is, all cells are assigned a value.
+    * The values aren't checked against the units: propagation only assigns
+    * consistent values, and isValid() or a Verifier check the others.
     * @return True if the board is solved, false otherwise.
     */
     bool isSolved() const noexcept;
@@ -114,7 +389,8 @@ public:
     */
     std::vector<Cell*> getColCells( Num col );
     /**
-    * @brief Gets pointers to cells of the specified quadrant
+    * @brief Gets pointers to cells of the specified quadrant, or region of
+    * a jigsaw layout
     * @param quadrant the quadrant
     * @return pointers to cells of the specified quadrant
     */
@@ -138,12 +414,81 @@ public:
     {
         return m_blockSide;
     }
+    const Layout& layout() const noexcept
+    {
+        return *m_layout;
+    }
 
 private:
+    /**
+    * @brief A single recorded change to a cell's possibilities.
+    */
+    struct Change
+    {
+        Cell* cell;
+        Num value;
+        bool added;
+    };
+
+    using Mask = Layout::Mask;
+
+    // shared by the copies of a board
+    std::shared_ptr<const Layout> m_layout;
     Num m_blockSide;
     Num m_dimension;
-    std::vector<Cells> m_board;
+    // the cells in row order
+    Cells m_cells;
+    // The transposed view of the cells' possibilities: for each unit of the
+    // layout and value, the positions in the unit where the value is still
+    // possible, at m_places[unit * ( m_dimension + 1 ) + value], followed by
+    // the same for each cage, numbered after the units. Kept in sync with
+    // every change to the cells, and empty for boards over
+    // Layout::MaxMaskDimension.
+    std::vector<Mask> m_places;
     std::tuple<Num, Num, Num, Num, Num> m_offendingVal;
+    bool m_recording = false;
+    std::vector<Change> m_trail;
+
+    // Scratch buffers reused by propagation and validation so they don't
+    // allocate once warmed up. They are never copied between boards.
+    Nums m_values;
+    std::vector<Cell*> m_group;
+    std::vector<Cell*> m_subgroup;
+    std::vector<std::pair<Num, Num>> m_seen;
+
+    /**
+    * @brief Removes possible values from a cell, recording the removal
+    * if changes are being recorded.
+    * @param cell the cell to update
+    * @param values the possibilities to remove
+    * @return True if there were possibilities removed, false otherwise.
+    */
+    bool eliminate( Cell& cell, const Nums& values ) noexcept;
+    /**
+    * @brief Removes a possible value from a cell, like eliminate( cell, values ).
+    */
+    bool eliminate( Cell& cell, Num value ) noexcept;
+    /**
+    * @brief Records in the unit and cage masks that a value became possible, or
+    * impossible, for a cell.
+    * @param cell the cell, one of m_cells
+    * @param value the value
+    * @param possible true if the value was added, false if it was removed
+    */
+    void updatePlaces( const Cell& cell, Num value, bool possible ) noexcept;
+    /**
+    * @brief Computes the unit masks from the cells, if the board is small
+    * enough to keep them.
+    */
+    void rebuildPlaces();
+    /**
+    * @brief Fills the cells with the values provided, then checks and
+    * propagates them.
+    * @param value the function giving the value of a row and column
+    * @throw std::invalid_argument if the values are invalid
+    */
+    template<typename Value>
+    void assign( Value&& value );
 
     /**
     * @brief Performs an actions for each cell of the board.
@@ -151,65 +496,86 @@ private:
     * row, column and Cell reference. The function must return true if it should keep
     * being called for the remaining cells.
     */
-    void performInCells( std::function<bool( const Num, const Num, Cell& )> func );
+    template<typename Func>
+    void performInCells( Func&& func );
     /**
     * @brief Performs an actions for each cell of the board.
     * @param func the function to call for each cell. It will be called with the
     * row, column and Cell reference. The function must return true if it should keep
     * being called for the remaining cells.
     */
-    void performInCells( std::function<bool( const Num, const Num, const Cell& )> func ) const;
+    template<typename Func>
+    void performInCells( Func&& func ) const;
     /**
-    * @brief Performs an actions for each cell of a quadrant.
-    * @param quadrant The quadrant to perform the function in each cell
-    * @param func the function to call for each cell. It will be called with the
-    * row, column and Cell reference. The function must return true if it should keep
-    * being called for the remaining cells.
+    * @brief Fills the group scratch buffer with pointers to the cells of a unit.
+    * @param unit the unit
     */
-    void performInQuadrant( Num quadrant, std::function<bool( const Num row, const Num col, Cell& )> func );
+    void collectUnit( std::size_t unit );
     /**
-    * @brief Checks if the specified cell does not have repeated values.
-    * @param quadrant the quadrant to check
-    * @return True if there are no repeated values in the quadrant.
+    * @brief Checks that a unit doesn't have repeated values.
+    * @param unit the unit to check
+    * @return True if there are no repeated values in the unit.
     */
-    bool validateQuadrant( Num quadrant );
+    bool validateUnit( std::size_t unit );
     /**
     * @brief Causes the board to update possible cell values for
     * the current configuration.
     */
     void updatePossibleValues() noexcept;
     /**
-    * @brief Causes the board to update possible cell values for
-    * the specified row.
+    * @brief Removes the values assigned in a unit from the possibilities of
+    * its other cells.
     *
-    * @param row the row to be updated
+    * @param unit the unit to be updated
+    * @return True if updates occurred, false otherwise
     */
-    bool updateInRow( Num row ) noexcept;
+    bool updateInUnit( std::size_t unit ) noexcept;
     /**
     * @brief Causes the board to update possible cell values for
-    * the specified column.
+    * the specified group, taking into account cells with
+    * 2, 3 and 4 possible values with equal number of cells.
     *
-    * @param col the column to be updated
+    * @param cells the cells to be updated
     * @return True if updates occurred, false otherwise
     */
-    bool updateInCol( Num col ) noexcept;
+    bool updateGroup( const std::vector<Cell*>& group ) noexcept;
     /**
-    * @brief Causes the board to update possible cell values for
-    * the specified quadrant.
-    *
-    * @param quadrant the quadrant to be updated
+    * @brief Tells if a value can't go anywhere in a unit.
+    */
+    bool hasEmptyPlaces() const noexcept;
+    /**
+    * @brief Assigns the values that only one cell of a unit can still take,
+    * found as the unit masks with a single bit.
     * @return True if updates occurred, false otherwise
     */
-    bool updateInQuadrant( Num quadrant ) noexcept;
+    bool updateHiddenSingles() noexcept;
     /**
-    * @brief Causes the board to update possible cell values for
-    * the specified group, taking into account cells with
-    * 2, 3 and 4 possible values with equal number of cells.
-    *
-    * @param cells the cells to be updated
+    * @brief Removes a value from the rest of a unit when, in another unit
+    * crossing it, the value is only possible where they cross: pointing and
+    * claiming between lines and quadrants, and the same between any units
+    * of the layout. Each check is a mask operation on a Layout::Intersection.
     * @return True if updates occurred, false otherwise
     */
-    bool updateGroup( const std::vector<Cell*>& group ) noexcept;
+    bool updateBoxLines() noexcept;
+    /**
+    * @brief Restricts the cells of a cage to the values of the sets in its
+    * combination table that fit what the cage can still hold: every value
+    * of the set possible somewhere in the cage, every assigned value in the
+    * set, and some value of the set possible in every cell. Also removes the
+    * assigned values from the other cells, and assigns a value every such
+    * set has when a single cell can take it. Works on the cage masks only,
+    * without allocating.
+    * @param cage the index of the cage in the layout
+    * @return True if updates occurred, false otherwise
+    */
+    bool updateCage( std::size_t cage ) noexcept;
+    /**
+    * @brief Checks that a cage doesn't have repeated values, and that its
+    * values add up to its sum once they are all assigned.
+    * @param cage the index of the cage in the layout
+    * @return True if the cage is valid.
+    */
+    bool validateCage( std::size_t cage );
 
 };
 
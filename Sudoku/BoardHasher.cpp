@@ -7,11 +7,12 @@ std::size_t BoardHasher::operator()( Board const& b ) const noexcept
 {
     size_t seed = 0;
 
+    // the rows are the first units of every layout, in row order
     for( Num i = 0; i < b.dimension(); ++i )
     {
-        for( Num j = 0; j < b.dimension(); ++j )
+        for( const auto& cell : b.unitCells( i ) )
         {
-            const auto u64hash = u64Hasher( b.at( i, j ) );
+            const auto u64hash = u64Hasher( cell.getVal() );
             combineHash( seed, u64hash );
         }
     }
@@ -0,0 +1,362 @@
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+#include "Canonicalizer.h"
+#include "Utils.h"
+
+using Sudoku::Canonicalizer;
+using Sudoku::Board;
+using Sudoku::Num;
+using Sudoku::Nums;
+
+namespace
+{
+/**
+* @brief Larger than any value, so the first row compared to it always wins.
+*/
+constexpr std::uint8_t Unset = 0xFF;
+constexpr Num MaxDimension = 225;
+/**
+* @brief Bounds of the search for very symmetric boards: the number of
+* transformations kept tied and the number of rows tried overall.
+*/
+constexpr std::size_t MaxCandidates = 1 << 16;
+constexpr std::size_t MaxWork = 1 << 16;
+
+/**
+* @brief Layout of a candidate transformation: whether it transposes, the last
+* label given, the column order, the rows chosen so far and the labels given
+* to the values so far.
+*/
+struct CandidateLayout
+{
+    static constexpr std::size_t Transposed = 0;
+    static constexpr std::size_t Labels = 1;
+    static constexpr std::size_t Columns = 2;
+
+    static std::size_t rows( std::size_t dimension ) noexcept
+    {
+        return Columns + dimension;
+    }
+    static std::size_t values( std::size_t dimension ) noexcept
+    {
+        return Columns + 2 * dimension;
+    }
+};
+}
+
+void Canonicalizer::canonicalize( const Board::InputArray& values )
+{
+    const auto dim = static_cast< Num >( values.size() );
+    Num blockSide = 1;
+    while( blockSide * blockSide < dim )
+    {
+        ++blockSide;
+    }
+    if( dim == 0 || blockSide * blockSide != dim || dim > MaxDimension )
+        throw std::invalid_argument( "unsupported board dimension: " + std::to_string( dim ) );
+
+    if( blockSide != m_blockSide )
+        prepare( blockSide );
+
+    for( Num i = 0; i < dim; ++i )
+    {
+        if( values[i].size() != dim )
+            throw std::invalid_argument( "values are not a square board" );
+
+        for( Num j = 0; j < dim; ++j )
+        {
+            checkValue( dim, values[i][j] );
+            const auto value = static_cast< Byte >( values[i][j] );
+            m_cells[i * dim + j] = value;
+            m_cells[( dim + j ) * dim + i] = value;
+        }
+    }
+
+    m_exact = true;
+    m_budget = MaxWork;
+    m_candidates.clear();
+    std::fill( m_best.begin(), m_best.end(), Unset );
+    std::fill( m_usedColumns.begin(), m_usedColumns.end(), 0 );
+
+    // Any row of either orientation may come first. With its columns in the
+    // best order, a row starts with the empty cells of its emptiest stack, then
+    // those of the next emptiest one, and so on: only the rows whose stacks are
+    // the emptiest can come first.
+    std::fill( m_bestProfile.begin(), m_bestProfile.end(), 0 );
+    for( std::size_t transposed = 0; transposed < 2; ++transposed )
+    {
+        for( std::size_t row = 0; row < dim; ++row )
+        {
+            profile( transposed, row );
+            m_bestProfile = std::max( m_bestProfile, m_profile );
+        }
+    }
+    for( std::size_t transposed = 0; transposed < 2; ++transposed )
+    {
+        for( std::size_t row = 0; row < dim; ++row )
+        {
+            profile( transposed, row );
+            if( m_profile == m_bestProfile )
+                firstRow( transposed, row, 0, 0 );
+        }
+    }
+    for( std::size_t depth = 1; depth < dim; ++depth )
+    {
+        nextRow( depth );
+    }
+
+    // every candidate left gives the same form, keep the first one
+    const auto* candidate = m_candidates.data();
+    const auto* labels = candidate + CandidateLayout::values( dim );
+    m_symmetry.transposed = candidate[CandidateLayout::Transposed] != 0;
+    auto label = static_cast< Num >( candidate[CandidateLayout::Labels] );
+    for( Num value = 0; value <= dim; ++value )
+    {
+        // values missing from the board take the labels left, in order
+        m_symmetry.values[value] = value == 0 || labels[value] ? labels[value] : ++label;
+    }
+    for( Num i = 0; i < dim; ++i )
+    {
+        m_symmetry.rows[i] = candidate[CandidateLayout::rows( dim ) + i];
+        m_symmetry.columns[i] = candidate[CandidateLayout::Columns + i];
+    }
+
+    for( Num i = 0; i < dim; ++i )
+    {
+        for( Num j = 0; j < dim; ++j )
+        {
+            m_canonical[i * dim + j] = m_symmetry.values[cell( m_symmetry.transposed, m_symmetry.rows[i], m_symmetry.columns[j] )];
+        }
+    }
+    m_digest = Sudoku::digest( m_canonical.data(), m_canonical.size() );
+}
+
+
+void Canonicalizer::toCanonical( const Nums& values, Nums& canonical ) const
+{
+    const auto dim = m_dimension;
+    canonical.resize( dim * dim );
+
+    for( Num i = 0; i < dim; ++i )
+    {
+        for( Num j = 0; j < dim; ++j )
+        {
+            const auto row = m_symmetry.rows[i];
+            const auto column = m_symmetry.columns[j];
+            const auto value = m_symmetry.transposed ? values[column * dim + row] : values[row * dim + column];
+            canonical[i * dim + j] = m_symmetry.values[value];
+        }
+    }
+}
+
+
+void Canonicalizer::fromCanonical( const Nums& canonical, Board::InputArray& values ) const
+{
+    const auto dim = m_dimension;
+    Nums original( dim + 1 );
+    for( Num value = 0; value <= dim; ++value )
+    {
+        original[m_symmetry.values[value]] = value;
+    }
+
+    values.resize( dim );
+    for( auto& row : values )
+    {
+        row.resize( dim );
+    }
+    for( Num i = 0; i < dim; ++i )
+    {
+        for( Num j = 0; j < dim; ++j )
+        {
+            const auto row = m_symmetry.rows[i];
+            const auto column = m_symmetry.columns[j];
+            auto& value = m_symmetry.transposed ? values[column][row] : values[row][column];
+            value = original[canonical[i * dim + j]];
+        }
+    }
+}
+
+
+void Canonicalizer::prepare( Num blockSide )
+{
+    const auto dim = blockSide * blockSide;
+    m_blockSide = blockSide;
+    m_dimension = dim;
+    m_stride = CandidateLayout::values( dim ) + dim + 1;
+
+    m_cells.resize( 2 * dim * dim );
+    m_best.resize( dim );
+    m_columns.resize( dim );
+    m_usedColumns.resize( dim );
+    m_profile.resize( blockSide );
+    m_bestProfile.resize( blockSide );
+    m_canonical.resize( dim * dim );
+    m_symmetry.rows.resize( dim );
+    m_symmetry.columns.resize( dim );
+    m_symmetry.values.resize( dim + 1 );
+}
+
+
+void Canonicalizer::profile( std::size_t transposed, std::size_t row )
+{
+    std::fill( m_profile.begin(), m_profile.end(), 0 );
+    for( std::size_t column = 0; column < m_dimension; ++column )
+    {
+        m_profile[column / m_blockSide] += cell( transposed, row, column ) == 0;
+    }
+    std::sort( m_profile.begin(), m_profile.end(), std::greater<Byte>() );
+}
+
+
+bool Canonicalizer::compare( std::vector<Byte>& list, std::size_t position, Byte value )
+{
+    if( value > m_best[position] )
+        return false;
+
+    if( value < m_best[position] )
+    {
+        // everything kept so far is worse: this row becomes the best one
+        m_best[position] = value;
+        std::fill( m_best.begin() + position + 1, m_best.end(), Unset );
+        list.clear();
+    }
+    return true;
+}
+
+
+void Canonicalizer::firstRow( std::size_t transposed, std::size_t row, std::size_t position, Byte labels )
+{
+    const auto dim = m_dimension;
+    const auto side = m_blockSide;
+
+    if( position == dim )
+    {
+        if( m_candidates.size() >= MaxCandidates * m_stride )
+        {
+            m_exact = false;
+            return;
+        }
+
+        const auto offset = m_candidates.size();
+        m_candidates.resize( offset + m_stride, 0 );
+        auto* candidate = &m_candidates[offset];
+        candidate[CandidateLayout::Transposed] = static_cast< Byte >( transposed );
+        candidate[CandidateLayout::Labels] = labels;
+        candidate[CandidateLayout::rows( dim )] = static_cast< Byte >( row );
+
+        Byte label = 0;
+        for( std::size_t j = 0; j < dim; ++j )
+        {
+            candidate[CandidateLayout::Columns + j] = m_columns[j];
+            const auto value = cell( transposed, row, m_columns[j] );
+            if( value )
+                candidate[CandidateLayout::values( dim ) + value] = ++label;
+        }
+        return;
+    }
+
+    if( m_budget == 0 && !m_candidates.empty() )
+    {
+        m_exact = false;
+        return;
+    }
+    m_budget -= m_budget != 0;
+
+    // a new stack starts every blockSide columns, otherwise the current stack goes on
+    std::size_t first = 0, last = dim;
+    if( position % side != 0 )
+    {
+        first = m_columns[position - 1] / side * side;
+        last = first + side;
+    }
+
+    for( auto column = first; column < last; ++column )
+    {
+        if( m_usedColumns[column] || ( position % side == 0 && m_usedColumns[column / side * side] ) )
+            continue;
+
+        const auto value = cell( transposed, row, column );
+        const auto label = static_cast< Byte >( value ? labels + 1 : 0 );
+        if( !compare( m_candidates, position, label ) )
+            continue;
+
+        m_columns[position] = static_cast< Byte >( column );
+        m_usedColumns[column] = 1;
+        firstRow( transposed, row, position + 1, value ? labels + 1 : labels );
+        m_usedColumns[column] = 0;
+    }
+}
+
+
+void Canonicalizer::nextRow( std::size_t depth )
+{
+    const auto dim = m_dimension;
+    const auto side = m_blockSide;
+    Byte labels[Unset + 1];
+
+    m_next.clear();
+    std::fill( m_best.begin(), m_best.end(), Unset );
+
+    for( std::size_t offset = 0; offset < m_candidates.size(); offset += m_stride )
+    {
+        const auto* candidate = &m_candidates[offset];
+        const auto transposed = candidate[CandidateLayout::Transposed];
+        const auto* columns = candidate + CandidateLayout::Columns;
+        const auto* rows = candidate + CandidateLayout::rows( dim );
+
+        // a new band starts every blockSide rows, otherwise the current band goes on
+        std::size_t first = 0, last = dim;
+        if( depth % side != 0 )
+        {
+            first = rows[depth - 1] / side * side;
+            last = first + side;
+        }
+
+        for( auto row = first; row < last; ++row )
+        {
+            const auto used = std::any_of( rows, rows + depth, [row, side, depth]( Byte chosen )
+                {
+                    return depth % side == 0 ? chosen / side == row / side : chosen == row;
+                } );
+            if( used )
+                continue;
+
+            if( m_budget == 0 && !m_next.empty() )
+            {
+                m_exact = false;
+                break;
+            }
+            m_budget -= m_budget != 0;
+
+            std::copy( candidate + CandidateLayout::values( dim ), candidate + m_stride, labels );
+            auto label = candidate[CandidateLayout::Labels];
+            bool kept = true;
+            for( std::size_t j = 0; j < dim && kept; ++j )
+            {
+                const auto value = cell( transposed, row, columns[j] );
+                if( value && !labels[value] )
+                    labels[value] = ++label;
+                kept = compare( m_next, j, labels[value] );
+            }
+            if( !kept )
+                continue;
+
+            if( m_next.size() >= MaxCandidates * m_stride )
+            {
+                m_exact = false;
+                continue;
+            }
+
+            const auto next = m_next.size();
+            m_next.insert( m_next.end(), candidate, candidate + m_stride );
+            m_next[next + CandidateLayout::Labels] = label;
+            m_next[next + CandidateLayout::rows( dim ) + depth] = static_cast< Byte >( row );
+            std::copy( labels, labels + dim + 1, m_next.begin() + next + CandidateLayout::values( dim ) );
+        }
+    }
+
+    m_candidates.swap( m_next );
+}
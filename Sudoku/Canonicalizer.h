@@ -0,0 +1,148 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Board.h"
+#include "Digest.h"
+
+namespace Sudoku
+{
+
+/**
+* @brief A transformation of a board that keeps it valid: a transposition,
+* then a permutation of its rows and of its columns that only moves them
+* within their band or stack and moves whole bands and stacks, then a
+* relabeling of its values.
+*/
+struct Symmetry
+{
+    bool transposed = false;
+    /**
+    * @brief rows[i] is the row of the (transposed) board moved to row i.
+    */
+    Nums rows;
+    /**
+    * @brief columns[j] is the column of the (transposed) board moved to column j.
+    */
+    Nums columns;
+    /**
+    * @brief values[v] is the value replacing v; values[0] is 0.
+    */
+    Nums values;
+};
+
+/**
+* @brief Finds the canonical form of boards: of all the boards equivalent to a
+* board under transposition, row and column permutations within bands and
+* stacks, band and stack permutations and value relabeling, the one whose
+* values are the smallest in row order, empty cells being the smallest value.
+*
+* The form is built row by row, keeping every transformation that gives the
+* smallest rows so far. Very symmetric boards (e.g. nearly empty ones) could
+* keep too many of them: the search is then bounded and its result is only a
+* form equivalent to the board, not the canonical one. Either way symmetry()
+* maps the board to canonical() exactly.
+*
+* Canonicalize the givens of a puzzle rather than a Board built from them:
+* Board propagation doesn't reach the same state for every orientation of a
+* puzzle, so equivalent boards could get different forms.
+*
+* A canonicalizer keeps its memory between boards.
+*/
+class Canonicalizer
+{
+public:
+    /**
+    * @brief Finds the canonical form of a board.
+    * @param values the values of the board, 0 denoting empty cells
+    * @throw std::invalid_argument if the values are not a square board of at
+    * most 225x225 cells with values in range
+    */
+    void canonicalize( const Board::InputArray& values );
+    /**
+    * @brief Gets the values of the canonical form, in row order.
+    * @return the canonical values.
+    */
+    const Nums& canonical() const noexcept
+    {
+        return m_canonical;
+    }
+    /**
+    * @brief Gets the transformation from the board to its canonical form.
+    * @return the transformation.
+    */
+    const Symmetry& symmetry() const noexcept
+    {
+        return m_symmetry;
+    }
+    /**
+    * @brief Gets the digest of the canonical form, identifying the board up to symmetry.
+    * @return the digest.
+    */
+    Digest digest() const noexcept
+    {
+        return m_digest;
+    }
+    /**
+    * @brief Tells if the search was complete, i.e. if canonical() is the
+    * canonical form rather than just an equivalent form.
+    * @return True if the search was complete.
+    */
+    bool exact() const noexcept
+    {
+        return m_exact;
+    }
+    /**
+    * @brief Applies the transformation found to other values in the board's
+    * orientation, e.g. to its solution.
+    * @param values the values in the board's orientation, in row order
+    * @param[out] canonical the values in the canonical orientation, in row order
+    */
+    void toCanonical( const Nums& values, Nums& canonical ) const;
+    /**
+    * @brief Applies the inverse of the transformation found to values in the
+    * canonical orientation, e.g. to the solution of the canonical form.
+    * @param canonical the values in the canonical orientation, in row order
+    * @param[out] values the values in the board's orientation
+    */
+    void fromCanonical( const Nums& canonical, Board::InputArray& values ) const;
+
+private:
+    using Byte = std::uint8_t;
+
+    Num m_blockSide = 0;
+    Num m_dimension = 0;
+    // board values, then the values of the transposed board
+    std::vector<Byte> m_cells;
+    // transformations still tied for the smallest rows, see CandidateLayout
+    std::vector<Byte> m_candidates;
+    std::vector<Byte> m_next;
+    std::size_t m_stride = 0;
+    // smallest row found at the current depth
+    std::vector<Byte> m_best;
+    // first row search state
+    std::vector<Byte> m_columns;
+    std::vector<Byte> m_usedColumns;
+    // empty cells in each stack of a row, from the emptiest stack
+    std::vector<Byte> m_profile;
+    std::vector<Byte> m_bestProfile;
+    std::size_t m_budget = 0;
+
+    Nums m_canonical;
+    Symmetry m_symmetry;
+    Digest m_digest;
+    bool m_exact = true;
+
+    void prepare( Num blockSide );
+    Byte cell( std::size_t transposed, std::size_t row, std::size_t column ) const noexcept
+    {
+        return m_cells[( transposed * m_dimension + row ) * m_dimension + column];
+    }
+    void profile( std::size_t transposed, std::size_t row );
+    bool compare( std::vector<Byte>& list, std::size_t position, Byte value );
+    void firstRow( std::size_t transposed, std::size_t row, std::size_t position, Byte labels );
+    void nextRow( std::size_t depth );
+};
+
+} // namespace
@@ -64,9 +64,31 @@ void Cell::possibilities( const Nums& possibilities )
     m_possibilities = possibilities;
 }
 
+std::size_t Cell::count() const noexcept
+{
+    return m_possibilities.size();
+}
+
+Num Cell::possibility( std::size_t index ) const noexcept
+{
+    if( index < m_possibilities.size() )
+        return m_possibilities[index];
+
+    return 0;
+}
+
+void Cell::restore( Num n )
+{
+    auto it = std::lower_bound( m_possibilities.begin(), m_possibilities.end(), n );
+    if( it == m_possibilities.end() || *it != n )
+    {
+        m_possibilities.insert( it, n );
+    }
+}
+
 bool Cell::operator==( const Cell& rhs ) const noexcept
 {
-    return m_possibilities == rhs.possibilities();
+    return m_possibilities == rhs.m_possibilities;
 }
 
 bool Cell::operator!=( const Cell& rhs ) const noexcept
@@ -1,4 +1,6 @@
 #pragma once
+#include <algorithm>
+#include <cstddef>
 #include <numeric>
 
 #include "Common.h"
@@ -6,6 +8,52 @@
 namespace Sudoku
 {
 
+/**
+* @brief A read-only view of the possible values of a cell, in ascending
+* order. It points into the cell, so it is only valid until the cell changes.
+*/
+class Candidates
+{
+public:
+    Candidates( const Num* first, const Num* last ) noexcept :
+        m_first( first ),
+        m_last( last )
+    {
+    }
+
+    const Num* begin() const noexcept
+    {
+        return m_first;
+    }
+    const Num* end() const noexcept
+    {
+        return m_last;
+    }
+    std::size_t size() const noexcept
+    {
+        return static_cast< std::size_t >( m_last - m_first );
+    }
+    bool empty() const noexcept
+    {
+        return m_first == m_last;
+    }
+    Num operator[]( std::size_t index ) const noexcept
+    {
+        return m_first[index];
+    }
+    /**
+    * @brief Checks if a value is possible.
+    */
+    bool contains( Num value ) const noexcept
+    {
+        return std::binary_search( m_first, m_last, value );
+    }
+
+private:
+    const Num* m_first;
+    const Num* m_last;
+};
+
 /**
 * @brief Represents a cell of a sudoku board.
 */
@@ -47,15 +95,41 @@ public:
     */
     bool remove( Num n ) noexcept;
     /**
-    * @brief Retrieves the possible values for this cell.
+    * @brief Retrieves a copy of the possible values for this cell, see
+    * candidates() to read them without allocating.
     * @return the possible values for this cell.
     */
     Nums possibilities() const noexcept;
     /**
+    * @brief Retrieves the possible values for this cell without copying them.
+    * @return a view of the possible values, valid until the cell changes.
+    */
+    Candidates candidates() const noexcept
+    {
+        return Candidates( m_possibilities.data(), m_possibilities.data() + m_possibilities.size() );
+    }
+    /**
     * @brief Sets the possible values for this cell.
     * @param possibilities the possible values for this cell.
     */
     void possibilities( const Nums& possibilities );
+    /**
+    * @brief Retrieves the number of possible values for this cell.
+    * @return the number of possible values for this cell.
+    */
+    std::size_t count() const noexcept;
+    /**
+    * @brief Retrieves a possible value without copying the possibility list.
+    * @param index the position of the value, in ascending order
+    * @return the possible value, or 0 if index is out of range
+    */
+    Num possibility( std::size_t index ) const noexcept;
+    /**
+    * @brief Adds back a possible value that was removed, keeping the
+    * possibilities in ascending order.
+    * @param n the possibility to restore
+    */
+    void restore( Num n );
 
     /**
     * @brief Compares two cells for equality
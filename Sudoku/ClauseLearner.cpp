@@ -0,0 +1,977 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "ClauseLearner.h"
+
+using Sudoku::Board;
+using Sudoku::LearnOptions;
+using Sudoku::Num;
+using Sudoku::Nums;
+using Sudoku::SolveOptions;
+using Sudoku::SolveResult;
+using Sudoku::SolveStatus;
+
+namespace
+{
+/**
+* @brief A variable tells if a cell takes a value, and a literal is a variable
+* or its negation, at 2 * variable + 1.
+*/
+using Variable = std::uint32_t;
+using Literal = std::uint32_t;
+/**
+* @brief Offset of a clause in the clause arena.
+*/
+using ClauseRef = std::uint32_t;
+
+/**
+* @brief The reason of an implied literal is the clause that implied it. For
+* a binary clause it is the other literal of the clause, flagged with
+* BinaryReason, as those clauses are not stored in the arena.
+*/
+constexpr std::uint32_t BinaryReason = 0x80000000u;
+constexpr std::uint32_t NoReason = 0xFFFFFFFFu;
+constexpr Variable NoVariable = 0xFFFFFFFFu;
+constexpr std::size_t NotInHeap = static_cast< std::size_t >( -1 );
+
+/**
+* @brief Number of decisions and conflicts between two checks of the limits.
+*/
+constexpr std::size_t CheckInterval = 256;
+constexpr double ClauseDecay = 0.999;
+constexpr double ActivityLimit = 1e100;
+constexpr float ClauseActivityLimit = 1e20f;
+/**
+* @brief Learned clauses kept before the first reduction, at least.
+*/
+constexpr std::size_t MinLearnts = 2000;
+
+enum : signed char
+{
+    False = -1,
+    Undefined = 0,
+    True = 1
+};
+
+Literal makeLiteral( Variable variable, bool negated ) noexcept
+{
+    return variable * 2 + ( negated ? 1 : 0 );
+}
+
+
+Variable variableOf( Literal literal ) noexcept
+{
+    return literal >> 1;
+}
+
+
+Literal negation( Literal literal ) noexcept
+{
+    return literal ^ 1;
+}
+
+
+/**
+* @brief Returns the element at index of the Luby sequence, 1, 1, 2, 1, 1, 2,
+* 4, 1, ..., the restart schedule within a constant factor of the optimal one
+* when nothing is known of the search.
+*/
+std::size_t luby( std::size_t index ) noexcept
+{
+    std::size_t size = 1;
+    std::size_t sequence = 0;
+    while( size < index + 1 )
+    {
+        ++sequence;
+        size = 2 * size + 1;
+    }
+    while( size - 1 != index )
+    {
+        size = ( size - 1 ) >> 1;
+        --sequence;
+        index = index % size;
+    }
+    return std::size_t( 1 ) << sequence;
+}
+
+
+/**
+* @brief A clause watching one of its two first literals, along with another
+* of its literals: when that one is true, the clause is satisfied and isn't
+* visited.
+*/
+struct Watcher
+{
+    ClauseRef clause;
+    Literal blocker;
+};
+
+/**
+* @brief The clauses, variable assignments and heuristics of the search.
+*
+* Clauses of three literals or more are stored one after the other in an
+* arena, each a header of HeaderSize words followed by its literals, and
+* watched by their two first literals. Binary clauses, most of the encoding,
+* are only stored as the implications between their literals.
+*/
+class Learner
+{
+public:
+    Learner( std::size_t variables, const LearnOptions& learnOptions, const SolveOptions& options ) :
+        m_options( options ),
+        m_decay( learnOptions.activityDecay ),
+        m_restartInterval( learnOptions.restartInterval ),
+        m_values( variables, Undefined ),
+        m_levels( variables, 0 ),
+        m_reasons( variables, NoReason ),
+        m_phases( variables, 1 ),
+        m_seen( variables, 0 ),
+        m_activity( variables, 0.0 ),
+        m_heapIndex( variables, NotInHeap ),
+        m_implications( 2 * variables ),
+        m_watches( 2 * variables )
+    {
+        if( options.valueOrder == Sudoku::ValueOrder::Random )
+        {
+            // tiny enough to be outweighed by the first conflict
+            std::mt19937_64 random( options.seed );
+            std::uniform_real_distribution<double> distribution( 0.0, 1e-5 );
+            for( auto& activity : m_activity )
+            {
+                activity = distribution( random );
+            }
+        }
+        m_heap.reserve( variables );
+        for( Variable variable = 0; variable < variables; ++variable )
+        {
+            insert( variable );
+        }
+        m_trail.reserve( variables );
+    }
+
+    /**
+    * @brief Adds a clause of the encoding, before the search.
+    *
+    * @return False if the clause is empty or contradicts the unit clauses
+    * added so far, true otherwise.
+    */
+    bool addClause( const std::vector<Literal>& literals )
+    {
+        if( literals.empty() )
+            return false;
+
+        if( literals.size() == 1 )
+        {
+            const auto value = valueOf( literals[0] );
+            if( value == Undefined )
+                assign( literals[0], NoReason );
+            return value != False;
+        }
+
+        if( literals.size() == 2 )
+        {
+            addBinary( literals[0], literals[1] );
+        }
+        else
+        {
+            attach( allocate( literals, false ) );
+            ++m_clauses;
+        }
+        return true;
+    }
+
+    /**
+    * @brief Searches for an assignment satisfying every clause.
+    */
+    SolveStatus solve()
+    {
+        m_maxLearnts = std::max( MinLearnts, m_clauses / 3 );
+        std::size_t restarts = 0;
+        std::size_t conflictsUntilRestart = luby( restarts ) * m_restartInterval;
+        std::size_t steps = 0;
+
+        for( ;; )
+        {
+            if( steps++ % CheckInterval == 0 )
+            {
+                if( m_options.cancellation.cancelled() )
+                    return SolveStatus::Cancelled;
+                if( SolveOptions::Clock::now() >= m_options.deadline )
+                    return SolveStatus::DeadlineExceeded;
+            }
+
+            if( !propagate() )
+            {
+                ++m_conflicts;
+                if( decisionLevel() == 0 )
+                    return SolveStatus::Unsolvable;
+
+                analyze();
+                learn();
+                m_increment /= m_decay;
+                m_clauseIncrement /= ClauseDecay;
+
+                if( m_restartInterval != 0 && --conflictsUntilRestart == 0 )
+                {
+                    cancelUntil( 0 );
+                    conflictsUntilRestart = luby( ++restarts ) * m_restartInterval;
+                }
+                if( m_learnts.size() >= m_maxLearnts )
+                    reduce();
+                continue;
+            }
+
+            const auto variable = pickBranch();
+            if( variable == NoVariable )
+                return SolveStatus::Solved;
+
+            if( m_options.maxNodes != 0 && m_decisions >= m_options.maxNodes )
+                return SolveStatus::NodeLimitExceeded;
+
+            ++m_decisions;
+            m_trailLimits.push_back( m_trail.size() );
+            m_maxLevel = std::max( m_maxLevel, m_trailLimits.size() );
+            assign( makeLiteral( variable, !m_phases[variable] ), NoReason );
+        }
+    }
+
+    bool isTrue( Variable variable ) const noexcept
+    {
+        return m_values[variable] == True;
+    }
+
+    std::size_t decisions() const noexcept
+    {
+        return m_decisions;
+    }
+
+    std::size_t conflicts() const noexcept
+    {
+        return m_conflicts;
+    }
+
+    std::size_t maxLevel() const noexcept
+    {
+        return m_maxLevel;
+    }
+
+private:
+    // the header of a clause: its size, its flags, then its activity
+    static constexpr std::size_t HeaderSize = 3;
+    static constexpr std::uint32_t Learnt = 1;
+    static constexpr std::uint32_t Deleted = 2;
+    static constexpr std::uint32_t Moved = 4;
+
+    std::uint32_t sizeOf( ClauseRef clause ) const noexcept
+    {
+        return m_arena[clause];
+    }
+
+    std::uint32_t& flagsOf( ClauseRef clause ) noexcept
+    {
+        return m_arena[clause + 1];
+    }
+
+    Literal* literalsOf( ClauseRef clause ) noexcept
+    {
+        return m_arena.data() + clause + HeaderSize;
+    }
+
+    float activityOf( ClauseRef clause ) const noexcept
+    {
+        float activity;
+        std::memcpy( &activity, &m_arena[clause + 2], sizeof( activity ) );
+        return activity;
+    }
+
+    void setActivity( ClauseRef clause, float activity ) noexcept
+    {
+        std::memcpy( &m_arena[clause + 2], &activity, sizeof( activity ) );
+    }
+
+    signed char valueOf( Literal literal ) const noexcept
+    {
+        const auto value = m_values[variableOf( literal )];
+        return ( literal & 1 ) ? static_cast< signed char >( -value ) : value;
+    }
+
+    std::size_t decisionLevel() const noexcept
+    {
+        return m_trailLimits.size();
+    }
+
+    void assign( Literal literal, std::uint32_t reason ) noexcept
+    {
+        const auto variable = variableOf( literal );
+        m_values[variable] = ( literal & 1 ) ? False : True;
+        m_levels[variable] = static_cast< std::uint32_t >( decisionLevel() );
+        m_reasons[variable] = reason;
+        m_trail.push_back( literal );
+    }
+
+    void addBinary( Literal first, Literal second )
+    {
+        m_implications[negation( first )].push_back( second );
+        m_implications[negation( second )].push_back( first );
+    }
+
+    ClauseRef allocate( const std::vector<Literal>& literals, bool learnt )
+    {
+        const auto clause = static_cast< ClauseRef >( m_arena.size() );
+        if( clause + HeaderSize + literals.size() >= BinaryReason )
+            throw std::length_error( "clause database too large" );
+
+        m_arena.push_back( static_cast< std::uint32_t >( literals.size() ) );
+        m_arena.push_back( learnt ? Learnt : 0 );
+        m_arena.push_back( 0 );
+        m_arena.insert( m_arena.end(), literals.begin(), literals.end() );
+        return clause;
+    }
+
+    void attach( ClauseRef clause )
+    {
+        const auto* literals = literalsOf( clause );
+        m_watches[literals[0]].push_back( { clause, literals[1] } );
+        m_watches[literals[1]].push_back( { clause, literals[0] } );
+    }
+
+    /**
+    * @brief Assigns the literals implied by the trail not propagated yet.
+    *
+    * @return False on a conflict, recorded in m_conflict, true otherwise.
+    */
+    bool propagate()
+    {
+        while( m_head < m_trail.size() )
+        {
+            const auto literal = m_trail[m_head++];
+            const auto falsified = negation( literal );
+
+            for( const auto implied : m_implications[literal] )
+            {
+                const auto value = valueOf( implied );
+                if( value == Undefined )
+                {
+                    assign( implied, BinaryReason | falsified );
+                }
+                else if( value == False )
+                {
+                    m_conflict = BinaryReason | falsified;
+                    m_conflictLiteral = implied;
+                    return false;
+                }
+            }
+
+            auto& watchers = m_watches[falsified];
+            std::size_t kept = 0;
+            std::size_t i = 0;
+            bool conflict = false;
+            while( i < watchers.size() )
+            {
+                const auto watcher = watchers[i++];
+                if( valueOf( watcher.blocker ) == True )
+                {
+                    watchers[kept++] = watcher;
+                    continue;
+                }
+
+                auto* literals = literalsOf( watcher.clause );
+                if( literals[0] == falsified )
+                    std::swap( literals[0], literals[1] );
+                const auto first = literals[0];
+                if( first != watcher.blocker && valueOf( first ) == True )
+                {
+                    watchers[kept++] = { watcher.clause, first };
+                    continue;
+                }
+
+                // watch another literal that isn't false, if any
+                const auto size = sizeOf( watcher.clause );
+                bool moved = false;
+                for( std::uint32_t k = 2; k < size; ++k )
+                {
+                    if( valueOf( literals[k] ) != False )
+                    {
+                        std::swap( literals[1], literals[k] );
+                        m_watches[literals[1]].push_back( { watcher.clause, first } );
+                        moved = true;
+                        break;
+                    }
+                }
+                if( moved )
+                    continue;
+
+                watchers[kept++] = { watcher.clause, first };
+                if( valueOf( first ) == False )
+                {
+                    m_conflict = watcher.clause;
+                    conflict = true;
+                    while( i < watchers.size() )
+                    {
+                        watchers[kept++] = watchers[i++];
+                    }
+                }
+                else
+                {
+                    assign( first, watcher.clause );
+                }
+            }
+            watchers.resize( kept );
+            if( conflict )
+                return false;
+        }
+        return true;
+    }
+
+    /**
+    * @brief Derives from the conflict the clause asserting the negation of its
+    * first unique implication point, the single literal of the current level
+    * all the conflict's implications of that level go through.
+    */
+    void analyze()
+    {
+        const auto level = decisionLevel();
+        m_learnt.assign( 1, 0 );
+        std::size_t pending = 0;
+        auto index = m_trail.size();
+        auto reason = m_conflict;
+        Literal implied = 0;
+        bool conflict = true;
+
+        for( ;; )
+        {
+            const Literal pair[2] = { reason & ~BinaryReason, m_conflictLiteral };
+            const Literal* begin = pair;
+            const Literal* end = pair;
+            if( reason & BinaryReason )
+            {
+                end = pair + ( conflict ? 2 : 1 );
+            }
+            else
+            {
+                if( flagsOf( reason ) & Learnt )
+                    bumpClause( reason );
+                begin = literalsOf( reason );
+                end = begin + sizeOf( reason );
+                // the first literal of a reason is the literal it implied
+                if( !conflict )
+                    ++begin;
+            }
+
+            for( auto it = begin; it != end; ++it )
+            {
+                const auto variable = variableOf( *it );
+                if( m_seen[variable] || m_levels[variable] == 0 )
+                    continue;
+
+                m_seen[variable] = 1;
+                bumpVariable( variable );
+                if( m_levels[variable] == level )
+                    ++pending;
+                else
+                    m_learnt.push_back( *it );
+            }
+
+            while( !m_seen[variableOf( m_trail[--index] )] )
+            {
+            }
+            implied = m_trail[index];
+            m_seen[variableOf( implied )] = 0;
+            if( --pending == 0 )
+                break;
+
+            reason = m_reasons[variableOf( implied )];
+            conflict = false;
+        }
+        m_learnt[0] = negation( implied );
+
+        // drop the literals implied by the others
+        m_analyzed.assign( m_learnt.begin(), m_learnt.end() );
+        std::size_t kept = 1;
+        for( std::size_t i = 1; i < m_learnt.size(); ++i )
+        {
+            if( !isRedundant( m_learnt[i] ) )
+                m_learnt[kept++] = m_learnt[i];
+        }
+        m_learnt.resize( kept );
+        for( const auto literal : m_analyzed )
+        {
+            m_seen[variableOf( literal )] = 0;
+        }
+    }
+
+    /**
+    * @brief Tells if every literal of the reason of a literal of the learned
+    * clause is in the clause or fixed at level 0.
+    */
+    bool isRedundant( Literal literal ) noexcept
+    {
+        const auto reason = m_reasons[variableOf( literal )];
+        if( reason == NoReason )
+            return false;
+
+        if( reason & BinaryReason )
+        {
+            const auto variable = variableOf( reason & ~BinaryReason );
+            return m_seen[variable] || m_levels[variable] == 0;
+        }
+
+        const auto* literals = literalsOf( reason );
+        for( std::uint32_t i = 1; i < sizeOf( reason ); ++i )
+        {
+            const auto variable = variableOf( literals[i] );
+            if( !m_seen[variable] && m_levels[variable] != 0 )
+                return false;
+        }
+        return true;
+    }
+
+    /**
+    * @brief Jumps back to the level where the learned clause implies its
+    * first literal, the highest level of its other literals, and records it.
+    */
+    void learn()
+    {
+        std::size_t level = 0;
+        if( m_learnt.size() > 1 )
+        {
+            std::size_t highest = 1;
+            for( std::size_t i = 2; i < m_learnt.size(); ++i )
+            {
+                if( m_levels[variableOf( m_learnt[i] )] > m_levels[variableOf( m_learnt[highest] )] )
+                    highest = i;
+            }
+            std::swap( m_learnt[1], m_learnt[highest] );
+            level = m_levels[variableOf( m_learnt[1] )];
+        }
+        cancelUntil( level );
+
+        if( m_learnt.size() == 1 )
+        {
+            assign( m_learnt[0], NoReason );
+        }
+        else if( m_learnt.size() == 2 )
+        {
+            addBinary( m_learnt[0], m_learnt[1] );
+            assign( m_learnt[0], BinaryReason | m_learnt[1] );
+        }
+        else
+        {
+            const auto clause = allocate( m_learnt, true );
+            attach( clause );
+            m_learnts.push_back( clause );
+            bumpClause( clause );
+            assign( m_learnt[0], clause );
+        }
+    }
+
+    void cancelUntil( std::size_t level )
+    {
+        if( decisionLevel() <= level )
+            return;
+
+        const auto end = m_trailLimits[level];
+        for( auto i = m_trail.size(); i-- > end; )
+        {
+            const auto variable = variableOf( m_trail[i] );
+            // branch the same way when the variable is picked again
+            m_phases[variable] = ( m_trail[i] & 1 ) ? 0 : 1;
+            m_values[variable] = Undefined;
+            m_reasons[variable] = NoReason;
+            if( m_heapIndex[variable] == NotInHeap )
+                insert( variable );
+        }
+        m_trail.resize( end );
+        m_head = end;
+        m_trailLimits.resize( level );
+    }
+
+    Variable pickBranch()
+    {
+        while( !m_heap.empty() )
+        {
+            const auto variable = removeMax();
+            if( m_values[variable] == Undefined )
+                return variable;
+        }
+        return NoVariable;
+    }
+
+    void bumpVariable( Variable variable ) noexcept
+    {
+        m_activity[variable] += m_increment;
+        if( m_activity[variable] > ActivityLimit )
+        {
+            for( auto& activity : m_activity )
+            {
+                activity /= ActivityLimit;
+            }
+            m_increment /= ActivityLimit;
+        }
+        if( m_heapIndex[variable] != NotInHeap )
+            siftUp( m_heapIndex[variable] );
+    }
+
+    void bumpClause( ClauseRef clause ) noexcept
+    {
+        const auto activity = activityOf( clause ) + static_cast< float >( m_clauseIncrement );
+        setActivity( clause, activity );
+        if( activity > ClauseActivityLimit )
+        {
+            for( const auto learnt : m_learnts )
+            {
+                setActivity( learnt, activityOf( learnt ) / ClauseActivityLimit );
+            }
+            m_clauseIncrement /= ClauseActivityLimit;
+        }
+    }
+
+    /**
+    * @brief Deletes the less active half of the learned clauses, except the
+    * reasons of current assignments, and compacts the arena.
+    */
+    void reduce()
+    {
+        std::sort( m_learnts.begin(), m_learnts.end(), [this]( ClauseRef first, ClauseRef second )
+            {
+                return activityOf( first ) < activityOf( second );
+            } );
+
+        const auto half = m_learnts.size() / 2;
+        for( std::size_t i = 0; i < half; ++i )
+        {
+            const auto clause = m_learnts[i];
+            const auto implied = literalsOf( clause )[0];
+            const bool locked = valueOf( implied ) == True && m_reasons[variableOf( implied )] == clause;
+            if( !locked )
+                flagsOf( clause ) |= Deleted;
+        }
+        collect();
+        m_maxLearnts += m_maxLearnts / 10;
+    }
+
+    /**
+    * @brief Moves the clauses left to a new arena, recording in the header of
+    * each old clause where it moved, then updates the references to them.
+    */
+    void collect()
+    {
+        std::vector<std::uint32_t> arena;
+        arena.reserve( m_arena.size() );
+        for( std::size_t clause = 0; clause < m_arena.size(); )
+        {
+            const auto size = HeaderSize + m_arena[clause];
+            if( !( m_arena[clause + 1] & Deleted ) )
+            {
+                const auto moved = static_cast< std::uint32_t >( arena.size() );
+                arena.insert( arena.end(), m_arena.begin() + clause, m_arena.begin() + clause + size );
+                m_arena[clause + 1] |= Moved;
+                m_arena[clause + 2] = moved;
+            }
+            clause += size;
+        }
+
+        const auto relocate = [this]( ClauseRef& clause )
+            {
+                if( !( m_arena[clause + 1] & Moved ) )
+                    return false;
+                clause = m_arena[clause + 2];
+                return true;
+            };
+
+        for( auto& watchers : m_watches )
+        {
+            std::size_t kept = 0;
+            for( auto watcher : watchers )
+            {
+                if( relocate( watcher.clause ) )
+                    watchers[kept++] = watcher;
+            }
+            watchers.resize( kept );
+        }
+        for( const auto literal : m_trail )
+        {
+            auto& reason = m_reasons[variableOf( literal )];
+            if( reason != NoReason && !( reason & BinaryReason ) )
+                relocate( reason );
+        }
+        std::size_t kept = 0;
+        for( auto clause : m_learnts )
+        {
+            if( relocate( clause ) )
+                m_learnts[kept++] = clause;
+        }
+        m_learnts.resize( kept );
+        m_arena.swap( arena );
+    }
+
+    // a max heap of the unassigned variables by activity
+    bool before( Variable first, Variable second ) const noexcept
+    {
+        return m_activity[first] > m_activity[second];
+    }
+
+    void insert( Variable variable )
+    {
+        m_heapIndex[variable] = m_heap.size();
+        m_heap.push_back( variable );
+        siftUp( m_heap.size() - 1 );
+    }
+
+    Variable removeMax() noexcept
+    {
+        const auto top = m_heap.front();
+        m_heapIndex[top] = NotInHeap;
+        const auto last = m_heap.back();
+        m_heap.pop_back();
+        if( !m_heap.empty() )
+        {
+            m_heap.front() = last;
+            m_heapIndex[last] = 0;
+            siftDown( 0 );
+        }
+        return top;
+    }
+
+    void siftUp( std::size_t index ) noexcept
+    {
+        const auto variable = m_heap[index];
+        while( index > 0 )
+        {
+            const auto parent = ( index - 1 ) / 2;
+            if( !before( variable, m_heap[parent] ) )
+                break;
+            m_heap[index] = m_heap[parent];
+            m_heapIndex[m_heap[index]] = index;
+            index = parent;
+        }
+        m_heap[index] = variable;
+        m_heapIndex[variable] = index;
+    }
+
+    void siftDown( std::size_t index ) noexcept
+    {
+        const auto variable = m_heap[index];
+        for( ;; )
+        {
+            auto child = 2 * index + 1;
+            if( child >= m_heap.size() )
+                break;
+            if( child + 1 < m_heap.size() && before( m_heap[child + 1], m_heap[child] ) )
+                ++child;
+            if( !before( m_heap[child], variable ) )
+                break;
+            m_heap[index] = m_heap[child];
+            m_heapIndex[m_heap[index]] = index;
+            index = child;
+        }
+        m_heap[index] = variable;
+        m_heapIndex[variable] = index;
+    }
+
+    const SolveOptions& m_options;
+    double m_decay;
+    std::size_t m_restartInterval;
+
+    std::vector<signed char> m_values;
+    std::vector<std::uint32_t> m_levels;
+    std::vector<std::uint32_t> m_reasons;
+    std::vector<char> m_phases;
+    std::vector<char> m_seen;
+    std::vector<double> m_activity;
+    double m_increment = 1.0;
+    double m_clauseIncrement = 1.0;
+    std::vector<Variable> m_heap;
+    std::vector<std::size_t> m_heapIndex;
+
+    std::vector<Literal> m_trail;
+    std::vector<std::size_t> m_trailLimits;
+    std::size_t m_head = 0;
+
+    // m_implications[literal] are the literals implied by literal
+    std::vector<std::vector<Literal>> m_implications;
+    std::vector<std::vector<Watcher>> m_watches;
+    std::vector<std::uint32_t> m_arena;
+    std::vector<ClauseRef> m_learnts;
+    std::size_t m_clauses = 0;
+    std::size_t m_maxLearnts = MinLearnts;
+
+    std::uint32_t m_conflict = NoReason;
+    Literal m_conflictLiteral = 0;
+    std::vector<Literal> m_learnt;
+    std::vector<Literal> m_analyzed;
+
+    std::size_t m_decisions = 0;
+    std::size_t m_conflicts = 0;
+    std::size_t m_maxLevel = 0;
+};
+
+/**
+* @brief Adds the clauses stating that exactly one of the literals is true.
+*
+* @param dim the dimension of the board if the literals are the cells of a
+* block taking a value, 0 otherwise. Cells of a block sharing a row or column
+* are left out of its pairwise exclusions, already stated by the row or column.
+*/
+bool addExactlyOne( Learner& learner, const std::vector<Literal>& literals, Num dim, std::vector<Literal>& clause )
+{
+    if( !learner.addClause( literals ) )
+        return false;
+
+    for( std::size_t i = 0; i < literals.size(); ++i )
+    {
+        for( std::size_t j = i + 1; j < literals.size(); ++j )
+        {
+            if( dim != 0 )
+            {
+                const auto first = variableOf( literals[i] ) / dim;
+                const auto second = variableOf( literals[j] ) / dim;
+                if( first / dim == second / dim || first % dim == second % dim )
+                    continue;
+            }
+            clause.assign( { negation( literals[i] ), negation( literals[j] ) } );
+            learner.addClause( clause );
+        }
+    }
+    return true;
+}
+}
+
+SolveResult Sudoku::learn( const Board::InputArray& givens, const SolveOptions& options, const LearnOptions& learnOptions )
+{
+    const auto start = SolveOptions::Clock::now();
+    const auto dim = static_cast< Num >( givens.size() );
+    Num blockSize = 1;
+    while( blockSize * blockSize < dim )
+    {
+        ++blockSize;
+    }
+    if( dim == 0 || blockSize * blockSize != dim ||
+        std::any_of( givens.begin(), givens.end(), [dim]( const Nums& row ) { return row.size() != dim; } ) )
+    {
+        throw std::invalid_argument( "unsupported board dimension: " + std::to_string( dim ) );
+    }
+
+    // the propagation of the givens leaves fewer variables to encode
+    Board board( blockSize, givens );
+    SolveResult result{ SolveStatus::Unsolvable, board, {} };
+    if( !board.isValid() )
+    {
+        result.stats.elapsed = SolveOptions::Clock::now() - start;
+        return result;
+    }
+
+    const auto variableOfCell = [dim]( std::size_t row, std::size_t col, Num value )
+        {
+            return static_cast< Variable >( ( row * dim + col ) * dim + value - 1 );
+        };
+    std::vector<char> possible( static_cast< std::size_t >( dim ) * dim * dim, 0 );
+    for( Num i = 0; i < dim; ++i )
+    {
+        for( Num j = 0; j < dim; ++j )
+        {
+            for( const auto value : board.candidates( i, j ) )
+            {
+                possible[variableOfCell( i, j, value )] = 1;
+            }
+        }
+    }
+
+    Learner learner( possible.size(), learnOptions, options );
+    bool consistent = true;
+    std::vector<Literal> literals;
+    std::vector<Literal> clause;
+
+    // every cell takes one value
+    for( Num i = 0; i < dim && consistent; ++i )
+    {
+        for( Num j = 0; j < dim && consistent; ++j )
+        {
+            literals.clear();
+            for( Num value = 1; value <= dim; ++value )
+            {
+                if( possible[variableOfCell( i, j, value )] )
+                    literals.push_back( makeLiteral( variableOfCell( i, j, value ), false ) );
+            }
+            consistent = addExactlyOne( learner, literals, 0, clause );
+        }
+    }
+
+    // every row, column and block takes each value once
+    for( Num value = 1; value <= dim && consistent; ++value )
+    {
+        for( Num unit = 0; unit < dim && consistent; ++unit )
+        {
+            literals.clear();
+            for( Num j = 0; j < dim; ++j )
+            {
+                if( possible[variableOfCell( unit, j, value )] )
+                    literals.push_back( makeLiteral( variableOfCell( unit, j, value ), false ) );
+            }
+            consistent = addExactlyOne( learner, literals, 0, clause );
+
+            literals.clear();
+            for( Num i = 0; i < dim; ++i )
+            {
+                if( possible[variableOfCell( i, unit, value )] )
+                    literals.push_back( makeLiteral( variableOfCell( i, unit, value ), false ) );
+            }
+            consistent = consistent && addExactlyOne( learner, literals, 0, clause );
+
+            literals.clear();
+            const Num top = unit / blockSize * blockSize;
+            const Num left = unit % blockSize * blockSize;
+            for( Num i = top; i < top + blockSize; ++i )
+            {
+                for( Num j = left; j < left + blockSize; ++j )
+                {
+                    if( possible[variableOfCell( i, j, value )] )
+                        literals.push_back( makeLiteral( variableOfCell( i, j, value ), false ) );
+                }
+            }
+            consistent = consistent && addExactlyOne( learner, literals, dim, clause );
+        }
+    }
+
+    // the values ruled out by the givens
+    for( Variable variable = 0; variable < possible.size() && consistent; ++variable )
+    {
+        if( !possible[variable] )
+        {
+            clause.assign( 1, makeLiteral( variable, true ) );
+            consistent = learner.addClause( clause );
+        }
+    }
+
+    if( consistent )
+        result.status = learner.solve();
+
+    result.stats.nodes = learner.decisions();
+    result.stats.visitedStates = learner.conflicts();
+    result.stats.maxDepth = learner.maxLevel();
+
+    if( result.status == SolveStatus::Solved )
+    {
+        Nums solution( dim * dim );
+        for( Num i = 0; i < dim; ++i )
+        {
+            for( Num j = 0; j < dim; ++j )
+            {
+                for( Num value = 1; value <= dim; ++value )
+                {
+                    if( learner.isTrue( variableOfCell( i, j, value ) ) )
+                        solution[i * dim + j] = value;
+                }
+            }
+        }
+        result.board = Board( blockSize, solution.data() );
+    }
+
+    result.stats.elapsed = SolveOptions::Clock::now() - start;
+    return result;
+}
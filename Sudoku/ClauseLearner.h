@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+
+#include "Board.h"
+#include "SolveOptions.h"
+
+namespace Sudoku
+{
+
+/**
+* @brief Settings of the clause learning engine.
+*/
+struct LearnOptions
+{
+    /**
+    * @brief Conflicts between restarts, scaled by the Luby sequence
+    * (1, 1, 2, 1, 1, 2, 4, ...). 0 disables restarts.
+    */
+    std::size_t restartInterval = 100;
+    /**
+    * @brief Factor applied to the activity of every variable after each
+    * conflict, below 1. Lower values focus the branching on recent conflicts.
+    */
+    double activityDecay = 0.95;
+};
+
+/**
+* @brief Solves a puzzle with conflict-driven clause learning, the technique of
+* modern SAT solvers, rather than chronological backtracking.
+*
+* The puzzle is encoded as one boolean variable per cell and value, with
+* clauses stating that every cell, row, column and block takes each value
+* exactly once, and the possibilities left by the givens as unit clauses. The
+* search assigns variables, propagates the clauses and, on every conflict,
+* learns a clause that rules the conflict's cause out everywhere in the tree,
+* then jumps back to the decision the cause depends on rather than the last
+* one. Variables involved in recent conflicts are branched on first, and the
+* search restarts periodically, keeping what it learned.
+*
+* With SolveOptions::valueOrder set to Random, the initial branching order is
+* shuffled from SolveOptions::seed. The statistics report the decisions as
+* nodes, the conflicts as visitedStates and the deepest decision level as
+* maxDepth.
+*
+* @param givens the values of the puzzle, 0 denoting empty cells
+* @param options the limits to apply to the solve
+* @param learnOptions the settings of the search
+* @return The outcome of the solve along with its statistics.
+* @throw std::invalid_argument if the givens are not a valid board
+*/
+SolveResult learn( const Board::InputArray& givens, const SolveOptions& options = {}, const LearnOptions& learnOptions = {} );
+
+} // namespace
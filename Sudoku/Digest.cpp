@@ -0,0 +1,40 @@
+#include "Digest.h"
+
+using Sudoku::Digest;
+
+namespace
+{
+std::uint64_t rotate( std::uint64_t value, unsigned bits ) noexcept
+{
+    return ( value << bits ) | ( value >> ( 64 - bits ) );
+}
+
+/**
+* @brief MurmurHash3 finalizer: every input bit affects every output bit.
+*/
+std::uint64_t finalize( std::uint64_t value ) noexcept
+{
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCDull;
+    value ^= value >> 33;
+    value *= 0xC4CEB9FE1A85EC53ull;
+    value ^= value >> 33;
+    return value;
+}
+}
+
+Digest Sudoku::digest( const Num* values, std::size_t count ) noexcept
+{
+    std::uint64_t high = 0x243F6A8885A308D3ull ^ count;
+    std::uint64_t low = 0x13198A2E03707344ull ^ ( count << 32 );
+
+    for( std::size_t i = 0; i < count; ++i )
+    {
+        high = rotate( ( high ^ values[i] ) * 0x9E3779B97F4A7C15ull, 31 );
+        low = rotate( ( low ^ values[i] ) * 0xC2B2AE3D27D4EB4Full, 29 ) + high;
+    }
+
+    high = finalize( high + low );
+    low = finalize( low ^ high );
+    return { high, low };
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "Common.h"
+
+namespace Sudoku
+{
+
+/**
+* @brief 128-bit digest of a sequence of values. Unlike BoardHasher, which
+* only needs to spread states over a hash table, it is meant to identify
+* boards. It runs two 64-bit multiply-rotate lanes over the values with
+* different constants; the low lane also adds in the high lane after every
+* value. The finalization mixes the sum of the lanes into the high half, then
+* the low lane with that into the low half. Every step is invertible for a
+* given value, so two boards only collide if both lanes end up equal. It is
+* not a cryptographic hash and doesn't hold up against crafted boards, but
+* accidental collisions between the boards a cache or store holds are
+* negligible.
+*/
+struct Digest
+{
+    std::uint64_t high = 0;
+    std::uint64_t low = 0;
+
+    bool operator==( const Digest& rhs ) const noexcept
+    {
+        return high == rhs.high && low == rhs.low;
+    }
+    bool operator!=( const Digest& rhs ) const noexcept
+    {
+        return !( *this == rhs );
+    }
+};
+
+/**
+* @brief Calculates the digest of a sequence of values.
+* @param values the first value
+* @param count the number of values
+* @return the digest of the values.
+*/
+Digest digest( const Num* values, std::size_t count ) noexcept;
+
+/**
+* @brief Hasher to key standard containers with digests.
+*/
+struct DigestHasher
+{
+    std::size_t operator()( const Digest& digest ) const noexcept
+    {
+        return static_cast< std::size_t >( digest.low );
+    }
+};
+
+} // namespace
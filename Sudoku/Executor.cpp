@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "Executor.h"
+#include "Solver.h"
+
+using Sudoku::Executor;
+using Sudoku::Board;
+using Sudoku::SolverContext;
+using Sudoku::SolveOptions;
+using Sudoku::SolveResult;
+
+Executor::Executor( std::size_t threads, std::size_t queueCapacity ) :
+    m_capacity( queueCapacity )
+{
+    if( threads == 0 || queueCapacity == 0 )
+        throw std::invalid_argument( "executor needs at least one thread and one queue slot" );
+
+    m_workers.reserve( threads );
+    for( std::size_t i = 0; i < threads; ++i )
+    {
+        m_workers.emplace_back( [this]() { work(); } );
+    }
+}
+
+
+Executor::~Executor()
+{
+    std::priority_queue<Request> dropped;
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_stopping = true;
+        std::swap( dropped, m_queue );
+    }
+    m_notEmpty.notify_all();
+    m_notFull.notify_all();
+
+    // fail the dropped requests before waiting for the running ones, so their
+    // callers don't wait for them
+    const auto error = std::make_exception_ptr( std::runtime_error( "executor is stopping" ) );
+    for( ; !dropped.empty(); dropped.pop() )
+    {
+        const auto& onDrop = dropped.top().onDrop;
+        if( !onDrop )
+            continue;
+        try
+        {
+            onDrop( error );
+        }
+        catch( ... )
+        {
+            // a failing callback must not stop the others from being called
+        }
+    }
+
+    for( auto& worker : m_workers )
+    {
+        worker.join();
+    }
+}
+
+
+void Executor::submit( Task task, int priority )
+{
+    push( std::move( task ), nullptr, priority );
+}
+
+
+bool Executor::trySubmit( Task task, int priority )
+{
+    std::unique_lock<std::mutex> lock( m_mutex );
+    if( m_stopping || m_queue.size() >= m_capacity )
+        return false;
+
+    m_queue.push( { priority, m_sequence++, std::move( task ), nullptr } );
+    lock.unlock();
+    m_notEmpty.notify_one();
+    return true;
+}
+
+
+std::future<SolveResult> Executor::solve( const Board& board, const SolveOptions& options, int priority )
+{
+    // std::function needs a copyable target, so the promise is shared
+    auto promise = std::make_shared<std::promise<SolveResult>>();
+    auto future = promise->get_future();
+
+    submit( [promise, board, options]( SolverContext& context )
+        {
+            try
+            {
+                promise->set_value( Sudoku::solve( board, options, context ) );
+            }
+            catch( ... )
+            {
+                promise->set_exception( std::current_exception() );
+            }
+        }, priority );
+
+    return future;
+}
+
+
+void Executor::solve( const Board& board, const SolveOptions& options, Callback callback, ErrorCallback onError, int priority )
+{
+    push( [callback, onError, board, options]( SolverContext& context )
+        {
+            // the worker swallows what a task throws, which would leave the
+            // caller waiting for a callback
+            try
+            {
+                callback( Sudoku::solve( board, options, context ) );
+            }
+            catch( ... )
+            {
+                onError( std::current_exception() );
+            }
+        }, onError, priority );
+}
+
+
+void Executor::push( Task task, ErrorCallback onDrop, int priority )
+{
+    std::unique_lock<std::mutex> lock( m_mutex );
+    m_notFull.wait( lock, [this]() { return m_stopping || m_queue.size() < m_capacity; } );
+    if( m_stopping )
+        throw std::runtime_error( "executor is stopping" );
+
+    m_queue.push( { priority, m_sequence++, std::move( task ), std::move( onDrop ) } );
+    lock.unlock();
+    m_notEmpty.notify_one();
+}
+
+
+Executor& Executor::shared()
+{
+    static Executor executor( std::max( 1u, std::thread::hardware_concurrency() ), 1024 );
+    return executor;
+}
+
+
+void Executor::work()
+{
+    SolverContext context;
+
+    for( ;; )
+    {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock( m_mutex );
+            m_notEmpty.wait( lock, [this]() { return m_stopping || !m_queue.empty(); } );
+            if( m_stopping )
+                return;
+
+            // top() is const, but the request is popped right away
+            task = std::move( const_cast< Request& >( m_queue.top() ).task );
+            m_queue.pop();
+        }
+        m_notFull.notify_one();
+
+        try
+        {
+            task( context );
+        }
+        catch( ... )
+        {
+            // a failing task must not take the worker down
+        }
+    }
+}
+
+
+std::future<SolveResult> Sudoku::solveAsync( const Board& board, const SolveOptions& options, int priority )
+{
+    return Executor::shared().solve( board, options, priority );
+}
+
+
+void Sudoku::solveAsync( const Board& board, const SolveOptions& options, Executor::Callback callback, Executor::ErrorCallback onError, int priority )
+{
+    Executor::shared().solve( board, options, std::move( callback ), std::move( onError ), priority );
+}
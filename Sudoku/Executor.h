@@ -0,0 +1,171 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "Board.h"
+#include "SolveOptions.h"
+#include "SolverContext.h"
+
+namespace Sudoku
+{
+
+/**
+* @brief Fixed-size pool of worker threads running solves from a bounded
+* priority queue. Each worker keeps its own SolverContext, so its scratch
+* memory is reused between requests.
+*/
+class Executor
+{
+public:
+    /**
+    * @brief A unit of work. It is called on a worker thread with that
+    * worker's solver context.
+    */
+    using Task = std::function<void( SolverContext& )>;
+    /**
+    * @brief Called on a worker thread with the outcome of an asynchronous solve.
+    */
+    using Callback = std::function<void( SolveResult )>;
+    /**
+    * @brief Called instead of the Callback when an asynchronous solve or its
+    * Callback throws, or when the solve is dropped by the executor stopping,
+    * with the exception.
+    */
+    using ErrorCallback = std::function<void( std::exception_ptr )>;
+
+    /**
+    * @brief Starts the worker threads.
+    * @param threads the number of worker threads, at least 1
+    * @param queueCapacity the maximum number of queued requests, at least 1
+    */
+    Executor( std::size_t threads, std::size_t queueCapacity );
+    /**
+    * @brief Stops the workers. Requests already running are completed, queued
+    * requests are dropped: their futures report std::future_errc::broken_promise
+    * and the error callbacks of callback solves are called on this thread with
+    * a std::runtime_error.
+    */
+    ~Executor();
+
+    Executor( const Executor& ) = delete;
+    Executor& operator=( const Executor& ) = delete;
+
+    /**
+    * @brief Queues a task, blocking while the queue is full.
+    * @param task the task to run
+    * @param priority requests with a higher priority are started first; requests
+    * with the same priority are started in submission order
+    */
+    void submit( Task task, int priority = 0 );
+    /**
+    * @brief Queues a task unless the queue is full.
+    * @param task the task to run
+    * @param priority the request priority, see submit()
+    * @return True if the task was queued, false if the queue was full.
+    */
+    bool trySubmit( Task task, int priority = 0 );
+    /**
+    * @brief Queues a solve, blocking while the queue is full.
+    * @param board the board to solve
+    * @param options the limits to apply to the solve
+    * @param priority the request priority, see submit()
+    * @return A future receiving the outcome of the solve.
+    */
+    std::future<SolveResult> solve( const Board& board, const SolveOptions& options = {}, int priority = 0 );
+    /**
+    * @brief Queues a solve, blocking while the queue is full.
+    * @param board the board to solve
+    * @param options the limits to apply to the solve
+    * @param callback called on the worker thread with the outcome of the solve
+    * @param onError called instead if the solve or the callback throws, or if
+    * the executor is destroyed before the solve starts
+    * @param priority the request priority, see submit()
+    */
+    void solve( const Board& board, const SolveOptions& options, Callback callback, ErrorCallback onError, int priority = 0 );
+
+    /**
+    * @brief Gets the number of worker threads.
+    * @return the number of worker threads.
+    */
+    std::size_t threads() const noexcept
+    {
+        return m_workers.size();
+    }
+    /**
+    * @brief Gets the executor shared by the library, with one worker per
+    * hardware thread. It is created on first use.
+    * @return the shared executor.
+    */
+    static Executor& shared();
+
+private:
+    /**
+    * @brief A queued task with its scheduling order.
+    */
+    struct Request
+    {
+        int priority;
+        std::uint64_t sequence;
+        Task task;
+        // called if the task is dropped, may be empty
+        ErrorCallback onDrop;
+
+        bool operator<( const Request& rhs ) const noexcept
+        {
+            // std::priority_queue pops the greatest element first
+            if( priority != rhs.priority )
+                return priority < rhs.priority;
+            return sequence > rhs.sequence;
+        }
+    };
+
+    std::size_t m_capacity;
+    std::uint64_t m_sequence = 0;
+    bool m_stopping = false;
+    std::priority_queue<Request> m_queue;
+    std::mutex m_mutex;
+    std::condition_variable m_notEmpty;
+    std::condition_variable m_notFull;
+    std::vector<std::thread> m_workers;
+
+    /**
+    * @brief Queues a request, blocking while the queue is full.
+    * @param task the task to run
+    * @param onDrop called instead if the executor is destroyed before the
+    * task starts, may be empty
+    * @param priority the request priority, see submit()
+    */
+    void push( Task task, ErrorCallback onDrop, int priority );
+    /**
+    * @brief Body of each worker thread.
+    */
+    void work();
+};
+
+/**
+* @brief Queues a solve on the shared executor.
+* @param board the board to solve
+* @param options the limits to apply to the solve
+* @param priority requests with a higher priority are started first
+* @return A future receiving the outcome of the solve.
+*/
+std::future<SolveResult> solveAsync( const Board& board, const SolveOptions& options = {}, int priority = 0 );
+/**
+* @brief Queues a solve on the shared executor.
+* @param board the board to solve
+* @param options the limits to apply to the solve
+* @param callback called on a worker thread with the outcome of the solve
+* @param onError called on a worker thread instead if the solve throws
+* @param priority requests with a higher priority are started first
+*/
+void solveAsync( const Board& board, const SolveOptions& options, Executor::Callback callback, Executor::ErrorCallback onError, int priority = 0 );
+
+} // namespace
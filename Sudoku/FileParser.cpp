@@ -1,47 +1,458 @@
-#include <iostream>
 #include <fstream>
-#include <array>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <algorithm>
 #include <stdexcept>
 
 #include "FileParser.h"
+#include "PerfCounters.h"
 
-Sudoku::Board Sudoku::parseFile( Num BlockSize, const std::string& filename )
+using Sudoku::Num;
+using Sudoku::Nums;
+using Sudoku::ParseError;
+using Sudoku::PerfCounters;
+using Sudoku::PerfScope;
+
+namespace
+{
+bool isSpace( char c ) noexcept
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+
+bool isDigit( char c ) noexcept
+{
+    return c >= '0' && c <= '9';
+}
+
+
+/**
+* @brief Reads the whitespace separated tokens of a board file from a buffer,
+* keeping the offset of each to report errors.
+*/
+class Tokenizer
+{
+public:
+    /**
+    * @param source names the buffer in error messages, e.g. the file it was read from
+    */
+    Tokenizer( const char* data, std::size_t size, const std::string& source ) noexcept :
+        m_begin( data ),
+        m_current( data ),
+        m_end( data + size ),
+        m_source( source )
+    {
+    }
+
+    /**
+    * @brief Skips whitespace up to the next token.
+    * @return False if there are no tokens left.
+    */
+    bool next() noexcept
+    {
+        while( m_current != m_end && isSpace( *m_current ) )
+        {
+            ++m_current;
+        }
+        return m_current != m_end;
+    }
+
+    /**
+    * @brief Reads a decimal number.
+    * @param what names the number in error messages
+    * @throw ParseError if the next token isn't a number
+    */
+    Num number( const char* what )
+    {
+        if( !next() )
+            fail( std::string( "expected " ) + what + ", found the end", offset() );
+
+        const auto start = offset();
+        Num value = 0;
+        for( ; m_current != m_end && isDigit( *m_current ); ++m_current )
+        {
+            const Num digit = *m_current - '0';
+            if( value > ( std::numeric_limits<Num>::max() - digit ) / 10 )
+                fail( std::string( what ) + " out of range", start );
+            value = value * 10 + digit;
+        }
+        if( offset() == start || ( m_current != m_end && !isSpace( *m_current ) ) )
+            fail( std::string( "invalid " ) + what, start );
+        return value;
+    }
+
+    /**
+    * @brief Reads a token, e.g. a keyword.
+    */
+    std::string word()
+    {
+        next();
+        const auto start = m_current;
+        while( m_current != m_end && !isSpace( *m_current ) )
+        {
+            ++m_current;
+        }
+        return { start, m_current };
+    }
+
+    std::size_t offset() const noexcept
+    {
+        return m_current - m_begin;
+    }
+
+    [[noreturn]] void fail( const std::string& message, std::size_t offset ) const
+    {
+        throw ParseError( m_source + ": " + message, offset );
+    }
+
+private:
+    const char* m_begin;
+    const char* m_current;
+    const char* m_end;
+    const std::string& m_source;
+};
+
+
+/**
+* @brief Reads the grid of values starting a board file, in row order.
+* @param limit the largest value allowed
+*/
+Nums readGrid( Tokenizer& tokens, Num BlockSize, Num limit )
+{
+    const auto Dims = BlockSize * BlockSize;
+    Nums values( Dims * Dims );
+    for( auto& value : values )
+    {
+        tokens.next();
+        const auto start = tokens.offset();
+        value = tokens.number( "value" );
+        if( value > limit )
+            tokens.fail( "invalid value " + std::to_string( value ), start );
+    }
+    return values;
+}
+
+
+/**
+* @brief Reads a (row, column) pair of a section.
+*/
+std::pair<Num, Num> readCell( Tokenizer& tokens )
+{
+    const auto row = tokens.number( "row" );
+    return { row, tokens.number( "column" ) };
+}
+
+
+/**
+* @brief Reads the sections of the layout following the values of a board file.
+*/
+Sudoku::Layout readLayout( Tokenizer& tokens, Num BlockSize )
+{
+    const auto Dims = BlockSize * BlockSize;
+    Sudoku::Layout layout( BlockSize );
+    while( tokens.next() )
+    {
+        const auto start = tokens.offset();
+        const auto section = tokens.word();
+        if( section == "regions" )
+        {
+            const auto regions = readGrid( tokens, BlockSize, Dims );
+            std::vector<Nums> rows( Dims );
+            for( Num row = 0; row < Dims; ++row )
+            {
+                rows[row].assign( regions.begin() + row * Dims, regions.begin() + ( row + 1 ) * Dims );
+            }
+            layout.setRegions( rows );
+        }
+        else if( section == "diagonals" )
+        {
+            layout.addDiagonals();
+        }
+        else if( section == "windows" )
+        {
+            layout.addWindows();
+        }
+        else if( section == "unit" )
+        {
+            std::vector<std::pair<Num, Num>> cells( Dims );
+            for( auto& cell : cells )
+            {
+                cell = readCell( tokens );
+            }
+            layout.addUnit( cells );
+        }
+        else if( section == "cage" )
+        {
+            const auto sum = tokens.number( "sum" );
+            tokens.next();
+            const auto sizeOffset = tokens.offset();
+            const auto size = tokens.number( "cage size" );
+            if( size > Dims )
+                tokens.fail( "invalid cage size " + std::to_string( size ), sizeOffset );
+            std::vector<std::pair<Num, Num>> cells( size );
+            for( auto& cell : cells )
+            {
+                cell = readCell( tokens );
+            }
+            layout.addCage( cells, sum );
+        }
+        else
+        {
+            tokens.fail( "unknown section " + section, start );
+        }
+    }
+    return layout;
+}
+
+
+/**
+* @brief Reads the board and layout of a board file from a buffer.
+*/
+Sudoku::Board readBoard( Num BlockSize, const char* data, std::size_t size, const std::string& source )
 {
-    std::ifstream filestream{ filename };
+    Tokenizer tokens( data, size, source );
+    Nums values;
+    Sudoku::Layout layout( BlockSize );
+    {
+        // building the board propagates, which is counted apart
+        PerfScope counters( PerfCounters::parsing() );
+        values = readGrid( tokens, BlockSize, BlockSize * BlockSize );
+        layout = readLayout( tokens, BlockSize );
+    }
+    if( layout.isStandard() )
+        return { BlockSize, values };
+    return { layout, values };
+}
+
+
+/**
+* @brief Reads a whole file.
+* @throw std::invalid_argument if the file can't be opened
+*/
+std::string readFile( const std::string& filename )
+{
+    std::ifstream filestream{ filename, std::ios::binary };
     if( !filestream.is_open() )
     {
         throw std::invalid_argument( "Can't open file " + filename );
     }
+    std::ostringstream contents;
+    contents << filestream.rdbuf();
+    return contents.str();
+}
 
-    auto Dims = BlockSize * BlockSize;
 
-    Board::InputArray values( Dims, Nums( Dims ) );
+bool isSeparator( char c ) noexcept
+{
+    return c == ' ' || c == '\t' || c == ',';
+}
 
-    decltype(Dims) i = 0;
-    decltype(Dims) j = 0;
 
-    while( i < Dims && !filestream.fail() )
+/**
+* @brief Calls a function with the value and offset of each cell of a board
+* in the compact line format.
+* @param base the offset of data in the line, added to the offsets
+* @throw ParseError if a cell isn't a valid value
+*/
+template<typename Func>
+void scanLine( const char* data, std::size_t size, std::size_t base, Func&& func )
+{
+    const auto end = data + size;
+    const bool separated = std::any_of( data, end, isSeparator );
+    const auto invalid = [data, base]( const char* at )
+        {
+            throw ParseError( std::string( "invalid cell value '" ) + *at + "'", base + ( at - data ) );
+        };
+
+    for( auto current = data; current != end; )
     {
-        int n;
-        filestream >> std::dec >> n;
-        values[i][j++] = static_cast< Num >( n );
+        if( !separated )
+        {
+            if( *current == '.' )
+                func( 0, base + ( current - data ) );
+            else if( isDigit( *current ) )
+                func( static_cast< Num >( *current - '0' ), base + ( current - data ) );
+            else if( *current != '\r' && *current != '\n' )
+                invalid( current );
+            ++current;
+            continue;
+        }
 
-        if( j == Dims )
+        if( isSpace( *current ) || *current == ',' )
         {
-            ++i;
-            j = 0;
+            ++current;
+            continue;
         }
+        const auto start = current;
+        Num value = 0;
+        for( ; current != end && isDigit( *current ); ++current )
+        {
+            const Num digit = *current - '0';
+            if( value > ( std::numeric_limits<Num>::max() - digit ) / 10 )
+                throw ParseError( "cell value out of range", base + ( start - data ) );
+            value = value * 10 + digit;
+        }
+        if( current != end && !isSpace( *current ) && *current != ',' )
+            invalid( current );
+        func( value, base + ( start - data ) );
+    }
+}
+
+
+/**
+* @brief Reads the cells of boards in the compact line format, in row order.
+* @param base the offset of data in the line, for error messages
+* @param boards the number of boards of the same size written one after another
+* @return the block size of the boards.
+* @throw ParseError if the line is not a valid board
+*/
+Num readLine( const char* data, std::size_t size, Nums& cells, std::size_t base = 0, Num boards = 1 )
+{
+    PerfScope counters( PerfCounters::parsing() );
+    cells.clear();
+    scanLine( data, size, base, [&cells]( Num value, std::size_t ) { cells.push_back( value ); } );
+
+    Num blockSize = 1;
+    while( boards * blockSize * blockSize * blockSize * blockSize < cells.size() )
+    {
+        ++blockSize;
+    }
+    if( cells.empty() || boards * blockSize * blockSize * blockSize * blockSize != cells.size() )
+    {
+        throw ParseError( "line has " + std::to_string( cells.size() ) + " cells, which is not a valid board size", base + size );
     }
 
-    if( filestream.fail() )
+    const auto Dims = blockSize * blockSize;
+    const auto invalid = std::find_if( cells.begin(), cells.end(), [Dims]( Num value ) { return value > Dims; } );
+    if( invalid != cells.end() )
     {
-        throw std::runtime_error( "Error parsing file: " + filename );
+        // only errors need the offsets, so they are found again
+        const std::size_t index = invalid - cells.begin();
+        std::size_t count = 0;
+        std::size_t offset = 0;
+        scanLine( data, size, base, [index, &count, &offset]( Num, std::size_t at )
+            {
+                if( count++ == index )
+                    offset = at;
+            } );
+        throw ParseError( "invalid value " + std::to_string( *invalid ), offset );
     }
+    return blockSize;
+}
+}
+
+
+ParseError::ParseError( const std::string& message, std::size_t offset ) :
+    std::runtime_error( message + " at offset " + std::to_string( offset ) ),
+    m_offset( offset )
+{
+}
+
+
+Sudoku::Board Sudoku::parseFile( Num BlockSize, const std::string& filename )
+{
+    const auto contents = readFile( filename );
+    return readBoard( BlockSize, contents.data(), contents.size(), filename );
+}
+
+
+Sudoku::Board Sudoku::parseBuffer( Num BlockSize, const char* data, std::size_t size )
+{
+    return readBoard( BlockSize, data, size, "buffer" );
+}
+
 
-    if( i < Dims )
+Sudoku::Board::InputArray Sudoku::parseFileValues( Num BlockSize, const std::string& filename )
+{
+    const auto contents = readFile( filename );
+    PerfScope counters( PerfCounters::parsing() );
+    Tokenizer tokens( contents.data(), contents.size(), filename );
+    const auto Dims = BlockSize * BlockSize;
+    const auto cells = readGrid( tokens, BlockSize, Dims );
+
+    Board::InputArray values( Dims );
+    for( Num i = 0; i < Dims; ++i )
+    {
+        values[i].assign( cells.begin() + i * Dims, cells.begin() + ( i + 1 ) * Dims );
+    }
+    return values;
+}
+
+
+Sudoku::Layout Sudoku::parseFileLayout( Num BlockSize, const std::string& filename )
+{
+    const auto contents = readFile( filename );
+    PerfScope counters( PerfCounters::parsing() );
+    Tokenizer tokens( contents.data(), contents.size(), filename );
+    readGrid( tokens, BlockSize, BlockSize * BlockSize );
+    return readLayout( tokens, BlockSize );
+}
+
+
+Sudoku::Board Sudoku::parseLine( const std::string& line )
+{
+    return parseLine( line.data(), line.size() );
+}
+
+
+Sudoku::Board Sudoku::parseLine( const char* data, std::size_t size )
+{
+    Nums cells;
+    const auto blockSize = readLine( data, size, cells );
+    try
+    {
+        return { blockSize, cells };
+    }
+    catch( const std::invalid_argument& ex )
+    {
+        throw std::runtime_error( ex.what() );
+    }
+}
+
+
+Sudoku::Board::InputArray Sudoku::parseLineValues( const std::string& line )
+{
+    Nums cells;
+    const auto blockSize = readLine( line.data(), line.size(), cells );
+
+    const auto Dims = blockSize * blockSize;
+    Board::InputArray values( Dims );
+    for( Num i = 0; i < Dims; ++i )
+    {
+        values[i].assign( cells.begin() + i * Dims, cells.begin() + ( i + 1 ) * Dims );
+    }
+    return values;
+}
+
+
+Num Sudoku::parseLineCells( const char* data, std::size_t size, Nums& cells )
+{
+    return readLine( data, size, cells );
+}
+
+
+Num Sudoku::parsePairLine( const char* data, std::size_t size, Nums& puzzle, Nums& solution )
+{
+    // two compact boards make two tokens, separated cells many more
+    const auto end = data + size;
+    const auto isBlank = []( char c ) { return isSeparator( c ) || c == '\r' || c == '\n'; };
+    const auto first = std::find_if_not( data, end, isBlank );
+    const auto firstEnd = std::find_if( first, end, isBlank );
+    const auto second = std::find_if_not( firstEnd, end, isBlank );
+    const auto secondEnd = std::find_if( second, end, isBlank );
+    if( second != end && std::find_if_not( secondEnd, end, isBlank ) == end )
     {
-        throw std::runtime_error( "file " + filename + " had incomplete board." );
+        const auto blockSize = readLine( first, firstEnd - first, puzzle, first - data );
+        if( readLine( second, secondEnd - second, solution, second - data ) != blockSize )
+            throw ParseError( "solution size differs from the puzzle's", second - data );
+        return blockSize;
     }
 
-    return { BlockSize, values };
+    const auto blockSize = readLine( data, size, puzzle, 0, 2 );
+    const auto cells = puzzle.size() / 2;
+    solution.assign( puzzle.begin() + cells, puzzle.end() );
+    puzzle.resize( cells );
+    return blockSize;
 }
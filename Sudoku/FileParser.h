@@ -1,4 +1,6 @@
 #pragma once
+#include <cstddef>
+#include <stdexcept>
 #include <string>
 
 #include "Board.h"
@@ -6,14 +8,132 @@
 namespace Sudoku
 {
 
+/**
+* @brief Error found while parsing a board, with where it was found.
+*/
+class ParseError : public std::runtime_error
+{
+public:
+    /**
+    * @param message what is wrong, the offset is appended to it
+    * @param offset the offset in bytes of the error from the start of the input
+    */
+    ParseError( const std::string& message, std::size_t offset );
+
+    std::size_t offset() const noexcept
+    {
+        return m_offset;
+    }
+
+private:
+    std::size_t m_offset;
+};
+
 /**
 * @brief Parses a file containing a representation of a board. Cells are separated
 * by whitespace and have values in the range [0, 9]. 0 denotes empty cells.
+* The board is a variant if the values are followed by sections of its layout,
+* see parseFileLayout.
 * @param filename the path to the file
 * @return A board with the values specified in the file
 * @throw std::invalid_argument The filename can't be opened for reading
-* @throw std::runtime_error An error occurred during parsing of the file.
+* @throw std::runtime_error An error occurred during parsing of the file, a
+* ParseError if the text itself is invalid.
 */
     Board parseFile( Num BlockSize, const std::string& filename );
 
+/**
+* @brief Parses a board in the format of parseFile from memory, e.g. as
+* received from a network or IPC front end. The values go straight into the
+* board, without iostreams or nested vectors.
+* @param data the text of the board, not necessarily null terminated
+* @param size the size of the text in bytes
+* @return A board with the values specified in the text
+* @throw ParseError The text is not a valid board, with the offset of the error.
+* @throw std::invalid_argument The values or layout sections are inconsistent.
+*/
+    Board parseBuffer( Num BlockSize, const char* data, std::size_t size );
+
+/**
+* @brief Parses a file like parseFile, without building a board, e.g. to keep
+* the clues apart from deduced values.
+* @param filename the path to the file
+* @return The values specified in the file, 0 denoting empty cells
+* @throw std::invalid_argument The filename can't be opened for reading
+* @throw std::runtime_error An error occurred during parsing of the file.
+*/
+    Board::InputArray parseFileValues( Num BlockSize, const std::string& filename );
+
+/**
+* @brief Parses the layout of the board in a file, given by sections after its
+* values. Each section starts with a keyword:
+* - "regions", then the region of each cell, from 1 to the dimension, in the
+* same format as the values: replaces the quadrants (jigsaw);
+* - "diagonals": adds the two main diagonals as units (X-Sudoku);
+* - "windows": adds the windoku windows as units;
+* - "unit", then the row and column of each of its cells, from 0: adds a unit;
+* - "cage", then its sum, its number of cells and the row and column of each
+* of them: adds a cage (killer sudoku).
+* A file without sections has the standard layout.
+* @param filename the path to the file
+* @return The layout of the board in the file
+* @throw std::invalid_argument The filename can't be opened for reading, or
+* a section doesn't describe valid units or cages
+* @throw std::runtime_error An error occurred during parsing of the file.
+*/
+    Layout parseFileLayout( Num BlockSize, const std::string& filename );
+
+/**
+* @brief Parses a board written in the compact line format: all cells in row
+* order on a single line. Boards of dimension up to 9 may write one character
+* per cell, with '0' or '.' denoting empty cells; any board may instead write
+* cells as numbers separated by whitespace or commas. The block size is
+* deduced from the number of cells.
+* @param line the board in compact line format
+* @return A board with the values specified in the line
+* @throw std::runtime_error The line is not a valid board, a ParseError if
+* its text is invalid.
+*/
+    Board parseLine( const std::string& line );
+
+/**
+* @brief Parses a board in the compact line format from memory, see
+* parseLine( const std::string& ).
+* @param data the line, not necessarily null terminated
+* @param size the size of the line in bytes
+*/
+    Board parseLine( const char* data, std::size_t size );
+
+/**
+* @brief Parses a board written in the compact line format, see parseLine,
+* without building a board, e.g. to keep the clues apart from deduced values.
+* @param line the board in compact line format
+* @return The values specified in the line, 0 denoting empty cells
+* @throw std::runtime_error The line is not a valid board.
+*/
+    Board::InputArray parseLineValues( const std::string& line );
+
+/**
+* @brief Parses a board in the compact line format from memory into an array,
+* without building a board, see parseLine( const std::string& ).
+* @param cells receives the cells in row order, 0 for empty cells
+* @return The block size of the board.
+* @throw ParseError The line is not a valid board.
+*/
+    Num parseLineCells( const char* data, std::size_t size, Nums& cells );
+
+/**
+* @brief Parses a puzzle and its solution from a line, without building
+* boards: either both in the compact line format with one character per cell,
+* separated by whitespace or a comma, or the cells of the puzzle then those of
+* the solution as separated numbers.
+* @param data the line, not necessarily null terminated
+* @param size the size of the line in bytes
+* @param puzzle receives the cells of the puzzle in row order
+* @param solution receives the cells of the solution in row order
+* @return The block size of the boards.
+* @throw ParseError The line is not a pair of boards of the same size.
+*/
+    Num parsePairLine( const char* data, std::size_t size, Nums& puzzle, Nums& solution );
+
 }
\ No newline at end of file
@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <numeric>
+
+#include "Generator.h"
+#include "Solver.h"
+
+using Sudoku::Generator;
+using Sudoku::GeneratedPuzzle;
+using Sudoku::Board;
+using Sudoku::Num;
+using Sudoku::Nums;
+
+namespace
+{
+/**
+* @brief Number of removals whose uniqueness is checked in parallel. It
+* doesn't depend on the number of threads, so neither do the puzzles.
+*/
+constexpr std::size_t BatchSize = 8;
+
+/**
+* @brief Checks if a board has exactly one solution, within the node budget.
+*/
+bool hasUniqueSolution( const Board& board, std::size_t maxNodes, Sudoku::SolverContext& context )
+{
+    Sudoku::SolveOptions options;
+    options.maxNodes = maxNodes;
+
+    const auto count = Sudoku::countSolutions( board, 2, options, context );
+    return count.solutions == 1 && count.status == Sudoku::SolveStatus::Unsolvable;
+}
+}
+
+Generator::Generator( const GeneratorOptions& options, Executor& executor ) :
+    m_options( options ),
+    m_executor( executor ),
+    m_random( options.seed ),
+    m_context( options.blockSize )
+{
+}
+
+
+Board Generator::fullGrid()
+{
+    SolveOptions options;
+    options.valueOrder = ValueOrder::Random;
+    options.seed = m_random();
+
+    return solve( Board( m_options.blockSize ), options, m_context ).board;
+}
+
+
+GeneratedPuzzle Generator::generate()
+{
+    const auto solution = fullGrid();
+    const auto blockSize = m_options.blockSize;
+    const auto dim = solution.dimension();
+
+    Board::InputArray clues( dim, Nums( dim ) );
+    for( Num i = 0; i < dim; ++i )
+    {
+        for( Num j = 0; j < dim; ++j )
+        {
+            clues[i][j] = solution.at( i, j );
+        }
+    }
+
+    // cells whose removal still has to be tried, in random order
+    Nums order( dim * dim );
+    std::iota( order.begin(), order.end(), static_cast< Num >( 0 ) );
+    std::shuffle( order.begin(), order.end(), m_random );
+    std::deque<Num> pending( order.begin(), order.end() );
+
+    Nums batch;
+    std::vector<char> unique;
+    std::mutex mutex;
+    std::condition_variable finished;
+
+    while( !pending.empty() )
+    {
+        const auto size = std::min<std::size_t>( BatchSize, pending.size() );
+        batch.assign( pending.begin(), pending.begin() + size );
+        pending.erase( pending.begin(), pending.begin() + size );
+        unique.assign( size, 0 );
+
+        // check each removal of the batch on its own, in parallel
+        std::size_t remaining = size;
+        for( std::size_t k = 0; k < size; ++k )
+        {
+            m_executor.submit( [&, k]( SolverContext& context )
+                {
+                    try
+                    {
+                        auto values = clues;
+                        values[batch[k] / dim][batch[k] % dim] = 0;
+                        unique[k] = hasUniqueSolution( Board( blockSize, values ), m_options.maxNodes, context );
+                    }
+                    catch( ... )
+                    {
+                        // the clue is kept
+                    }
+
+                    std::lock_guard<std::mutex> lock( mutex );
+                    if( --remaining == 0 )
+                        finished.notify_one();
+                } );
+        }
+        {
+            std::unique_lock<std::mutex> lock( mutex );
+            finished.wait( lock, [&remaining]() { return remaining == 0; } );
+        }
+
+        // Removing clues never makes a solution unique again, so a removal that
+        // failed on its own fails for good and its clue is kept. The removals
+        // that succeeded on their own may not succeed together: if they don't,
+        // only the first one is applied and the others are tried again later.
+        auto combined = clues;
+        std::size_t successes = 0;
+        for( std::size_t k = 0; k < size; ++k )
+        {
+            if( unique[k] )
+            {
+                combined[batch[k] / dim][batch[k] % dim] = 0;
+                ++successes;
+            }
+        }
+
+        if( successes == 0 )
+            continue;
+
+        if( successes == 1 || hasUniqueSolution( Board( blockSize, combined ), m_options.maxNodes, m_context ) )
+        {
+            clues = std::move( combined );
+            continue;
+        }
+
+        bool applied = false;
+        for( std::size_t k = 0; k < size; ++k )
+        {
+            if( !unique[k] )
+                continue;
+
+            if( !applied )
+            {
+                clues[batch[k] / dim][batch[k] % dim] = 0;
+                applied = true;
+            }
+            else
+            {
+                pending.push_back( batch[k] );
+            }
+        }
+    }
+
+    std::size_t count = 0;
+    for( const auto& row : clues )
+    {
+        count += static_cast< std::size_t >( std::count_if( row.begin(), row.end(), []( Num n ) { return n != 0; } ) );
+    }
+
+    return { Board( blockSize, clues ), solution, count, clues };
+}
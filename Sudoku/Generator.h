@@ -0,0 +1,82 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+#include "Board.h"
+#include "Executor.h"
+#include "SolverContext.h"
+
+namespace Sudoku
+{
+
+/**
+* @brief Settings of the puzzle generator.
+*/
+struct GeneratorOptions
+{
+    /**
+    * @brief Block size of the puzzles, e.g. 3 for 9x9 puzzles.
+    */
+    Num blockSize = 3;
+    /**
+    * @brief Seed of the generator. The same seed and node budget generate
+    * the same puzzles, whatever the number of threads.
+    */
+    std::uint64_t seed = 0;
+    /**
+    * @brief Node budget of each uniqueness check. A clue whose removal can't
+    * be proven to keep the solution unique within the budget is kept. 0 means
+    * no limit.
+    */
+    std::size_t maxNodes = 200;
+};
+
+/**
+* @brief A generated puzzle along with its unique solution. The puzzle board
+* holds the values deduced from the givens too, so use givens to print or rate it.
+*/
+struct GeneratedPuzzle
+{
+    Board puzzle;
+    Board solution;
+    std::size_t clues;
+    Board::InputArray givens;
+};
+
+/**
+* @brief Generates puzzles with a unique solution. A random full grid is built
+* by solving an empty board with a random value order, then clues are removed
+* for as long as the solution stays unique. The uniqueness checks of up to 8
+* candidate removals run in parallel on an executor.
+*/
+class Generator
+{
+public:
+    /**
+    * @brief Constructs a generator.
+    * @param options the generator settings
+    * @param executor the executor running the uniqueness checks. generate() waits
+    * for them, so it must not be called from one of the executor's own tasks.
+    */
+    Generator( const GeneratorOptions& options, Executor& executor );
+    /**
+    * @brief Builds a random completely filled valid board.
+    * @return the board.
+    */
+    Board fullGrid();
+    /**
+    * @brief Generates a puzzle whose clues can't be removed without losing
+    * the uniqueness of its solution (within the node budget).
+    * @return the puzzle and its solution.
+    */
+    GeneratedPuzzle generate();
+
+private:
+    GeneratorOptions m_options;
+    Executor& m_executor;
+    std::mt19937_64 m_random;
+    SolverContext m_context;
+};
+
+} // namespace
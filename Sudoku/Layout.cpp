@@ -0,0 +1,287 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "Layout.h"
+
+using Sudoku::Layout;
+using Sudoku::Num;
+using Sudoku::Nums;
+
+constexpr Num Layout::MaxMaskDimension;
+
+namespace
+{
+
+/**
+* @brief Appends every set of count distinct values from first to last adding
+* up to sum, as a mask with bit value - 1 set for each value.
+*/
+void addCombinations( std::vector<Layout::Mask>& combinations, Layout::Mask set, Num first, Num last, Num count, Num sum )
+{
+    if( count == 0 )
+    {
+        if( sum == 0 )
+            combinations.push_back( set );
+        return;
+    }
+    // the count smallest values left must fit in sum
+    for( Num value = first; value <= last && count * ( 2 * value + count - 1 ) / 2 <= sum; ++value )
+    {
+        addCombinations( combinations, set | Layout::Mask( 1 ) << ( value - 1 ), value + 1, last, count - 1, sum - value );
+    }
+}
+
+} // namespace
+
+Layout::Layout( Num blockSize ) :
+    m_blockSize( blockSize ),
+    m_dimension( blockSize * blockSize )
+{
+    const auto dim = m_dimension;
+    m_units.reserve( 3 * dim * dim );
+    for( Num row = 0; row < dim; ++row )
+    {
+        for( Num col = 0; col < dim; ++col )
+        {
+            m_units.push_back( row * dim + col );
+        }
+    }
+    for( Num col = 0; col < dim; ++col )
+    {
+        for( Num row = 0; row < dim; ++row )
+        {
+            m_units.push_back( row * dim + col );
+        }
+    }
+    // quadrant cells in row order
+    for( Num quadrant = 0; quadrant < dim; ++quadrant )
+    {
+        const auto top = quadrant / blockSize * blockSize;
+        const auto left = quadrant % blockSize * blockSize;
+        for( Num i = 0; i < dim; ++i )
+        {
+            m_units.push_back( ( top + i / blockSize ) * dim + left + i % blockSize );
+        }
+    }
+    index();
+}
+
+
+void Layout::setRegions( const std::vector<Nums>& regions )
+{
+    const auto dim = m_dimension;
+    if( regions.size() != dim )
+        throw std::invalid_argument( "regions must have " + std::to_string( dim ) + " rows" );
+
+    Nums units( dim * dim );
+    Nums sizes( dim );
+    for( Num row = 0; row < dim; ++row )
+    {
+        if( regions[row].size() != dim )
+            throw std::invalid_argument( "regions must have " + std::to_string( dim ) + " columns" );
+        for( Num col = 0; col < dim; ++col )
+        {
+            const auto region = regions[row][col];
+            if( region < 1 || region > dim )
+                throw std::invalid_argument( "invalid region " + std::to_string( region ) );
+            if( sizes[region - 1] == dim )
+                throw std::invalid_argument( "region " + std::to_string( region ) + " has too many cells" );
+            units[( region - 1 ) * dim + sizes[region - 1]++] = row * dim + col;
+        }
+    }
+
+    // every region is full once there are dim * dim cells and none overflowed
+    std::copy( units.begin(), units.end(), m_units.begin() + 2 * dim * dim );
+    m_standard = false;
+    index();
+}
+
+
+void Layout::addUnit( const std::vector<std::pair<Num, Num>>& cells )
+{
+    const auto dim = m_dimension;
+    if( cells.size() != dim )
+        throw std::invalid_argument( "a unit must have " + std::to_string( dim ) + " cells" );
+
+    Nums unit;
+    unit.reserve( dim );
+    for( const auto& cell : cells )
+    {
+        if( cell.first >= dim || cell.second >= dim )
+            throw std::invalid_argument( "unit cell out of the board" );
+        unit.push_back( cell.first * dim + cell.second );
+    }
+    auto sorted = unit;
+    std::sort( sorted.begin(), sorted.end() );
+    if( std::adjacent_find( sorted.begin(), sorted.end() ) != sorted.end() )
+        throw std::invalid_argument( "a unit can't have the same cell twice" );
+
+    m_units.insert( m_units.end(), unit.begin(), unit.end() );
+    m_standard = false;
+    index();
+}
+
+
+void Layout::addCage( const std::vector<std::pair<Num, Num>>& cells, Num sum )
+{
+    const auto dim = m_dimension;
+    if( dim > MaxMaskDimension )
+        throw std::invalid_argument( "cages need a dimension of at most " + std::to_string( MaxMaskDimension ) );
+    if( cells.empty() || cells.size() > dim )
+        throw std::invalid_argument( "a cage must have from 1 to " + std::to_string( dim ) + " cells" );
+
+    Nums cage;
+    cage.reserve( cells.size() );
+    for( const auto& cell : cells )
+    {
+        if( cell.first >= dim || cell.second >= dim )
+            throw std::invalid_argument( "cage cell out of the board" );
+        cage.push_back( cell.first * dim + cell.second );
+    }
+    auto sorted = cage;
+    std::sort( sorted.begin(), sorted.end() );
+    if( std::adjacent_find( sorted.begin(), sorted.end() ) != sorted.end() )
+        throw std::invalid_argument( "a cage can't have the same cell twice" );
+
+    const Num size = cage.size();
+    const auto same = std::find_if( m_cages.begin(), m_cages.end(), [size, sum]( const Cage& other ) { return other.size == size && other.sum == sum; } );
+    Cage added{ m_cageCells.size(), size, sum, m_combinations.size(), 0 };
+    if( same != m_cages.end() )
+    {
+        added.combinations = same->combinations;
+        added.combinationCount = same->combinationCount;
+    }
+    else
+    {
+        addCombinations( m_combinations, 0, 1, dim, size, sum );
+        added.combinationCount = m_combinations.size() - added.combinations;
+        if( added.combinationCount == 0 )
+            throw std::invalid_argument( "no " + std::to_string( size ) + " distinct values add up to " + std::to_string( sum ) );
+    }
+
+    m_cageCells.insert( m_cageCells.end(), cage.begin(), cage.end() );
+    m_cages.push_back( added );
+    m_standard = false;
+    index();
+}
+
+
+void Layout::addDiagonals()
+{
+    std::vector<std::pair<Num, Num>> main;
+    std::vector<std::pair<Num, Num>> anti;
+    for( Num i = 0; i < m_dimension; ++i )
+    {
+        main.emplace_back( i, i );
+        anti.emplace_back( i, m_dimension - 1 - i );
+    }
+    addUnit( main );
+    addUnit( anti );
+}
+
+
+void Layout::addWindows()
+{
+    if( m_blockSize < 3 )
+        return;
+
+    // windows start one cell in and leave a gap of one cell between them
+    for( Num top = 1; top + m_blockSize < m_dimension; top += m_blockSize + 1 )
+    {
+        for( Num left = 1; left + m_blockSize < m_dimension; left += m_blockSize + 1 )
+        {
+            std::vector<std::pair<Num, Num>> window;
+            for( Num i = 0; i < m_dimension; ++i )
+            {
+                window.emplace_back( top + i / m_blockSize, left + i % m_blockSize );
+            }
+            addUnit( window );
+        }
+    }
+}
+
+
+bool Layout::contains( std::size_t unit, Num cell ) const noexcept
+{
+    const auto range = memberships( cell );
+    return std::any_of( range.first, range.second, [unit]( const Membership& membership ) { return membership.unit == unit; } );
+}
+
+
+void Layout::index()
+{
+    const auto dim = m_dimension;
+    const auto cells = dim * dim;
+    const auto units = unitCount();
+
+    m_membershipStarts.assign( cells + 1, 0 );
+    for( auto cell : m_units )
+    {
+        ++m_membershipStarts[cell + 1];
+    }
+    for( Num cell = 0; cell < cells; ++cell )
+    {
+        m_membershipStarts[cell + 1] += m_membershipStarts[cell];
+    }
+    m_memberships.resize( m_units.size() );
+    auto next = m_membershipStarts;
+    for( std::size_t unit = 0; unit < units; ++unit )
+    {
+        for( Num position = 0; position < dim; ++position )
+        {
+            m_memberships[next[m_units[unit * dim + position]]++] = { unit, position };
+        }
+    }
+
+    m_cageMembershipStarts.assign( cells + 1, 0 );
+    for( auto cell : m_cageCells )
+    {
+        ++m_cageMembershipStarts[cell + 1];
+    }
+    for( Num cell = 0; cell < cells; ++cell )
+    {
+        m_cageMembershipStarts[cell + 1] += m_cageMembershipStarts[cell];
+    }
+    m_cageMemberships.resize( m_cageCells.size() );
+    next = m_cageMembershipStarts;
+    for( std::size_t cage = 0; cage < m_cages.size(); ++cage )
+    {
+        for( Num position = 0; position < m_cages[cage].size; ++position )
+        {
+            m_cageMemberships[next[m_cageCells[m_cages[cage].cells + position]]++] = { cage, position };
+        }
+    }
+
+    m_intersections.clear();
+    if( dim > MaxMaskDimension )
+        return;
+
+    // shared[unit * units + other] has the positions in unit of the cells
+    // shared with other
+    std::vector<Mask> shared( units * units );
+    std::vector<Num> counts( units * units );
+    for( Num cell = 0; cell < cells; ++cell )
+    {
+        const auto range = memberships( cell );
+        for( auto a = range.first; a != range.second; ++a )
+        {
+            for( auto b = range.first; b != range.second; ++b )
+            {
+                if( a != b )
+                {
+                    shared[a->unit * units + b->unit] |= Mask( 1 ) << a->position;
+                    ++counts[a->unit * units + b->unit];
+                }
+            }
+        }
+    }
+    for( std::size_t unit = 0; unit < units; ++unit )
+    {
+        for( std::size_t other = 0; other < units; ++other )
+        {
+            if( counts[unit * units + other] >= 2 )
+                m_intersections.push_back( { unit, other, shared[unit * units + other], shared[other * units + unit] } );
+        }
+    }
+}
@@ -0,0 +1,226 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "Common.h"
+
+namespace Sudoku
+{
+
+/**
+* @brief The units of a board: the groups of cells that must each hold every
+* value exactly once. A standard board has its rows, columns and quadrants;
+* variants replace the quadrants with irregular regions (jigsaw) or add
+* units (diagonals, windows, any other group of cells). The board propagates
+* and validates over the tables kept here, without knowing the variant.
+*
+* Units are numbered rows first, then columns, then regions, then the extra
+* units in the order they were added. A cell is numbered row * dimension +
+* column, and its position in a unit is its index in the unit's cell list.
+*
+* A layout may also have cages (killer sudoku): groups of cells whose values
+* don't repeat and add up to a sum.
+*/
+class Layout
+{
+public:
+    /**
+    * @brief A set of positions within a unit, one bit each.
+    */
+    using Mask = std::uint64_t;
+    /**
+    * @brief Largest dimension whose units fit in a Mask. Boards of larger
+    * layouts propagate without the techniques built on masks, and the layout
+    * doesn't compute its intersections.
+    */
+    static constexpr Num MaxMaskDimension = 64;
+
+    /**
+    * @brief A unit a cell belongs to, and the cell's position in it.
+    */
+    struct Membership
+    {
+        std::size_t unit;
+        Num position;
+    };
+
+    /**
+    * @brief Two units sharing at least two cells: a value only possible in
+    * the shared cells of one can't go in the other's remaining cells.
+    */
+    struct Intersection
+    {
+        std::size_t unit;
+        std::size_t other;
+        /**
+        * @brief The positions of the shared cells in unit.
+        */
+        Mask inUnit;
+        /**
+        * @brief The positions of the shared cells in other.
+        */
+        Mask inOther;
+    };
+
+    /**
+    * @brief A group of cells whose values differ and add up to sum. Its
+    * cells and the value sets it may hold are ranges of cageCells() and
+    * combinations().
+    */
+    struct Cage
+    {
+        std::size_t cells;
+        Num size;
+        Num sum;
+        std::size_t combinations;
+        std::size_t combinationCount;
+    };
+
+    /**
+    * @brief Constructs the layout of a standard board.
+    * @param blockSize the size of the quadrants, the board having
+    * blockSize * blockSize rows and columns
+    */
+    explicit Layout( Num blockSize );
+    /**
+    * @brief Replaces the quadrants with irregular regions.
+    * @param regions the region, from 1 to the dimension, of each cell in
+    * [row][column] order
+    * @throw std::invalid_argument if the array doesn't have the board's
+    * dimensions or a region doesn't have as many cells as the dimension
+    */
+    void setRegions( const std::vector<Nums>& regions );
+    /**
+    * @brief Adds a unit.
+    * @param cells the (row, column) of each cell of the unit
+    * @throw std::invalid_argument if the unit doesn't have as many distinct
+    * cells as the dimension, or one is out of the board
+    */
+    void addUnit( const std::vector<std::pair<Num, Num>>& cells );
+    /**
+    * @brief Adds the two main diagonals as units, for X-Sudoku.
+    */
+    void addDiagonals();
+    /**
+    * @brief Adds the quadrant sized windows set apart by one row and column
+    * from the edges and each other as units, for windoku. A board with a
+    * block size under 3 has none.
+    */
+    void addWindows();
+    /**
+    * @brief Adds a cage, and the table of the value sets it may hold if no
+    * cage of the same size and sum has it yet.
+    * @param cells the (row, column) of each cell of the cage
+    * @param sum the sum of the cage's values
+    * @throw std::invalid_argument if the cells repeat, one is out of the
+    * board, no set of distinct values adds up to sum, or the dimension is
+    * over MaxMaskDimension
+    */
+    void addCage( const std::vector<std::pair<Num, Num>>& cells, Num sum );
+
+    Num blockSize() const noexcept
+    {
+        return m_blockSize;
+    }
+    Num dimension() const noexcept
+    {
+        return m_dimension;
+    }
+    /**
+    * @brief Tells if the layout has just the rows, columns and quadrants.
+    */
+    bool isStandard() const noexcept
+    {
+        return m_standard;
+    }
+    std::size_t unitCount() const noexcept
+    {
+        return m_dimension == 0 ? 0 : m_units.size() / m_dimension;
+    }
+    /**
+    * @brief Gets the cells of a unit.
+    * @param unit the unit
+    * @return the dimension() cells of the unit.
+    */
+    const Num* unit( std::size_t unit ) const noexcept
+    {
+        return m_units.data() + unit * m_dimension;
+    }
+    /**
+    * @brief Gets the units a cell belongs to.
+    * @param cell the cell
+    * @return the range [first, second) of the cell's units.
+    */
+    std::pair<const Membership*, const Membership*> memberships( Num cell ) const noexcept
+    {
+        return { m_memberships.data() + m_membershipStarts[cell], m_memberships.data() + m_membershipStarts[cell + 1] };
+    }
+    const std::vector<Cage>& cages() const noexcept
+    {
+        return m_cages;
+    }
+    /**
+    * @brief Gets the cells of a cage.
+    * @return the size cells of the cage.
+    */
+    const Num* cageCells( const Cage& cage ) const noexcept
+    {
+        return m_cageCells.data() + cage.cells;
+    }
+    /**
+    * @brief Gets the sets of distinct values that add up to a cage's sum,
+    * as masks with bit value - 1 set for each value of the set.
+    * @return the combinationCount sets of the cage.
+    */
+    const Mask* combinations( const Cage& cage ) const noexcept
+    {
+        return m_combinations.data() + cage.combinations;
+    }
+    /**
+    * @brief Gets the cages a cell belongs to, with the cell's position in
+    * each. Membership::unit is then the index of the cage.
+    * @param cell the cell
+    * @return the range [first, second) of the cell's cages.
+    */
+    std::pair<const Membership*, const Membership*> cageMemberships( Num cell ) const noexcept
+    {
+        return { m_cageMemberships.data() + m_cageMembershipStarts[cell], m_cageMemberships.data() + m_cageMembershipStarts[cell + 1] };
+    }
+    /**
+    * @brief Tells if a cell belongs to a unit.
+    */
+    bool contains( std::size_t unit, Num cell ) const noexcept;
+    /**
+    * @brief Gets every ordered pair of units sharing at least two cells.
+    * Empty if the dimension is over MaxMaskDimension.
+    */
+    const std::vector<Intersection>& intersections() const noexcept
+    {
+        return m_intersections;
+    }
+
+private:
+    Num m_blockSize;
+    Num m_dimension;
+    bool m_standard = true;
+    // the cells of each unit, dimension() per unit
+    Nums m_units;
+    std::vector<Membership> m_memberships;
+    std::vector<std::size_t> m_membershipStarts;
+    std::vector<Intersection> m_intersections;
+    std::vector<Cage> m_cages;
+    Nums m_cageCells;
+    std::vector<Mask> m_combinations;
+    std::vector<Membership> m_cageMemberships;
+    std::vector<std::size_t> m_cageMembershipStarts;
+
+    /**
+    * @brief Computes the memberships and intersections from the units and
+    * cages.
+    */
+    void index();
+};
+
+} // namespace
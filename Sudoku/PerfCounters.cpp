@@ -0,0 +1,240 @@
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "PerfCounters.h"
+
+using Sudoku::PerfCounters;
+using Sudoku::PerfSample;
+
+std::atomic<bool> PerfCounters::s_enabled{ false };
+
+namespace
+{
+constexpr std::size_t EventCount = 5;
+
+// the count of each event in a sample, in the order of the events opened
+std::uint64_t PerfSample::* const Counts[EventCount] = {
+    &PerfSample::cycles, &PerfSample::instructions, &PerfSample::l1Misses, &PerfSample::llcMisses, &PerfSample::branchMisses
+};
+
+#ifdef __linux__
+struct EventType
+{
+    std::uint32_t type;
+    std::uint64_t config;
+};
+
+const EventType Events[EventCount] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | ( PERF_COUNT_HW_CACHE_OP_READ << 8 ) | ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 ) },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+};
+
+/**
+* @brief The counters of a thread, opened as a group so that they count over
+* the same time and are read with one system call.
+*/
+class Group
+{
+public:
+    Group()
+    {
+        for( std::size_t event = 0; event < EventCount; ++event )
+        {
+            perf_event_attr attr;
+            std::memset( &attr, 0, sizeof( attr ) );
+            attr.size = sizeof( attr );
+            attr.type = Events[event].type;
+            attr.config = Events[event].config;
+            attr.disabled = m_leader < 0 ? 1 : 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            // the calling thread, on any CPU
+            const int fd = static_cast< int >( syscall( SYS_perf_event_open, &attr, 0, -1, m_leader, 0 ) );
+            if( fd < 0 )
+            {
+                // a counter the processor lacks is left out, the others still count
+                if( m_reason.empty() )
+                    m_reason = std::string( "perf_event_open: " ) + std::strerror( errno );
+                continue;
+            }
+            if( m_leader < 0 )
+                m_leader = fd;
+            m_fds[m_count] = fd;
+            m_events[m_count++] = event;
+        }
+
+        if( m_leader >= 0 )
+        {
+            m_reason.clear();
+            ioctl( m_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP );
+            ioctl( m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP );
+        }
+    }
+    Group( const Group& ) = delete;
+    Group& operator=( const Group& ) = delete;
+    ~Group()
+    {
+        for( std::size_t i = 0; i < m_count; ++i )
+        {
+            close( m_fds[i] );
+        }
+    }
+
+    bool available() const noexcept
+    {
+        return m_leader >= 0;
+    }
+
+    const std::string& reason() const noexcept
+    {
+        return m_reason;
+    }
+
+    PerfSample read() const noexcept
+    {
+        PerfSample sample;
+        if( m_leader < 0 )
+            return sample;
+
+        // the number of counters, the times enabled and running, the counts
+        std::uint64_t values[3 + EventCount];
+        const auto expected = static_cast< ssize_t >( ( 3 + m_count ) * sizeof( std::uint64_t ) );
+        if( ::read( m_leader, values, sizeof( values ) ) < expected || values[2] == 0 )
+            return sample;
+
+        for( std::size_t i = 0; i < m_count; ++i )
+        {
+            // the counts are scaled up when the counters had to share the hardware
+            auto value = values[3 + i];
+            if( values[2] < values[1] )
+                value = static_cast< std::uint64_t >( static_cast< double >( value ) * values[1] / values[2] );
+            sample.*Counts[m_events[i]] = value;
+        }
+        return sample;
+    }
+
+private:
+    int m_leader = -1;
+    int m_fds[EventCount];
+    std::size_t m_events[EventCount];
+    std::size_t m_count = 0;
+    std::string m_reason;
+};
+#else
+class Group
+{
+public:
+    bool available() const noexcept
+    {
+        return false;
+    }
+
+    std::string reason() const
+    {
+        return "hardware counters are only read on Linux";
+    }
+
+    PerfSample read() const noexcept
+    {
+        return {};
+    }
+};
+#endif
+
+/**
+* @brief Gets the counters of the calling thread, opening them on first use.
+* @return nullptr if there is no memory to open them.
+*/
+const Group* threadGroup() noexcept
+{
+    try
+    {
+        thread_local Group group;
+        return &group;
+    }
+    catch( ... )
+    {
+        return nullptr;
+    }
+}
+}
+
+
+PerfSample& PerfSample::operator+=( const PerfSample& other ) noexcept
+{
+    for( std::size_t event = 0; event < EventCount; ++event )
+    {
+        this->*Counts[event] += other.*Counts[event];
+    }
+    return *this;
+}
+
+
+PerfSample& PerfSample::operator-=( const PerfSample& other ) noexcept
+{
+    for( std::size_t event = 0; event < EventCount; ++event )
+    {
+        this->*Counts[event] -= other.*Counts[event];
+    }
+    return *this;
+}
+
+
+void PerfCounters::enable() noexcept
+{
+    s_enabled.store( true, std::memory_order_relaxed );
+}
+
+
+void PerfCounters::disable() noexcept
+{
+    s_enabled.store( false, std::memory_order_relaxed );
+}
+
+
+bool PerfCounters::available( std::string* reason )
+{
+    const auto group = threadGroup();
+    if( !group )
+    {
+        if( reason )
+            *reason = "out of memory";
+        return false;
+    }
+    if( reason )
+        *reason = group->reason();
+    return group->available();
+}
+
+
+PerfSample PerfCounters::read() noexcept
+{
+    const auto group = threadGroup();
+    return group ? group->read() : PerfSample{};
+}
+
+
+PerfSample& PerfCounters::parsing() noexcept
+{
+    thread_local PerfSample sample;
+    return sample;
+}
+
+
+PerfSample& PerfCounters::propagation() noexcept
+{
+    thread_local PerfSample sample;
+    return sample;
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace Sudoku
+{
+
+/**
+* @brief Hardware event counts over a stretch of execution of a thread.
+* Events the processor or the system doesn't count stay at 0.
+*/
+struct PerfSample
+{
+    std::uint64_t cycles = 0;
+    std::uint64_t instructions = 0;
+    /**
+    * @brief Level 1 data cache read misses.
+    */
+    std::uint64_t l1Misses = 0;
+    /**
+    * @brief Last level cache misses.
+    */
+    std::uint64_t llcMisses = 0;
+    std::uint64_t branchMisses = 0;
+
+    PerfSample& operator+=( const PerfSample& other ) noexcept;
+    PerfSample& operator-=( const PerfSample& other ) noexcept;
+};
+
+inline PerfSample operator-( PerfSample left, const PerfSample& right ) noexcept
+{
+    return left -= right;
+}
+
+/**
+* @brief Per thread hardware performance counters, read with perf_event_open
+* on Linux, to tell whether a speedup comes from running fewer instructions or
+* from missing the caches less. Counting is off by default, and costs nothing
+* but a branch per phase then. Where the counters can't be opened, e.g. in a
+* container or on other systems, samples are all 0 and available() says why.
+* Reading the counters is a system call, which the counts leave out as they
+* only count user space.
+*/
+class PerfCounters
+{
+public:
+    /**
+    * @brief Starts counting the solves and their phases.
+    */
+    static void enable() noexcept;
+    static void disable() noexcept;
+    static bool enabled() noexcept
+    {
+        return s_enabled.load( std::memory_order_relaxed );
+    }
+    /**
+    * @brief Tells if the calling thread can count any event.
+    * @param reason if not null, receives why not
+    */
+    static bool available( std::string* reason = nullptr );
+    /**
+    * @brief Reads the counts of the calling thread since its counters were
+    * opened, opening them on first use.
+    */
+    static PerfSample read() noexcept;
+    /**
+    * @brief Gets the counts the calling thread spent parsing boards so far,
+    * while counting was enabled.
+    */
+    static PerfSample& parsing() noexcept;
+    /**
+    * @brief Gets the counts the calling thread spent propagating so far, while
+    * counting was enabled.
+    */
+    static PerfSample& propagation() noexcept;
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+/**
+* @brief Adds the counts of a scope to a sample, if counting when the scope
+* starts.
+*/
+class PerfScope
+{
+public:
+    explicit PerfScope( PerfSample& total ) noexcept :
+        m_total( PerfCounters::enabled() ? &total : nullptr )
+    {
+        if( m_total )
+            m_start = PerfCounters::read();
+    }
+    PerfScope( const PerfScope& ) = delete;
+    PerfScope& operator=( const PerfScope& ) = delete;
+    ~PerfScope()
+    {
+        if( m_total )
+        {
+            auto counts = PerfCounters::read();
+            counts -= m_start;
+            *m_total += counts;
+        }
+    }
+
+private:
+    PerfSample* m_total;
+    PerfSample m_start;
+};
+
+} // namespace
@@ -0,0 +1,223 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include "Portfolio.h"
+#include "Solver.h"
+
+using Sudoku::Board;
+using Sudoku::Configuration;
+using Sudoku::Engine;
+using Sudoku::PortfolioResult;
+using Sudoku::SharedTranspositionTable;
+using Sudoku::SolveOptions;
+using Sudoku::SolveResult;
+using Sudoku::SolveStatus;
+
+namespace
+{
+/**
+* @brief How often the race checks if the caller cancelled it.
+*/
+constexpr std::chrono::milliseconds PollInterval( 10 );
+
+SolveResult run( const Configuration& configuration, Board& board, const Board::InputArray& givens, SolveOptions options )
+{
+    // the givens are read from the propagated board, which repeats values
+    // once the propagation met a contradiction
+    if( configuration.engine != Engine::Search && !board.isValid() )
+        return SolveResult{ SolveStatus::Unsolvable, board, {} };
+
+    options.valueOrder = configuration.valueOrder;
+    options.seed = configuration.seed;
+    switch( configuration.engine )
+    {
+    case Engine::Anneal:
+        return Sudoku::anneal( givens, options, configuration.annealOptions );
+    case Engine::Learn:
+        return Sudoku::learn( givens, options, configuration.learnOptions );
+    case Engine::Search:
+        break;
+    }
+    return Sudoku::solve( board, options );
+}
+}
+
+std::string Sudoku::toString( const Configuration& configuration )
+{
+    std::string name;
+    switch( configuration.engine )
+    {
+    case Engine::Search:
+        name = "search";
+        break;
+    case Engine::Anneal:
+        // annealing has no value order
+        return "anneal/seed=" + std::to_string( configuration.seed );
+    case Engine::Learn:
+        name = "learn";
+        break;
+    }
+
+    switch( configuration.valueOrder )
+    {
+    case ValueOrder::Ascending:
+        return name + "/ascending";
+    case ValueOrder::Random:
+        break;
+    case ValueOrder::LeastConstraining:
+        return name + "/lcv";
+    case ValueOrder::History:
+        return name + "/history";
+    }
+    return name + "/random/seed=" + std::to_string( configuration.seed );
+}
+
+
+std::vector<Configuration> Sudoku::defaultPortfolio( std::size_t count, std::uint64_t seed )
+{
+    std::vector<Configuration> configurations( count );
+    for( std::size_t i = 0; i < count; ++i )
+    {
+        auto& configuration = configurations[i];
+        configuration.seed = seed + i;
+        if( i == 1 )
+        {
+            configuration.engine = Engine::Learn;
+        }
+        else if( i == 2 )
+        {
+            configuration.engine = Engine::Anneal;
+        }
+        else if( i == 3 )
+        {
+            configuration.valueOrder = ValueOrder::History;
+        }
+        else if( i == 4 )
+        {
+            configuration.valueOrder = ValueOrder::LeastConstraining;
+        }
+        else if( i > 4 )
+        {
+            configuration.engine = i % 2 ? Engine::Search : Engine::Learn;
+            configuration.valueOrder = ValueOrder::Random;
+        }
+    }
+    return configurations;
+}
+
+
+PortfolioResult Sudoku::solvePortfolio( const Board& board, const SolveOptions& options, const std::vector<Configuration>& configurations )
+{
+    if( configurations.empty() )
+        throw std::invalid_argument( "a portfolio needs at least one configuration" );
+
+    const auto start = SolveOptions::Clock::now();
+    const auto dim = board.dimension();
+    Board::InputArray givens( dim, Nums( dim ) );
+    for( Num i = 0; i < dim; ++i )
+    {
+        for( Num j = 0; j < dim; ++j )
+        {
+            givens[i][j] = board.at( i, j );
+        }
+    }
+
+    // the race has its own token, so that the winner can stop the others
+    // without cancelling the caller's other solves
+    auto raceOptions = options;
+    raceOptions.cancellation = CancellationToken();
+    auto race = raceOptions.cancellation;
+
+    // the searches skip the states another one already took
+    const auto searches = static_cast< std::size_t >( std::count_if( configurations.begin(), configurations.end(),
+        []( const Configuration& configuration ) { return configuration.engine == Engine::Search; } ) );
+    if( searches > 1 )
+        raceOptions.sharedStates = std::make_shared<SharedTranspositionTable>();
+    std::size_t exhausted = 0;
+
+    const auto count = configurations.size();
+    std::vector<SolveResult> results( count, SolveResult{ SolveStatus::Cancelled, board, {} } );
+    std::vector<std::exception_ptr> errors( count );
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::size_t running = count;
+    std::size_t winner = count;
+
+    std::vector<std::thread> threads;
+    threads.reserve( count );
+    for( std::size_t i = 0; i < count; ++i )
+    {
+        threads.emplace_back( [&, i]( Board copy )
+            {
+                SolveResult result{ SolveStatus::Cancelled, copy, {} };
+                std::exception_ptr error;
+                try
+                {
+                    result = run( configurations[i], copy, givens, raceOptions );
+                }
+                catch( ... )
+                {
+                    error = std::current_exception();
+                }
+
+                std::lock_guard<std::mutex> lock( mutex );
+                results[i] = std::move( result );
+                errors[i] = error;
+                auto conclusive = results[i].status == SolveStatus::Solved || results[i].status == SolveStatus::Unsolvable;
+                if( raceOptions.sharedStates && configurations[i].engine == Engine::Search &&
+                    results[i].status == SolveStatus::Unsolvable )
+                {
+                    // the other searches may still be exploring states this
+                    // one skipped
+                    conclusive = ++exhausted == searches;
+                }
+                if( ( conclusive || error ) && winner == count )
+                {
+                    winner = i;
+                    race.cancel();
+                }
+                --running;
+                finished.notify_one();
+            }, board );
+    }
+
+    {
+        std::unique_lock<std::mutex> lock( mutex );
+        while( running > 0 )
+        {
+            finished.wait_for( lock, PollInterval );
+            if( options.cancellation.cancelled() )
+                race.cancel();
+        }
+    }
+    for( auto& thread : threads )
+    {
+        thread.join();
+    }
+
+    if( winner != count && errors[winner] )
+        std::rethrow_exception( errors[winner] );
+
+    // with no conclusive outcome, report a limit one of them reached: a
+    // search sharing the states may have run out of them only because the
+    // others took them
+    auto reported = winner;
+    if( winner == count )
+    {
+        reported = static_cast< std::size_t >( std::find_if( results.begin(), results.end(),
+            []( const SolveResult& result ) { return result.status != SolveStatus::Unsolvable; } ) - results.begin() );
+    }
+    PortfolioResult portfolio{ reported < count ? results[reported] : SolveResult{ SolveStatus::Cancelled, board, {} }, winner };
+    for( const auto& result : results )
+    {
+        portfolio.sharedHits += result.stats.sharedHits;
+        portfolio.sharedCollisions += result.stats.sharedCollisions;
+    }
+    portfolio.result.stats.elapsed = SolveOptions::Clock::now() - start;
+    return portfolio;
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Annealer.h"
+#include "Board.h"
+#include "ClauseLearner.h"
+#include "SolveOptions.h"
+
+namespace Sudoku
+{
+
+/**
+* @brief The algorithms a puzzle can be solved with.
+*/
+enum class Engine
+{
+    /**
+    * @brief Backtracking search, see solve().
+    */
+    Search,
+    /**
+    * @brief Simulated annealing, see anneal().
+    */
+    Anneal,
+    /**
+    * @brief Conflict-driven clause learning, see learn().
+    */
+    Learn
+};
+
+/**
+* @brief One way of solving a puzzle: an engine and its heuristics.
+*/
+struct Configuration
+{
+    Engine engine = Engine::Search;
+    /**
+    * @brief For the search, the order of the values tried. For clause
+    * learning, Random shuffles the initial branching order.
+    */
+    ValueOrder valueOrder = ValueOrder::Ascending;
+    std::uint64_t seed = 0;
+    AnnealOptions annealOptions;
+    LearnOptions learnOptions;
+};
+
+/**
+* @brief Describes a configuration, e.g. "search/lcv" or "learn/random/seed=3".
+*/
+std::string toString( const Configuration& configuration );
+
+/**
+* @brief Returns a portfolio of count configurations meant to complement each
+* other: the search, clause learning and annealing with their default
+* heuristics first, the search with the history and least constraining value
+* orders next, then the search and clause learning in turn with random orders
+* seeded from seed.
+*/
+std::vector<Configuration> defaultPortfolio( std::size_t count, std::uint64_t seed = 0 );
+
+/**
+* @brief Outcome of solvePortfolio().
+*/
+struct PortfolioResult
+{
+    /**
+    * @brief The result of the winning configuration, or of the first one if
+    * none finished.
+    */
+    SolveResult result;
+    /**
+    * @brief Index of the winning configuration, or the number of
+    * configurations if none finished before its limits.
+    */
+    std::size_t winner;
+    /**
+    * @brief The probes of the visited states shared by the searches, summed
+    * over them, see SolveStats. Zero unless there are several searches.
+    */
+    std::size_t sharedHits = 0;
+    std::size_t sharedCollisions = 0;
+};
+
+/**
+* @brief Solves a board with every configuration at once, each on its own
+* thread, and returns the first result telling if the board has a solution.
+* The other solves are cancelled as soon as it is known.
+*
+* The limits of the options apply to each configuration, in the unit of its
+* engine for SolveOptions::maxNodes. Their value order and seed are replaced
+* by those of the configurations. When there are several searches, they share
+* their visited states, and the last of them to be exhausted proves that the
+* board has no solution.
+*
+* @param board the board to solve
+* @param options the limits to apply to the solves
+* @param configurations the configurations racing, at least one
+* @return The winning result along with the configuration that found it. Its
+* statistics are those of the winner, except for the elapsed time of the race.
+* @throw std::invalid_argument if there are no configurations. A configuration
+* failing first has its exception rethrown.
+*/
+PortfolioResult solvePortfolio( const Board& board, const SolveOptions& options, const std::vector<Configuration>& configurations );
+
+} // namespace
@@ -0,0 +1,645 @@
+#include <bitset>
+#include <stdexcept>
+#include <string>
+
+#include "Rater.h"
+#include "Utils.h"
+
+using Sudoku::Rater;
+using Sudoku::Rating;
+using Sudoku::Technique;
+using Sudoku::Num;
+
+namespace
+{
+using Mask = std::uint64_t;
+
+std::size_t bitCount( Mask mask ) noexcept
+{
+    return std::bitset<64>( mask ).count();
+}
+
+std::size_t lowestBit( Mask mask ) noexcept
+{
+    std::size_t index = 0;
+    while( !( mask & 1 ) )
+    {
+        mask >>= 1;
+        ++index;
+    }
+    return index;
+}
+
+/**
+* @brief Advances indices to the next combination of indices.size() elements
+* out of n, in lexicographic order.
+* @return false once all combinations have been visited.
+*/
+bool nextCombination( std::size_t* indices, std::size_t size, std::size_t n ) noexcept
+{
+    std::size_t i = size;
+    while( i > 0 && indices[i - 1] == n - size + i - 1 )
+    {
+        --i;
+    }
+    if( i == 0 )
+        return false;
+
+    ++indices[i - 1];
+    for( auto j = i; j < size; ++j )
+    {
+        indices[j] = indices[j - 1] + 1;
+    }
+    return true;
+}
+
+constexpr std::size_t MaxSubset = 4;
+}
+
+const char* Sudoku::toString( Technique technique ) noexcept
+{
+    switch( technique )
+    {
+    case Technique::HiddenSingle: return "Hidden single";
+    case Technique::NakedSingle: return "Naked single";
+    case Technique::Pointing: return "Pointing";
+    case Technique::Claiming: return "Claiming";
+    case Technique::NakedPair: return "Naked pair";
+    case Technique::XWing: return "X-wing";
+    case Technique::HiddenPair: return "Hidden pair";
+    case Technique::NakedTriple: return "Naked triple";
+    case Technique::HiddenTriple: return "Hidden triple";
+    case Technique::NakedQuad: return "Naked quad";
+    case Technique::Search: return "Search";
+    default: return "Unknown";
+    }
+}
+
+double Sudoku::weight( Technique technique ) noexcept
+{
+    switch( technique )
+    {
+    case Technique::HiddenSingle: return 1.5;
+    case Technique::NakedSingle: return 2.3;
+    case Technique::Pointing: return 2.6;
+    case Technique::Claiming: return 2.8;
+    case Technique::NakedPair: return 3.0;
+    case Technique::XWing: return 3.2;
+    case Technique::HiddenPair: return 3.4;
+    case Technique::NakedTriple: return 3.6;
+    case Technique::HiddenTriple: return 4.0;
+    case Technique::NakedQuad: return 5.0;
+    default: return 10.0;
+    }
+}
+
+
+Rating Rater::rate( const Board::InputArray& clues )
+{
+    const auto dim = static_cast< Num >( clues.size() );
+    Num blockSide = 1;
+    while( blockSide * blockSide < dim )
+    {
+        ++blockSide;
+    }
+    if( dim == 0 || blockSide * blockSide != dim || dim > 64 )
+        throw std::invalid_argument( "unsupported board dimension: " + std::to_string( dim ) );
+
+    if( blockSide != m_blockSide )
+        prepare( blockSide );
+
+    const Mask all = dim == 64 ? ~Mask( 0 ) : ( Mask( 1 ) << dim ) - 1;
+    m_candidates.assign( dim * dim, all );
+    m_values.assign( dim * dim, 0 );
+    m_dirty.assign( 3 * dim, ~std::uint32_t( 0 ) );
+    m_singles.clear();
+    m_unsolved = dim * dim;
+    m_broken = false;
+
+    for( Num i = 0; i < dim; ++i )
+    {
+        if( clues[i].size() != dim )
+            throw std::invalid_argument( "clues are not a square board" );
+
+        for( Num j = 0; j < dim; ++j )
+        {
+            const auto value = clues[i][j];
+            checkValue( dim, value );
+            if( value == 0 )
+                continue;
+
+            // a clue that is no longer a candidate repeats an earlier clue
+            if( m_candidates[i * dim + j] & ( Mask( 1 ) << ( value - 1 ) ) )
+                place( i * dim + j, value );
+            else
+                m_broken = true;
+        }
+    }
+
+    Rating rating;
+    double effort = 0;
+    while( !m_broken && m_unsolved > 0 )
+    {
+        auto technique = Technique::HiddenSingle;
+        while( technique != Technique::Search && !apply( technique ) && !m_broken )
+        {
+            technique = static_cast< Technique >( static_cast< std::size_t >( technique ) + 1 );
+        }
+        if( m_broken )
+            break;
+
+        ++rating.histogram[static_cast< std::size_t >( technique )];
+        if( technique > rating.hardest )
+            rating.hardest = technique;
+        if( technique > Technique::NakedSingle )
+            effort += weight( technique );
+        if( technique == Technique::Search )
+            break;
+    }
+
+    rating.solved = !m_broken && m_unsolved == 0;
+    if( !rating.solved )
+        rating.hardest = Technique::Search;
+    rating.grade = weight( rating.hardest ) + effort / 100;
+    return rating;
+}
+
+
+void Rater::prepare( Num blockSide )
+{
+    const auto dim = blockSide * blockSide;
+    m_blockSide = blockSide;
+    m_dimension = dim;
+
+    m_unitCells.resize( 3 * dim * dim );
+    m_cellUnits.resize( 3 * dim * dim );
+    for( Num unit = 0; unit < dim; ++unit )
+    {
+        const auto top = unit / blockSide * blockSide;
+        const auto left = unit % blockSide * blockSide;
+        for( Num k = 0; k < dim; ++k )
+        {
+            m_unitCells[unit * dim + k] = unit * dim + k;
+            m_unitCells[( dim + unit ) * dim + k] = k * dim + unit;
+            m_unitCells[( 2 * dim + unit ) * dim + k] = ( top + k / blockSide ) * dim + left + k % blockSide;
+        }
+    }
+    for( Num cell = 0; cell < dim * dim; ++cell )
+    {
+        const auto row = cell / dim;
+        const auto col = cell % dim;
+        m_cellUnits[cell * 3] = row;
+        m_cellUnits[cell * 3 + 1] = dim + col;
+        m_cellUnits[cell * 3 + 2] = 2 * dim + row / blockSide * blockSide + col / blockSide;
+    }
+
+    m_singles.reserve( dim * dim );
+    m_subset.reserve( dim );
+    m_positions.resize( dim );
+}
+
+
+void Rater::place( std::size_t cell, Num value )
+{
+    const Mask bit = Mask( 1 ) << ( value - 1 );
+    m_values[cell] = value;
+    m_candidates[cell] = bit;
+    --m_unsolved;
+
+    for( std::size_t u = 0; u < 3; ++u )
+    {
+        const auto unit = m_cellUnits[cell * 3 + u];
+        m_dirty[unit] = ~std::uint32_t( 0 );
+        for( std::size_t k = 0; k < m_dimension; ++k )
+        {
+            const auto peer = unitCell( unit, k );
+            if( !m_values[peer] )
+                eliminate( peer, bit );
+        }
+    }
+}
+
+
+bool Rater::eliminate( std::size_t cell, Mask mask )
+{
+    if( !( m_candidates[cell] & mask ) )
+        return false;
+
+    m_candidates[cell] &= ~mask;
+    for( std::size_t u = 0; u < 3; ++u )
+    {
+        m_dirty[m_cellUnits[cell * 3 + u]] = ~std::uint32_t( 0 );
+    }
+
+    const auto left = m_candidates[cell];
+    if( left == 0 )
+        m_broken = true;
+    else if( !( left & ( left - 1 ) ) )
+        m_singles.push_back( cell );
+    return true;
+}
+
+
+bool Rater::takeDirty( std::size_t unit, Technique technique ) noexcept
+{
+    const auto bit = std::uint32_t( 1 ) << static_cast< std::size_t >( technique );
+    if( !( m_dirty[unit] & bit ) )
+        return false;
+
+    m_dirty[unit] &= ~bit;
+    return true;
+}
+
+
+bool Rater::hiddenSingle()
+{
+    const Mask all = m_dimension == 64 ? ~Mask( 0 ) : ( Mask( 1 ) << m_dimension ) - 1;
+
+    for( std::size_t unit = 0; unit < 3 * m_dimension; ++unit )
+    {
+        if( !takeDirty( unit, Technique::HiddenSingle ) )
+            continue;
+
+        Mask once = 0, twice = 0, placed = 0;
+        for( std::size_t k = 0; k < m_dimension; ++k )
+        {
+            const auto cell = unitCell( unit, k );
+            const auto mask = m_candidates[cell];
+            if( m_values[cell] )
+            {
+                placed |= mask;
+            }
+            else
+            {
+                twice |= once & mask;
+                once |= mask;
+            }
+        }
+
+        if( ( once | placed ) != all )
+        {
+            // a value has no place left in the unit
+            m_broken = true;
+            return false;
+        }
+
+        const auto hidden = once & ~twice & ~placed;
+        if( !hidden )
+            continue;
+
+        const auto value = lowestBit( hidden );
+        for( std::size_t k = 0; k < m_dimension; ++k )
+        {
+            const auto cell = unitCell( unit, k );
+            if( !m_values[cell] && ( m_candidates[cell] >> value & 1 ) )
+            {
+                place( cell, value + 1 );
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+
+bool Rater::nakedSingle()
+{
+    while( !m_singles.empty() )
+    {
+        const auto cell = m_singles.back();
+        m_singles.pop_back();
+        if( !m_values[cell] )
+        {
+            place( cell, lowestBit( m_candidates[cell] ) + 1 );
+            return true;
+        }
+    }
+    return false;
+}
+
+
+bool Rater::pointing()
+{
+    const auto dim = m_dimension;
+    const auto side = m_blockSide;
+
+    for( std::size_t box = 0; box < dim; ++box )
+    {
+        const auto unit = 2 * dim + box;
+        if( !takeDirty( unit, Technique::Pointing ) )
+            continue;
+
+        for( std::size_t value = 0; value < dim; ++value )
+        {
+            const Mask bit = Mask( 1 ) << value;
+            Mask rows = 0, cols = 0;
+            bool placed = false;
+            for( std::size_t k = 0; k < dim && !placed; ++k )
+            {
+                const auto cell = unitCell( unit, k );
+                if( !( m_candidates[cell] & bit ) )
+                    continue;
+
+                placed = m_values[cell] != 0;
+                rows |= Mask( 1 ) << ( k / side );
+                cols |= Mask( 1 ) << ( k % side );
+            }
+            if( placed || !rows )
+                continue;
+
+            // the value is confined to one line of the box: the rest of the line can't have it
+            bool progress = false;
+            if( bitCount( rows ) == 1 )
+            {
+                const auto line = box / side * side + lowestBit( rows );
+                for( std::size_t k = 0; k < dim; ++k )
+                {
+                    const auto cell = unitCell( line, k );
+                    if( k / side != box % side && !m_values[cell] )
+                        progress |= eliminate( cell, bit );
+                }
+            }
+            if( bitCount( cols ) == 1 )
+            {
+                const auto line = dim + box % side * side + lowestBit( cols );
+                for( std::size_t k = 0; k < dim; ++k )
+                {
+                    const auto cell = unitCell( line, k );
+                    if( k / side != box / side && !m_values[cell] )
+                        progress |= eliminate( cell, bit );
+                }
+            }
+
+            if( progress )
+            {
+                // other values of the box may still point
+                m_dirty[unit] |= std::uint32_t( 1 ) << static_cast< std::size_t >( Technique::Pointing );
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+
+bool Rater::claiming()
+{
+    const auto dim = m_dimension;
+
+    for( std::size_t unit = 0; unit < 2 * dim; ++unit )
+    {
+        if( !takeDirty( unit, Technique::Claiming ) )
+            continue;
+
+        const auto lineKind = unit < dim ? 0 : 1;
+        for( std::size_t value = 0; value < dim; ++value )
+        {
+            const Mask bit = Mask( 1 ) << value;
+            std::size_t box = 3 * dim;
+            bool single = true;
+            for( std::size_t k = 0; k < dim && single; ++k )
+            {
+                const auto cell = unitCell( unit, k );
+                if( !( m_candidates[cell] & bit ) )
+                    continue;
+
+                const auto cellBox = m_cellUnits[cell * 3 + 2];
+                single = !m_values[cell] && ( box == 3 * dim || box == cellBox );
+                box = cellBox;
+            }
+            if( !single || box == 3 * dim )
+                continue;
+
+            // the value is confined to one box of the line: the rest of the box can't have it
+            bool progress = false;
+            for( std::size_t k = 0; k < dim; ++k )
+            {
+                const auto cell = unitCell( box, k );
+                if( m_cellUnits[cell * 3 + lineKind] != unit && !m_values[cell] )
+                    progress |= eliminate( cell, bit );
+            }
+
+            if( progress )
+            {
+                m_dirty[unit] |= std::uint32_t( 1 ) << static_cast< std::size_t >( Technique::Claiming );
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+
+bool Rater::nakedSubset( std::size_t size, Technique technique )
+{
+    std::size_t indices[MaxSubset];
+
+    for( std::size_t unit = 0; unit < 3 * m_dimension; ++unit )
+    {
+        if( !takeDirty( unit, technique ) )
+            continue;
+
+        m_subset.clear();
+        std::size_t unsolved = 0;
+        for( std::size_t k = 0; k < m_dimension; ++k )
+        {
+            const auto cell = unitCell( unit, k );
+            if( m_values[cell] )
+                continue;
+
+            ++unsolved;
+            if( bitCount( m_candidates[cell] ) <= size )
+                m_subset.push_back( cell );
+        }
+        if( m_subset.size() < size || unsolved <= size )
+            continue;
+
+        for( std::size_t i = 0; i < size; ++i )
+        {
+            indices[i] = i;
+        }
+        do
+        {
+            Mask values = 0;
+            for( std::size_t i = 0; i < size; ++i )
+            {
+                values |= m_candidates[m_subset[indices[i]]];
+            }
+            if( bitCount( values ) != size )
+                continue;
+
+            // the cells of the subset take its values: the other cells can't have them
+            bool progress = false;
+            for( std::size_t k = 0; k < m_dimension; ++k )
+            {
+                const auto cell = unitCell( unit, k );
+                bool member = m_values[cell] != 0;
+                for( std::size_t i = 0; i < size && !member; ++i )
+                {
+                    member = m_subset[indices[i]] == cell;
+                }
+                if( !member )
+                    progress |= eliminate( cell, values );
+            }
+
+            if( progress )
+            {
+                m_dirty[unit] |= std::uint32_t( 1 ) << static_cast< std::size_t >( technique );
+                return true;
+            }
+        } while( nextCombination( indices, size, m_subset.size() ) );
+    }
+    return false;
+}
+
+
+bool Rater::hiddenSubset( std::size_t size, Technique technique )
+{
+    std::size_t indices[MaxSubset];
+
+    for( std::size_t unit = 0; unit < 3 * m_dimension; ++unit )
+    {
+        if( !takeDirty( unit, technique ) )
+            continue;
+
+        // positions of each value still to place in the unit
+        Mask placed = 0;
+        for( std::size_t value = 0; value < m_dimension; ++value )
+        {
+            m_positions[value] = 0;
+        }
+        for( std::size_t k = 0; k < m_dimension; ++k )
+        {
+            const auto cell = unitCell( unit, k );
+            auto mask = m_candidates[cell];
+            if( m_values[cell] )
+            {
+                placed |= mask;
+                continue;
+            }
+            while( mask )
+            {
+                m_positions[lowestBit( mask )] |= Mask( 1 ) << k;
+                mask &= mask - 1;
+            }
+        }
+
+        m_subset.clear();
+        for( std::size_t value = 0; value < m_dimension; ++value )
+        {
+            if( !( placed >> value & 1 ) && bitCount( m_positions[value] ) <= size )
+                m_subset.push_back( value );
+        }
+        if( m_subset.size() < size )
+            continue;
+
+        for( std::size_t i = 0; i < size; ++i )
+        {
+            indices[i] = i;
+        }
+        do
+        {
+            Mask positions = 0, values = 0;
+            for( std::size_t i = 0; i < size; ++i )
+            {
+                positions |= m_positions[m_subset[indices[i]]];
+                values |= Mask( 1 ) << m_subset[indices[i]];
+            }
+            if( bitCount( positions ) != size )
+                continue;
+
+            // the values of the subset fill its cells: those cells can't have other values
+            bool progress = false;
+            while( positions )
+            {
+                const auto cell = unitCell( unit, lowestBit( positions ) );
+                progress |= eliminate( cell, m_candidates[cell] & ~values );
+                positions &= positions - 1;
+            }
+
+            if( progress )
+            {
+                m_dirty[unit] |= std::uint32_t( 1 ) << static_cast< std::size_t >( technique );
+                return true;
+            }
+        } while( nextCombination( indices, size, m_subset.size() ) );
+    }
+    return false;
+}
+
+
+bool Rater::xWing()
+{
+    const auto dim = m_dimension;
+
+    for( std::size_t value = 0; value < dim; ++value )
+    {
+        const Mask bit = Mask( 1 ) << value;
+
+        // rows first, then columns: base lines and cover lines swap roles
+        for( std::size_t base = 0; base <= dim; base += dim )
+        {
+            const auto cover = dim - base;
+            for( std::size_t line = 0; line < dim; ++line )
+            {
+                Mask positions = 0;
+                for( std::size_t k = 0; k < dim; ++k )
+                {
+                    const auto cell = unitCell( base + line, k );
+                    if( m_candidates[cell] & bit )
+                        positions |= m_values[cell] ? ~Mask( 0 ) : Mask( 1 ) << k;
+                }
+                m_positions[line] = positions;
+            }
+
+            for( std::size_t first = 0; first < dim; ++first )
+            {
+                const auto positions = m_positions[first];
+                if( bitCount( positions ) != 2 )
+                    continue;
+
+                for( auto second = first + 1; second < dim; ++second )
+                {
+                    if( m_positions[second] != positions )
+                        continue;
+
+                    bool progress = false;
+                    auto coverLines = positions;
+                    while( coverLines )
+                    {
+                        const auto unit = cover + lowestBit( coverLines );
+                        for( std::size_t k = 0; k < dim; ++k )
+                        {
+                            const auto cell = unitCell( unit, k );
+                            if( k != first && k != second && !m_values[cell] )
+                                progress |= eliminate( cell, bit );
+                        }
+                        coverLines &= coverLines - 1;
+                    }
+                    if( progress )
+                        return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+
+bool Rater::apply( Technique technique )
+{
+    switch( technique )
+    {
+    case Technique::HiddenSingle: return hiddenSingle();
+    case Technique::NakedSingle: return nakedSingle();
+    case Technique::Pointing: return pointing();
+    case Technique::Claiming: return claiming();
+    case Technique::NakedPair: return nakedSubset( 2, technique );
+    case Technique::XWing: return xWing();
+    case Technique::HiddenPair: return hiddenSubset( 2, technique );
+    case Technique::NakedTriple: return nakedSubset( 3, technique );
+    case Technique::HiddenTriple: return hiddenSubset( 3, technique );
+    case Technique::NakedQuad: return nakedSubset( 4, technique );
+    default: return false;
+    }
+}
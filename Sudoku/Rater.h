@@ -0,0 +1,187 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Board.h"
+
+namespace Sudoku
+{
+
+/**
+* @brief Logical techniques known to the rater, from the easiest to the hardest.
+*/
+enum class Technique
+{
+    HiddenSingle,
+    NakedSingle,
+    Pointing,
+    Claiming,
+    NakedPair,
+    XWing,
+    HiddenPair,
+    NakedTriple,
+    HiddenTriple,
+    NakedQuad,
+    /**
+    * @brief None of the techniques makes progress: the puzzle needs search.
+    */
+    Search,
+    Count
+};
+
+/**
+* @brief Gets the name of a technique, e.g. "Hidden single".
+* @param technique the technique
+* @return the name of the technique.
+*/
+const char* toString( Technique technique ) noexcept;
+
+/**
+* @brief Gets the difficulty weight of a technique, on the usual 1.0 to 10.0 scale.
+* @param technique the technique
+* @return the weight of the technique.
+*/
+double weight( Technique technique ) noexcept;
+
+/**
+* @brief Outcome of rating a puzzle.
+*/
+struct Rating
+{
+    /**
+    * @brief The weight of the hardest technique needed, plus a hundredth of
+    * the weights of all the steps harder than singles, so puzzles needing the
+    * same technique more often grade higher.
+    */
+    double grade = 0;
+    /**
+    * @brief The hardest technique needed.
+    */
+    Technique hardest = Technique::HiddenSingle;
+    /**
+    * @brief How many steps each technique made, indexed by Technique.
+    */
+    std::array<std::size_t, static_cast< std::size_t >( Technique::Count )> histogram{};
+    /**
+    * @brief True if the techniques solved the puzzle, false if it needs search
+    * or the clues contradict each other.
+    */
+    bool solved = false;
+};
+
+/**
+* @brief Rates puzzles by solving them the way a person would: at each step
+* the easiest technique that makes progress is applied and recorded. The
+* techniques extend the ones used by Board propagation (singles and naked
+* subsets) with hidden subsets, locked candidates and X-wings.
+*
+* Candidates are kept as bit masks, so boards up to 64x64 are supported. After
+* each step only the units touched by it are examined again. A rater keeps its
+* memory between puzzles, so rating many puzzles of the same size doesn't allocate.
+*/
+class Rater
+{
+public:
+    /**
+    * @brief Rates a puzzle.
+    * @param clues the puzzle clues, 0 denoting empty cells
+    * @return the rating.
+    * @throw std::invalid_argument if the clues are not a square board of a
+    * supported size or have invalid values
+    */
+    Rating rate( const Board::InputArray& clues );
+
+private:
+    using Mask = std::uint64_t;
+
+    Num m_blockSide = 0;
+    Num m_dimension = 0;
+    // cells of each unit: rows, then columns, then quadrants
+    std::vector<std::size_t> m_unitCells;
+    // units of each cell: its row, column and quadrant
+    std::vector<std::size_t> m_cellUnits;
+    std::vector<Mask> m_candidates;
+    std::vector<Num> m_values;
+    // per unit, the techniques that may make progress in it since it last changed
+    std::vector<std::uint32_t> m_dirty;
+    std::vector<std::size_t> m_singles;
+    std::vector<std::size_t> m_subset;
+    std::vector<Mask> m_positions;
+    std::size_t m_unsolved = 0;
+    bool m_broken = false;
+
+    /**
+    * @brief Builds the unit tables for boards of a block size.
+    */
+    void prepare( Num blockSide );
+    /**
+    * @brief Assigns a value to a cell and removes it from the cell's peers.
+    */
+    void place( std::size_t cell, Num value );
+    /**
+    * @brief Removes candidates from a cell, queuing it if a single one is left.
+    * @return True if a candidate was removed.
+    */
+    bool eliminate( std::size_t cell, Mask mask );
+    /**
+    * @brief Gets a cell of a unit.
+    */
+    std::size_t unitCell( std::size_t unit, std::size_t index ) const noexcept
+    {
+        return m_unitCells[unit * m_dimension + index];
+    }
+    /**
+    * @brief Tells if a technique may make progress in a unit, clearing the flag.
+    */
+    bool takeDirty( std::size_t unit, Technique technique ) noexcept;
+
+    /**
+    * @brief Places a value that only one cell of a unit can take.
+    * @return True if progress was made.
+    */
+    bool hiddenSingle();
+    /**
+    * @brief Places the value of a cell with a single candidate.
+    * @return True if progress was made.
+    */
+    bool nakedSingle();
+    /**
+    * @brief Removes a value from the rest of a line when it is only possible
+    * on that line within a quadrant.
+    * @return True if progress was made.
+    */
+    bool pointing();
+    /**
+    * @brief Removes a value from the rest of a quadrant when it is only
+    * possible in that quadrant within a line.
+    * @return True if progress was made.
+    */
+    bool claiming();
+    /**
+    * @brief Removes the values of size cells holding only size values from
+    * the rest of their unit.
+    * @return True if progress was made.
+    */
+    bool nakedSubset( std::size_t size, Technique technique );
+    /**
+    * @brief Removes the other candidates of size cells that are the only
+    * places of size values in their unit.
+    * @return True if progress was made.
+    */
+    bool hiddenSubset( std::size_t size, Technique technique );
+    /**
+    * @brief Removes a value from two cover lines when two base lines only
+    * have it in those lines.
+    * @return True if progress was made.
+    */
+    bool xWing();
+    /**
+    * @brief Runs a technique once.
+    * @return True if progress was made.
+    */
+    bool apply( Technique technique );
+};
+
+} // namespace
@@ -0,0 +1,350 @@
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+#include "ResultWriter.h"
+
+using Sudoku::Board;
+using Sudoku::Num;
+using Sudoku::OutputFormat;
+using Sudoku::PerfCounters;
+using Sudoku::PerfSample;
+using Sudoku::ResultWriter;
+
+constexpr std::size_t ResultWriter::DefaultCapacity;
+
+namespace
+{
+/**
+* @brief Gets the number of decimal digits of a value.
+*/
+std::size_t digits( std::uint64_t value ) noexcept
+{
+    std::size_t count = 1;
+    while( value >= 10 )
+    {
+        value /= 10;
+        ++count;
+    }
+    return count;
+}
+
+/**
+* @brief Gets the width of a value in the grid format, as operator<< always
+* wrote it: a column per 9 values of the dimension.
+*/
+std::size_t gridWidth( Num dimension ) noexcept
+{
+    return dimension / 9 + ( dimension % 9 ? 1 : 0 );
+}
+
+// the longest status name, the stats and the JSON keys around them
+constexpr std::size_t RecordOverhead = 128;
+// the JSON members of two samples of hardware counters
+constexpr std::size_t CountersOverhead = 512;
+
+/**
+* @brief A board stored as an array of values in row order.
+*/
+struct FlatGrid
+{
+    const Num* cells;
+    Num size;
+
+    Num dimension() const noexcept
+    {
+        return size;
+    }
+
+    Num at( Num row, Num column ) const noexcept
+    {
+        return cells[row * size + column];
+    }
+};
+}
+
+
+OutputFormat Sudoku::parseOutputFormat( const std::string& name )
+{
+    if( name == "line" )
+        return OutputFormat::Line;
+    if( name == "grid" )
+        return OutputFormat::Grid;
+    if( name == "json" )
+        return OutputFormat::Json;
+    throw std::invalid_argument( "Unknown output format " + name );
+}
+
+
+ResultWriter::ResultWriter( Sink sink, OutputFormat format, bool stats, std::size_t capacity ) :
+    m_sink( std::move( sink ) ),
+    m_format( format ),
+    m_stats( stats ),
+    m_capacity( capacity )
+{
+    m_buffer.reserve( m_capacity );
+}
+
+
+ResultWriter::~ResultWriter()
+{
+    flush();
+}
+
+
+void ResultWriter::write( const Board& board )
+{
+    prepare( boardSize( board ) + RecordOverhead );
+    switch( m_format )
+    {
+    case OutputFormat::Line:
+        appendLine( board );
+        m_buffer += '\n';
+        break;
+    case OutputFormat::Grid:
+        appendGrid( board );
+        break;
+    case OutputFormat::Json:
+        m_buffer += "{\"board\":\"";
+        appendLine( board );
+        m_buffer += "\"}\n";
+        break;
+    }
+}
+
+
+void ResultWriter::write( const SolveResult& result )
+{
+    writeResult( result.status, result.board, result.stats );
+}
+
+
+void ResultWriter::write( SolveStatus status, const Num* cells, Num dimension, const SolveStats& stats )
+{
+    writeResult( status, FlatGrid{ cells, dimension }, stats );
+}
+
+
+void ResultWriter::writeError( const std::string& message )
+{
+    // escaping takes at most 6 bytes per character
+    prepare( message.size() * 6 + RecordOverhead );
+    if( m_format == OutputFormat::Json )
+    {
+        m_buffer += "{\"status\":\"ERROR\",\"error\":\"";
+        appendEscaped( message );
+        m_buffer += "\"}\n";
+        return;
+    }
+
+    m_buffer += "ERROR ";
+    m_buffer += message;
+    m_buffer += '\n';
+    if( m_format == OutputFormat::Grid )
+        m_buffer += '\n';
+}
+
+
+template<typename Grid>
+void ResultWriter::writeResult( SolveStatus status, const Grid& grid, const SolveStats& stats )
+{
+    const bool counters = m_stats && m_format == OutputFormat::Json && PerfCounters::enabled();
+    prepare( boardSize( grid ) + RecordOverhead + ( counters ? CountersOverhead : 0 ) );
+    const bool solved = status == SolveStatus::Solved;
+    switch( m_format )
+    {
+    case OutputFormat::Line:
+        m_buffer += toString( status );
+        m_buffer += ' ';
+        if( solved )
+            appendLine( grid );
+        else
+            m_buffer += '-';
+        if( m_stats )
+            appendStats( stats );
+        m_buffer += '\n';
+        break;
+    case OutputFormat::Grid:
+        m_buffer += toString( status );
+        if( m_stats )
+            appendStats( stats );
+        m_buffer += '\n';
+        if( solved )
+            appendGrid( grid );
+        m_buffer += '\n';
+        break;
+    case OutputFormat::Json:
+        m_buffer += "{\"status\":\"";
+        m_buffer += toString( status );
+        if( solved )
+        {
+            m_buffer += "\",\"solution\":\"";
+            appendLine( grid );
+            m_buffer += '"';
+        }
+        else
+        {
+            m_buffer += "\",\"solution\":null";
+        }
+        if( m_stats )
+        {
+            m_buffer += ",\"nodes\":";
+            appendNumber( stats.nodes );
+            m_buffer += ",\"micros\":";
+            appendNumber( std::chrono::duration_cast< std::chrono::microseconds >( stats.elapsed ).count() );
+        }
+        if( counters )
+        {
+            appendCounters( "counters", stats.counters );
+            appendCounters( "propagationCounters", stats.propagationCounters );
+        }
+        m_buffer += "}\n";
+        break;
+    }
+}
+
+
+bool ResultWriter::flush()
+{
+    if( !m_buffer.empty() )
+    {
+        m_good = m_sink( m_buffer.data(), m_buffer.size() ) && m_good;
+        m_buffer.clear();
+    }
+    return m_good;
+}
+
+
+void ResultWriter::prepare( std::size_t size )
+{
+    if( m_buffer.size() + size > m_buffer.capacity() )
+    {
+        flush();
+        // a record larger than the buffer grows it, once
+        if( size > m_buffer.capacity() )
+            m_buffer.reserve( size );
+    }
+}
+
+
+void ResultWriter::appendNumber( std::uint64_t value )
+{
+    char text[20];
+    std::size_t length = 0;
+    do
+    {
+        text[length++] = static_cast< char >( '0' + value % 10 );
+        value /= 10;
+    }
+    while( value != 0 );
+    while( length > 0 )
+    {
+        m_buffer += text[--length];
+    }
+}
+
+
+void ResultWriter::appendEscaped( const std::string& text )
+{
+    static const char Hex[] = "0123456789abcdef";
+    for( const auto c : text )
+    {
+        const auto byte = static_cast< unsigned char >( c );
+        if( c == '"' || c == '\\' )
+        {
+            m_buffer += '\\';
+            m_buffer += c;
+        }
+        else if( byte < 0x20 )
+        {
+            m_buffer += "\\u00";
+            m_buffer += Hex[byte >> 4];
+            m_buffer += Hex[byte & 0xF];
+        }
+        else
+        {
+            m_buffer += c;
+        }
+    }
+}
+
+
+template<typename Grid>
+void ResultWriter::appendLine( const Grid& board )
+{
+    // the format read by parseLine, see toLine( const Board& )
+    const auto dim = board.dimension();
+    const bool separated = dim > 9;
+    for( Num i = 0; i < dim; ++i )
+    {
+        for( Num j = 0; j < dim; ++j )
+        {
+            if( !separated )
+            {
+                m_buffer += static_cast< char >( '0' + board.at( i, j ) );
+                continue;
+            }
+            if( i != 0 || j != 0 )
+                m_buffer += ' ';
+            appendNumber( board.at( i, j ) );
+        }
+    }
+}
+
+
+template<typename Grid>
+void ResultWriter::appendGrid( const Grid& board )
+{
+    const auto dim = board.dimension();
+    const auto width = gridWidth( dim );
+    for( Num i = 0; i < dim; ++i )
+    {
+        for( Num j = 0; j < dim; ++j )
+        {
+            const auto value = board.at( i, j );
+            for( auto length = digits( value ); length < width; ++length )
+            {
+                m_buffer += ' ';
+            }
+            appendNumber( value );
+            m_buffer += ' ';
+        }
+        m_buffer += '\n';
+    }
+}
+
+
+void ResultWriter::appendStats( const SolveStats& stats )
+{
+    m_buffer += ' ';
+    appendNumber( stats.nodes );
+    m_buffer += ' ';
+    appendNumber( std::chrono::duration_cast< std::chrono::microseconds >( stats.elapsed ).count() );
+}
+
+
+void ResultWriter::appendCounters( const char* name, const PerfSample& sample )
+{
+    m_buffer += ",\"";
+    m_buffer += name;
+    m_buffer += "\":{\"cycles\":";
+    appendNumber( sample.cycles );
+    m_buffer += ",\"instructions\":";
+    appendNumber( sample.instructions );
+    m_buffer += ",\"l1Misses\":";
+    appendNumber( sample.l1Misses );
+    m_buffer += ",\"llcMisses\":";
+    appendNumber( sample.llcMisses );
+    m_buffer += ",\"branchMisses\":";
+    appendNumber( sample.branchMisses );
+    m_buffer += '}';
+}
+
+
+template<typename Grid>
+std::size_t ResultWriter::boardSize( const Grid& board ) noexcept
+{
+    const auto dim = board.dimension();
+    const auto cell = std::max( digits( dim ), gridWidth( dim ) ) + 1;
+    return dim * dim * cell + dim;
+}
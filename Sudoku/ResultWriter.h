@@ -0,0 +1,144 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "Board.h"
+#include "SolveOptions.h"
+
+namespace Sudoku
+{
+
+/**
+* @brief How a ResultWriter formats what it writes.
+*/
+enum class OutputFormat
+{
+    /**
+    * @brief One line per record: boards in the compact line format, outcomes
+    * in the server response format, see toLine( const SolveResult& ).
+    */
+    Line,
+    /**
+    * @brief Boards as rows of space separated values, like operator<<.
+    * Outcomes have a line with their status, then the solution if there is
+    * one, then an empty line.
+    */
+    Grid,
+    /**
+    * @brief One JSON object per line (NDJSON).
+    */
+    Json
+};
+
+/**
+* @brief Gets the output format of a name: "line", "grid" or "json".
+* @throw std::invalid_argument if the name is none of those
+*/
+OutputFormat parseOutputFormat( const std::string& name );
+
+/**
+* @brief Writes boards and solve outcomes at high throughput. Records are
+* formatted straight into a buffer allocated once, without iostreams, and
+* handed to the sink only when the buffer is full or on flush(), so writing
+* many small records costs a few large writes. Not thread safe.
+*/
+class ResultWriter
+{
+public:
+    /**
+    * @brief Receives the formatted bytes.
+    * @return False if they couldn't be written.
+    */
+    using Sink = std::function<bool( const char* data, std::size_t size )>;
+
+    static constexpr std::size_t DefaultCapacity = std::size_t( 1 ) << 16;
+
+    /**
+    * @brief Constructs a writer.
+    * @param sink where the formatted bytes go
+    * @param format the format of the records
+    * @param stats if true, outcomes include the nodes searched and the time
+    * taken in microseconds, and in JSON the hardware counters of the solve and
+    * its propagation while PerfCounters are enabled
+    * @param capacity the bytes buffered before writing to the sink. A record
+    * larger than that grows the buffer.
+    */
+    ResultWriter( Sink sink, OutputFormat format, bool stats = true, std::size_t capacity = DefaultCapacity );
+    ResultWriter( const ResultWriter& ) = delete;
+    ResultWriter& operator=( const ResultWriter& ) = delete;
+    /**
+    * @brief Flushes what is left in the buffer.
+    */
+    ~ResultWriter();
+
+    /**
+    * @brief Writes the values of a board, empty cells as 0.
+    */
+    void write( const Board& board );
+    /**
+    * @brief Writes the outcome of a solve.
+    */
+    void write( const SolveResult& result );
+    /**
+    * @brief Writes the outcome of a solve whose board is an array, e.g. from
+    * a BatchSolver.
+    * @param cells the dimension * dimension values of the board in row order
+    */
+    void write( SolveStatus status, const Num* cells, Num dimension, const SolveStats& stats = {} );
+    /**
+    * @brief Writes the failure to solve a puzzle, as "ERROR" and a message.
+    */
+    void writeError( const std::string& message );
+    /**
+    * @brief Hands the buffered bytes to the sink.
+    * @return False if the sink failed, now or before.
+    */
+    bool flush();
+    /**
+    * @brief Tells if every write to the sink succeeded so far.
+    */
+    bool good() const noexcept
+    {
+        return m_good;
+    }
+
+private:
+    Sink m_sink;
+    OutputFormat m_format;
+    bool m_stats;
+    std::size_t m_capacity;
+    // reserved to m_capacity, so appending doesn't allocate
+    std::string m_buffer;
+    bool m_good = true;
+
+    /**
+    * @brief Makes room for a record of at most size bytes, flushing first
+    * if the buffer can't hold it.
+    */
+    void prepare( std::size_t size );
+    void appendNumber( std::uint64_t value );
+    /**
+    * @brief Appends a string as the contents of a JSON string.
+    */
+    void appendEscaped( const std::string& text );
+    template<typename Grid>
+    void writeResult( SolveStatus status, const Grid& grid, const SolveStats& stats );
+    template<typename Grid>
+    void appendLine( const Grid& grid );
+    template<typename Grid>
+    void appendGrid( const Grid& grid );
+    void appendStats( const SolveStats& stats );
+    /**
+    * @brief Appends a sample as a JSON member.
+    */
+    void appendCounters( const char* name, const PerfSample& sample );
+    /**
+    * @brief Gets an upper bound of the bytes a board takes in any format.
+    */
+    template<typename Grid>
+    static std::size_t boardSize( const Grid& grid ) noexcept;
+};
+
+} // namespace
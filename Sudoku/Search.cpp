@@ -0,0 +1,186 @@
+#include <algorithm>
+
+#include "Search.h"
+#include "BoardHasher.h"
+#include "Trace.h"
+
+using Sudoku::Search;
+using Sudoku::Board;
+using Sudoku::Num;
+
+Search::Search( const Board& board ) :
+    m_board( board )
+{
+    reset( board );
+}
+
+
+void Search::reset( const Board& board, ValueOrder order, std::uint64_t seed, SharedTranspositionTable* shared )
+{
+    m_board = board;
+    m_frames.clear();
+    m_values.clear();
+    m_visitedStates.clear();
+    m_shared = shared;
+    m_sharedStatistics = SharedTranspositionTable::Statistics{};
+    m_nodes = 0;
+    m_status = Status::Running;
+    m_order = order;
+    m_random.seed( seed );
+
+    const auto cells = m_board.dimension() * m_board.dimension();
+    m_frames.reserve( cells );
+    // each level holds at most one value per possibility of its cell
+    m_values.reserve( cells * m_board.dimension() );
+    m_scores.reserve( m_board.dimension() + 1 );
+    if( m_order == ValueOrder::History )
+        m_history.assign( cells * ( m_board.dimension() + 1 ), 0 );
+    m_board.recordChanges( true );
+
+    // propagation can fill every cell of a contradictory board, repeating
+    // values in its units
+    if( !m_board.isValid() )
+    {
+        m_status = Status::Exhausted;
+        return;
+    }
+
+    if( m_board.isSolved() )
+    {
+        m_status = Status::Solved;
+        return;
+    }
+
+    branch();
+}
+
+
+Search::Status Search::step()
+{
+    static BoardHasher boardHasher;
+
+    if( m_status != Status::Running )
+        return m_status;
+
+    if( m_frames.empty() )
+    {
+        m_status = Status::Exhausted;
+        return m_status;
+    }
+
+    auto& frame = m_frames.back();
+    m_board.rollback( frame.checkpoint );
+
+    if( frame.next == frame.count )
+    {
+        // all possibilities of this cell were tried: backtrack
+        m_values.resize( frame.values );
+        m_frames.pop_back();
+        Trace::instant( "backtrack", "depth", m_frames.size() );
+        if( !m_frames.empty() )
+        {
+            const auto& parent = m_frames.back();
+            recordDeadEnd( parent.row, parent.col, m_values[parent.values + parent.next - 1] );
+        }
+        return m_status;
+    }
+
+    const auto n = m_values[frame.values + frame.next++];
+    ++m_nodes;
+    m_board.set( frame.row, frame.col, n );
+
+    const auto hash = boardHasher( m_board );
+    const bool added = m_shared ? m_shared->insert( hash, m_sharedStatistics ) : m_visitedStates.insert( hash );
+    if( !added )
+    {
+        Trace::instant( "visited", "depth", m_frames.size() );
+        return m_status;
+    }
+
+    if( !m_board.isValid() )
+    {
+        Trace::instant( "conflict", "depth", m_frames.size() );
+        recordDeadEnd( frame.row, frame.col, n );
+        return m_status;
+    }
+
+    if( m_board.isSolved() )
+    {
+        m_status = Status::Solved;
+        return m_status;
+    }
+
+    branch();
+    return m_status;
+}
+
+
+void Search::resume() noexcept
+{
+    if( m_status == Status::Solved )
+        m_status = Status::Running;
+}
+
+
+Search::Status Search::run()
+{
+    while( step() == Status::Running )
+    {
+    }
+    return m_status;
+}
+
+
+void Search::branch()
+{
+    Num row = 0;
+    Num col = 0;
+    if( !m_board.mostConstrainedCell( row, col ) )
+        return;
+
+    const auto values = m_values.size();
+    const auto candidates = m_board.candidates( row, col );
+    m_values.insert( m_values.end(), candidates.begin(), candidates.end() );
+
+    switch( m_order )
+    {
+    case ValueOrder::Ascending:
+        break;
+    case ValueOrder::Random:
+        std::shuffle( m_values.begin() + values, m_values.end(), m_random );
+        break;
+    case ValueOrder::LeastConstraining:
+        m_board.countPeerPossibilities( row, col, m_scores );
+        orderValues( values, m_scores.data() );
+        break;
+    case ValueOrder::History:
+        orderValues( values, m_history.data() + ( row * m_board.dimension() + col ) * ( m_board.dimension() + 1 ) );
+        break;
+    }
+
+    m_frames.push_back( { row, col, values, m_values.size() - values, 0, m_board.checkpoint() } );
+}
+
+
+void Search::orderValues( std::size_t values, const std::size_t* scores ) noexcept
+{
+    // an insertion sort, as cells have few possibilities and it doesn't allocate
+    for( auto i = values + 1; i < m_values.size(); ++i )
+    {
+        const auto n = m_values[i];
+        auto j = i;
+        while( j > values && scores[m_values[j - 1]] > scores[n] )
+        {
+            m_values[j] = m_values[j - 1];
+            --j;
+        }
+        m_values[j] = n;
+    }
+}
+
+
+void Search::recordDeadEnd( Num row, Num col, Num value ) noexcept
+{
+    if( m_order == ValueOrder::History )
+        ++m_history[( row * m_board.dimension() + col ) * ( m_board.dimension() + 1 ) + value];
+}
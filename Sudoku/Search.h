@@ -0,0 +1,166 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Board.h"
+#include "SharedTranspositionTable.h"
+#include "SolveOptions.h"
+#include "TranspositionTable.h"
+
+namespace Sudoku
+{
+
+/**
+* @brief Backtracking search over a board driven by an explicit stack instead
+* of recursion. Each level of the stack only stores the branching cell, its
+* possibilities in the order they are tried, the next one to try and a
+* checkpoint into the board's change record, so the search can be stepped,
+* paused and inspected at any point.
+*/
+class Search
+{
+public:
+    /**
+    * @brief State of the search.
+    */
+    enum class Status
+    {
+        Running,
+        Solved,
+        Exhausted
+    };
+
+    /**
+    * @brief One level of the search: the cell being branched on, where its
+    * ordered possibilities start in the shared value stack and how many
+    * there are, the index of the next one to try and the board checkpoint
+    * to roll back to before trying it.
+    */
+    struct Frame
+    {
+        Num row;
+        Num col;
+        std::size_t values;
+        std::size_t count;
+        std::size_t next;
+        std::size_t checkpoint;
+    };
+
+    /**
+    * @brief Prepares a search for the given board. The frame stack and the
+    * board's change record are allocated up front for the deepest possible search.
+    * @param board the board to solve
+    */
+    explicit Search( const Board& board );
+    /**
+    * @brief Restarts the search on another board, reusing the memory already
+    * allocated for the frame stack, visited states and change record.
+    * @param board the board to solve
+    * @param order the order in which the possibilities of a cell are tried
+    * @param seed the seed for randomized orders
+    * @param shared if not null, the table of visited states to share with
+    * searches on other threads, used instead of the search's own
+    */
+    void reset( const Board& board, ValueOrder order = ValueOrder::Ascending, std::uint64_t seed = 0,
+        SharedTranspositionTable* shared = nullptr );
+    /**
+    * @brief Makes a solved search continue to look for another solution.
+    * Has no effect if the search is not in the Status::Solved state.
+    */
+    void resume() noexcept;
+    /**
+    * @brief Tries the next possibility of the deepest frame.
+    * @return The status of the search after the step.
+    */
+    Status step();
+    /**
+    * @brief Steps the search until it is solved or exhausted.
+    * @return The final status of the search.
+    */
+    Status run();
+    /**
+    * @brief Gets the current status of the search.
+    * @return the current status of the search.
+    */
+    Status status() const noexcept
+    {
+        return m_status;
+    }
+    /**
+    * @brief Gets the board in its current search state. Once the status is
+    * Status::Solved, this is the solution.
+    * @return the board in its current search state.
+    */
+    const Board& board() const noexcept
+    {
+        return m_board;
+    }
+    /**
+    * @brief Gets the stack of open frames, from the root to the deepest level.
+    * @return the stack of open frames.
+    */
+    const std::vector<Frame>& frames() const noexcept
+    {
+        return m_frames;
+    }
+    /**
+    * @brief Gets the number of assignments tried so far.
+    * @return the number of assignments tried so far.
+    */
+    std::size_t nodes() const noexcept
+    {
+        return m_nodes;
+    }
+    /**
+    * @brief Gets the number of distinct states visited so far.
+    * @return the number of distinct states visited so far.
+    */
+    std::size_t visitedStates() const noexcept
+    {
+        return m_shared ? m_sharedStatistics.stores + m_sharedStatistics.drops : m_visitedStates.size();
+    }
+    /**
+    * @brief Gets what the probes of the shared table met so far, all zero if
+    * the search has its own table.
+    * @return the statistics of the shared table probes.
+    */
+    const SharedTranspositionTable::Statistics& sharedStatistics() const noexcept
+    {
+        return m_sharedStatistics;
+    }
+
+private:
+    Board m_board;
+    std::vector<Frame> m_frames;
+    std::vector<Num> m_values;
+    TranspositionTable m_visitedStates;
+    SharedTranspositionTable* m_shared = nullptr;
+    SharedTranspositionTable::Statistics m_sharedStatistics;
+    std::size_t m_nodes = 0;
+    Status m_status = Status::Running;
+    ValueOrder m_order = ValueOrder::Ascending;
+    std::mt19937_64 m_random;
+    // per value scores ordering the possibilities of a cell, lowest first
+    std::vector<std::size_t> m_scores;
+    // dead ends reached by each value of each cell, for ValueOrder::History
+    std::vector<std::size_t> m_history;
+
+    /**
+    * @brief Opens a frame on the most constrained cell of the current board.
+    */
+    void branch();
+    /**
+    * @brief Sorts the possibilities of a new frame, starting at values, by
+    * ascending score, keeping the ascending order of values with the same score.
+    * @param scores the score of each value, indexed by value
+    */
+    void orderValues( std::size_t values, const std::size_t* scores ) noexcept;
+    /**
+    * @brief Records that assigning a value to a cell led to a dead end.
+    */
+    void recordDeadEnd( Num row, Num col, Num value ) noexcept;
+};
+
+} // namespace
@@ -0,0 +1,113 @@
+#include "SharedTranspositionTable.h"
+
+using Sudoku::SharedTranspositionTable;
+
+constexpr std::size_t SharedTranspositionTable::DefaultCapacity;
+constexpr std::size_t SharedTranspositionTable::ProbeLimit;
+constexpr std::uint64_t SharedTranspositionTable::Zero;
+
+SharedTranspositionTable::Statistics& SharedTranspositionTable::Statistics::operator+=( const Statistics& other ) noexcept
+{
+    probes += other.probes;
+    hits += other.hits;
+    stores += other.stores;
+    collisions += other.collisions;
+    drops += other.drops;
+    return *this;
+}
+
+
+SharedTranspositionTable::SharedTranspositionTable( std::size_t capacity )
+{
+    // at least a probe window, so that windows don't overlap themselves
+    unsigned bits = 4;
+    while( ( std::size_t( 1 ) << bits ) < capacity )
+    {
+        ++bits;
+    }
+    m_capacity = std::size_t( 1 ) << bits;
+    m_shift = 64 - bits;
+    m_slots.reset( new std::atomic<std::uint64_t>[m_capacity] );
+    clear();
+}
+
+
+bool SharedTranspositionTable::insert( std::size_t hash, Statistics& statistics ) noexcept
+{
+    ++statistics.probes;
+    const auto wanted = key( hash );
+    const auto mask = m_capacity - 1;
+    auto i = home( wanted );
+    for( std::size_t probe = 0; probe < ProbeLimit; ++probe, i = ( i + 1 ) & mask )
+    {
+        auto& slot = m_slots[i];
+        auto current = slot.load( std::memory_order_relaxed );
+        if( current == 0 )
+        {
+            // slots are only ever claimed, never freed, so every thread
+            // inserting the same hash races for the same first free slot
+            if( slot.compare_exchange_strong( current, wanted, std::memory_order_relaxed ) )
+            {
+                ++statistics.stores;
+                return true;
+            }
+            ++statistics.collisions;
+        }
+        if( current == wanted )
+        {
+            ++statistics.hits;
+            return false;
+        }
+    }
+
+    ++statistics.drops;
+    return true;
+}
+
+
+bool SharedTranspositionTable::contains( std::size_t hash, Statistics& statistics ) const noexcept
+{
+    ++statistics.probes;
+    const auto wanted = key( hash );
+    const auto mask = m_capacity - 1;
+    auto i = home( wanted );
+    for( std::size_t probe = 0; probe < ProbeLimit; ++probe, i = ( i + 1 ) & mask )
+    {
+        const auto current = m_slots[i].load( std::memory_order_relaxed );
+        if( current == 0 )
+            return false;
+        if( current == wanted )
+        {
+            ++statistics.hits;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+void SharedTranspositionTable::clear() noexcept
+{
+    for( std::size_t i = 0; i < m_capacity; ++i )
+    {
+        m_slots[i].store( 0, std::memory_order_relaxed );
+    }
+}
+
+
+std::size_t SharedTranspositionTable::size() const noexcept
+{
+    std::size_t count = 0;
+    for( std::size_t i = 0; i < m_capacity; ++i )
+    {
+        count += m_slots[i].load( std::memory_order_relaxed ) != 0;
+    }
+    return count;
+}
+
+
+std::size_t SharedTranspositionTable::home( std::uint64_t key ) const noexcept
+{
+    // Fibonacci hashing, like TranspositionTable
+    return static_cast< std::size_t >( ( key * 0x9E3779B97F4A7C15ull ) >> m_shift );
+}
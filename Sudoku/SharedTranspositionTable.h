@@ -0,0 +1,118 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace Sudoku
+{
+
+/**
+* @brief Set of board hashes shared by searches running on several threads,
+* so that a state visited by one of them is skipped by the others. Probing
+* and storing are lock-free: every slot is a single atomic word holding a
+* hash, claimed with a compare and swap, so an entry is never seen half
+* written and needs no verification. The table doesn't grow: a hash that
+* finds no free slot within a few probes is not stored, which only costs
+* visiting the state again.
+*/
+class SharedTranspositionTable
+{
+public:
+    /**
+    * @brief Counts of what a thread's probes met. Each thread keeps its own,
+    * so that counting doesn't contend either; add them up to report.
+    */
+    struct Statistics
+    {
+        /**
+        * @brief Calls to insert() or contains().
+        */
+        std::size_t probes = 0;
+        /**
+        * @brief Probes that found their hash already in the table.
+        */
+        std::size_t hits = 0;
+        /**
+        * @brief Hashes stored.
+        */
+        std::size_t stores = 0;
+        /**
+        * @brief Slots another thread claimed between being read and being
+        * claimed, a measure of contention.
+        */
+        std::size_t collisions = 0;
+        /**
+        * @brief Hashes not stored because their probe window was full.
+        */
+        std::size_t drops = 0;
+
+        Statistics& operator+=( const Statistics& other ) noexcept;
+    };
+
+    /**
+    * @brief Constructs an empty table.
+    * @param capacity the number of slots, rounded up to a power of 2
+    */
+    explicit SharedTranspositionTable( std::size_t capacity = DefaultCapacity );
+    /**
+    * @brief Adds a hash to the table. Safe to call from any thread.
+    * @param hash the hash to add
+    * @param statistics the calling thread's counts, updated
+    * @return True if the hash was not in the table yet, whether or not there
+    * was room to store it, false if it was already there.
+    */
+    bool insert( std::size_t hash, Statistics& statistics ) noexcept;
+    /**
+    * @brief Checks if a hash is in the table. Safe to call from any thread.
+    * @param hash the hash to look for
+    * @param statistics the calling thread's counts, updated
+    * @return True if the hash is in the table, false otherwise.
+    */
+    bool contains( std::size_t hash, Statistics& statistics ) const noexcept;
+    /**
+    * @brief Removes every hash. Not safe while other threads use the table.
+    */
+    void clear() noexcept;
+    /**
+    * @brief Counts the hashes in the table, visiting every slot.
+    * @return the number of hashes in the table.
+    */
+    std::size_t size() const noexcept;
+    /**
+    * @brief Gets the number of slots in the table.
+    * @return the number of slots in the table.
+    */
+    std::size_t capacity() const noexcept
+    {
+        return m_capacity;
+    }
+
+    static constexpr std::size_t DefaultCapacity = std::size_t( 1 ) << 18;
+    /**
+    * @brief How many consecutive slots a hash may be stored in.
+    */
+    static constexpr std::size_t ProbeLimit = 16;
+
+private:
+    // 0 marks a free slot: the hash 0 is stored as Zero instead
+    static constexpr std::uint64_t Zero = ~std::uint64_t( 0 );
+
+    std::unique_ptr<std::atomic<std::uint64_t>[]> m_slots;
+    std::size_t m_capacity;
+    unsigned m_shift;
+
+    /**
+    * @brief Gets the first slot to probe for a hash.
+    */
+    std::size_t home( std::uint64_t key ) const noexcept;
+    /**
+    * @brief Gets the value stored in a slot for a hash.
+    */
+    static std::uint64_t key( std::size_t hash ) noexcept
+    {
+        return hash == 0 ? Zero : hash;
+    }
+};
+
+} // namespace
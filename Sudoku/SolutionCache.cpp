@@ -0,0 +1,85 @@
+#include <iterator>
+#include <stdexcept>
+
+#include "SolutionCache.h"
+
+using Sudoku::SolutionCache;
+using Sudoku::Digest;
+using Sudoku::Nums;
+
+SolutionCache::SolutionCache( std::size_t capacity ) :
+    m_capacity( capacity )
+{
+    if( capacity == 0 )
+        throw std::invalid_argument( "solution cache needs a capacity of at least 1" );
+
+    m_index.reserve( capacity );
+}
+
+
+bool SolutionCache::find( const Digest& key, Nums& solution )
+{
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    const auto found = m_index.find( key );
+    if( found == m_index.end() )
+    {
+        ++m_misses;
+        return false;
+    }
+
+    ++m_hits;
+    m_entries.splice( m_entries.begin(), m_entries, found->second );
+    solution = found->second->solution;
+    return true;
+}
+
+
+void SolutionCache::insert( const Digest& key, const Nums& solution )
+{
+    std::lock_guard<std::mutex> lock( m_mutex );
+
+    const auto found = m_index.find( key );
+    if( found != m_index.end() )
+    {
+        found->second->solution = solution;
+        m_entries.splice( m_entries.begin(), m_entries, found->second );
+        return;
+    }
+
+    if( m_entries.size() == m_capacity )
+    {
+        // reuse the evicted entry's node and memory
+        auto& last = m_entries.back();
+        m_index.erase( last.key );
+        last.key = key;
+        last.solution = solution;
+        m_entries.splice( m_entries.begin(), m_entries, std::prev( m_entries.end() ) );
+    }
+    else
+    {
+        m_entries.push_front( { key, solution } );
+    }
+    m_index.emplace( key, m_entries.begin() );
+}
+
+
+std::size_t SolutionCache::size() const
+{
+    std::lock_guard<std::mutex> lock( m_mutex );
+    return m_entries.size();
+}
+
+
+std::size_t SolutionCache::hits() const
+{
+    std::lock_guard<std::mutex> lock( m_mutex );
+    return m_hits;
+}
+
+
+std::size_t SolutionCache::misses() const
+{
+    std::lock_guard<std::mutex> lock( m_mutex );
+    return m_misses;
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "Common.h"
+#include "Digest.h"
+#include "SolutionLookup.h"
+
+namespace Sudoku
+{
+
+/**
+* @brief Bounded in-memory cache of solutions, keyed by the digest of the
+* canonical form of the boards they solve and holding the solutions in canonical
+* orientation, so a board hits the entry of any board equivalent to it. When
+* full, the least recently used entry is evicted. It is safe to use from several threads.
+*/
+class SolutionCache : public SolutionLookup
+{
+public:
+    /**
+    * @brief Constructs an empty cache.
+    * @param capacity the maximum number of solutions kept, at least 1
+    * @throw std::invalid_argument if the capacity is 0
+    */
+    explicit SolutionCache( std::size_t capacity );
+    /**
+    * @brief Looks a solution up, making it the most recently used one.
+    * @param key the digest of the canonical board
+    * @param[out] solution receives the solution in canonical orientation if found
+    * @return True if the solution was found.
+    */
+    bool find( const Digest& key, Nums& solution ) override;
+    /**
+    * @brief Adds or replaces a solution, evicting the least recently used one
+    * if the cache is full.
+    * @param key the digest of the canonical board
+    * @param solution the solution in canonical orientation
+    */
+    void insert( const Digest& key, const Nums& solution ) override;
+
+    /**
+    * @brief Gets the number of solutions in the cache.
+    * @return the number of solutions in the cache.
+    */
+    std::size_t size() const;
+    /**
+    * @brief Gets the maximum number of solutions kept.
+    * @return the capacity of the cache.
+    */
+    std::size_t capacity() const noexcept
+    {
+        return m_capacity;
+    }
+    /**
+    * @brief Gets the number of lookups that found a solution.
+    * @return the number of hits.
+    */
+    std::size_t hits() const;
+    /**
+    * @brief Gets the number of lookups that found nothing.
+    * @return the number of misses.
+    */
+    std::size_t misses() const;
+
+private:
+    struct Entry
+    {
+        Digest key;
+        Nums solution;
+    };
+    using Entries = std::list<Entry>;
+
+    std::size_t m_capacity;
+    std::size_t m_hits = 0;
+    std::size_t m_misses = 0;
+    // most recently used first
+    Entries m_entries;
+    std::unordered_map<Digest, Entries::iterator, DigestHasher> m_index;
+    mutable std::mutex m_mutex;
+};
+
+} // namespace
@@ -0,0 +1,33 @@
+#pragma once
+#include "Common.h"
+#include "Digest.h"
+
+namespace Sudoku
+{
+
+/**
+* @brief Somewhere solutions are kept, keyed by the digest of the canonical
+* form of the boards they solve and held in canonical orientation, see
+* Canonicalizer. Implementations must be safe to use from several threads.
+*/
+class SolutionLookup
+{
+public:
+    virtual ~SolutionLookup() = default;
+
+    /**
+    * @brief Looks a solution up.
+    * @param key the digest of the canonical board
+    * @param[out] solution receives the solution in canonical orientation if found
+    * @return True if the solution was found.
+    */
+    virtual bool find( const Digest& key, Nums& solution ) = 0;
+    /**
+    * @brief Adds a solution.
+    * @param key the digest of the canonical board
+    * @param solution the solution in canonical orientation
+    */
+    virtual void insert( const Digest& key, const Nums& solution ) = 0;
+};
+
+} // namespace
@@ -0,0 +1,428 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "SolutionStore.h"
+
+using Sudoku::SolutionStore;
+using Sudoku::Digest;
+using Sudoku::Nums;
+
+namespace
+{
+constexpr char Magic[8] = { 'S', 'U', 'D', 'O', 'K', 'U', 'S', '1' };
+constexpr std::size_t FileHeaderSize = 16;
+
+/**
+* @brief Every record starts with this header, followed by one byte per cell
+* padded to a multiple of 8 bytes.
+*/
+struct RecordHeader
+{
+    std::uint64_t high;
+    std::uint64_t low;
+    std::uint32_t cells;
+    std::uint32_t check;
+};
+static_assert( sizeof( RecordHeader ) == 24, "records must have a fixed layout" );
+
+constexpr std::uint32_t MaxCells = 225 * 225;
+
+std::size_t recordSize( std::uint32_t cells ) noexcept
+{
+    return sizeof( RecordHeader ) + ( cells + 7 ) / 8 * 8;
+}
+
+/**
+* @brief FNV-1a checksum of a record, detecting records torn by a crash.
+*/
+std::uint32_t checksum( const RecordHeader& header, const unsigned char* cells ) noexcept
+{
+    std::uint32_t hash = 2166136261u;
+    const auto add = [&hash]( const unsigned char* bytes, std::size_t count )
+        {
+            for( std::size_t i = 0; i < count; ++i )
+            {
+                hash = ( hash ^ bytes[i] ) * 16777619u;
+            }
+        };
+    add( reinterpret_cast< const unsigned char* >( &header ), offsetof( RecordHeader, check ) );
+    add( cells, header.cells );
+    return hash;
+}
+
+[[noreturn]] void fail( const std::string& what )
+{
+    throw std::runtime_error( what + ": " + std::strerror( errno ) );
+}
+
+bool writeAll( int fd, const unsigned char* data, std::size_t size ) noexcept
+{
+    while( size > 0 )
+    {
+        const auto written = ::write( fd, data, size );
+        if( written < 0 )
+        {
+            if( errno == EINTR )
+                continue;
+            return false;
+        }
+        data += written;
+        size -= static_cast< std::size_t >( written );
+    }
+    return true;
+}
+
+/**
+* @brief Holds the advisory lock serializing the writers of a store file.
+*/
+class FileLock
+{
+public:
+    explicit FileLock( int fd ) : m_fd( fd )
+    {
+        while( ::flock( m_fd, LOCK_EX ) != 0 )
+        {
+            if( errno != EINTR )
+                fail( "can't lock solution store" );
+        }
+    }
+    ~FileLock()
+    {
+        ::flock( m_fd, LOCK_UN );
+    }
+
+    FileLock( const FileLock& ) = delete;
+    FileLock& operator=( const FileLock& ) = delete;
+
+private:
+    int m_fd;
+};
+}
+
+SolutionStore::SolutionStore( const std::string& path ) :
+    m_path( path )
+{
+    open();
+}
+
+
+SolutionStore::~SolutionStore()
+{
+    close();
+}
+
+
+bool SolutionStore::find( const Digest& key, Nums& solution )
+{
+    std::shared_lock<std::shared_timed_mutex> lock( m_mutex );
+
+    const auto found = m_index.find( key );
+    if( found == m_index.end() )
+        return false;
+
+    RecordHeader header;
+    std::memcpy( &header, m_map + found->second, sizeof( header ) );
+    const auto* cells = m_map + found->second + sizeof( header );
+    solution.assign( cells, cells + header.cells );
+    return true;
+}
+
+
+void SolutionStore::insert( const Digest& key, const Nums& solution )
+{
+    if( solution.empty() || solution.size() > MaxCells )
+        throw std::invalid_argument( "invalid solution size: " + std::to_string( solution.size() ) );
+
+    std::unique_lock<std::shared_timed_mutex> lock( m_mutex );
+    for( bool reopen = false; ; reopen = true )
+    {
+        if( reopen )
+        {
+            close();
+            open();
+        }
+
+        FileLock fileLock( m_fd );
+        // compacted by another process, maybe while this one waited for the
+        // lock: append to the new file
+        if( !isCurrent() )
+            continue;
+
+        scan();
+        if( m_index.count( key ) )
+            return;
+        // a writer that crashed since the store was opened may have left a torn
+        // record, which would hide this one from scan()
+        truncateTorn();
+
+        RecordHeader header{ key.high, key.low, static_cast< std::uint32_t >( solution.size() ), 0 };
+        m_record.assign( recordSize( header.cells ), 0 );
+        for( std::size_t i = 0; i < solution.size(); ++i )
+        {
+            if( solution[i] > 0xFF )
+                throw std::invalid_argument( "invalid solution value: " + std::to_string( solution[i] ) );
+            m_record[sizeof( header ) + i] = static_cast< unsigned char >( solution[i] );
+        }
+        header.check = checksum( header, m_record.data() + sizeof( header ) );
+        std::memcpy( m_record.data(), &header, sizeof( header ) );
+
+        if( !writeAll( m_fd, m_record.data(), m_record.size() ) )
+        {
+            // don't leave a torn record behind for the next writer to append after
+            const auto error = errno;
+            if( ::ftruncate( m_fd, static_cast< off_t >( m_end ) ) != 0 )
+            {
+                // the torn record will be dropped when the store is opened again
+            }
+            errno = error;
+            fail( "can't write to solution store " + m_path );
+        }
+        scan();
+        return;
+    }
+}
+
+
+void SolutionStore::refresh()
+{
+    std::unique_lock<std::shared_timed_mutex> lock( m_mutex );
+    if( !isCurrent() )
+    {
+        close();
+        open();
+        return;
+    }
+    scan();
+}
+
+
+void SolutionStore::compact( std::size_t maxSolutions )
+{
+    std::unique_lock<std::shared_timed_mutex> lock( m_mutex );
+    for( bool reopen = false; ; reopen = true )
+    {
+        if( reopen )
+        {
+            close();
+            open();
+        }
+
+        const auto oldFd = m_fd;
+        const auto* oldMap = m_map;
+        const auto oldMapSize = m_mapSize;
+        {
+            FileLock fileLock( oldFd );
+            // compacted by another process while this one waited for the lock:
+            // compact the new file
+            if( !isCurrent() )
+                continue;
+
+            scan();
+
+            // keep the records in their original order
+            std::vector<std::size_t> offsets;
+            offsets.reserve( m_index.size() );
+            for( const auto& entry : m_index )
+            {
+                offsets.push_back( entry.second );
+            }
+            std::sort( offsets.begin(), offsets.end() );
+            if( maxSolutions != 0 && offsets.size() > maxSolutions )
+                offsets.erase( offsets.begin(), offsets.end() - static_cast< std::ptrdiff_t >( maxSolutions ) );
+
+            const auto temporary = m_path + ".compact";
+            const int fd = ::open( temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644 );
+            if( fd < 0 )
+                fail( "can't create " + temporary );
+
+            unsigned char fileHeader[FileHeaderSize] = {};
+            std::memcpy( fileHeader, Magic, sizeof( Magic ) );
+            bool written = writeAll( fd, fileHeader, sizeof( fileHeader ) );
+            for( auto offset : offsets )
+            {
+                if( !written )
+                    break;
+
+                RecordHeader header;
+                std::memcpy( &header, m_map + offset, sizeof( header ) );
+                written = writeAll( fd, m_map + offset, recordSize( header.cells ) );
+            }
+            written = written && ::fsync( fd ) == 0;
+            ::close( fd );
+
+            if( !written || ::rename( temporary.c_str(), m_path.c_str() ) != 0 )
+            {
+                const auto error = errno;
+                ::unlink( temporary.c_str() );
+                errno = error;
+                fail( "can't compact solution store " + m_path );
+            }
+
+            // switch to the new file while still holding the old one's lock, so
+            // writers waiting for it find the new file when they get it
+            m_fd = -1;
+            m_map = nullptr;
+            m_mapSize = 0;
+            open();
+        }
+
+        if( oldMap )
+            ::munmap( const_cast< unsigned char* >( oldMap ), oldMapSize );
+        ::close( oldFd );
+        return;
+    }
+}
+
+
+std::size_t SolutionStore::size() const
+{
+    std::shared_lock<std::shared_timed_mutex> lock( m_mutex );
+    return m_index.size();
+}
+
+
+std::size_t SolutionStore::fileSize() const
+{
+    std::shared_lock<std::shared_timed_mutex> lock( m_mutex );
+    return m_end;
+}
+
+
+void SolutionStore::open()
+{
+    for( bool reopen = false; ; reopen = true )
+    {
+        if( reopen )
+            close();
+
+        m_fd = ::open( m_path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644 );
+        if( m_fd < 0 )
+            fail( "can't open solution store " + m_path );
+
+        m_index.clear();
+        m_end = FileHeaderSize;
+
+        try
+        {
+            FileLock fileLock( m_fd );
+
+            struct stat status;
+            if( ::fstat( m_fd, &status ) != 0 )
+                fail( "can't stat solution store " + m_path );
+            m_inode = static_cast< std::uint64_t >( status.st_ino );
+            // compacted by another process between the open and the lock
+            if( !isCurrent() )
+                continue;
+
+            unsigned char fileHeader[FileHeaderSize] = {};
+            if( status.st_size == 0 )
+            {
+                std::memcpy( fileHeader, Magic, sizeof( Magic ) );
+                if( !writeAll( m_fd, fileHeader, sizeof( fileHeader ) ) )
+                    fail( "can't write to solution store " + m_path );
+            }
+            else if( ::pread( m_fd, fileHeader, sizeof( fileHeader ), 0 ) != static_cast< ssize_t >( sizeof( fileHeader ) ) ||
+                std::memcmp( fileHeader, Magic, sizeof( Magic ) ) != 0 )
+            {
+                throw std::runtime_error( m_path + " is not a solution store" );
+            }
+
+            scan();
+            truncateTorn();
+        }
+        catch( ... )
+        {
+            close();
+            throw;
+        }
+        return;
+    }
+}
+
+
+void SolutionStore::close() noexcept
+{
+    if( m_map )
+        ::munmap( const_cast< unsigned char* >( m_map ), m_mapSize );
+    m_map = nullptr;
+    m_mapSize = 0;
+
+    if( m_fd >= 0 )
+        ::close( m_fd );
+    m_fd = -1;
+}
+
+
+bool SolutionStore::isCurrent() const noexcept
+{
+    // a removed file stays current, there's no other to switch to
+    struct stat status;
+    return ::stat( m_path.c_str(), &status ) != 0 || static_cast< std::uint64_t >( status.st_ino ) == m_inode;
+}
+
+
+void SolutionStore::map( std::size_t size )
+{
+    if( size <= m_mapSize )
+        return;
+
+    // Map ahead of the file, so appends rarely need a new mapping. Only the
+    // pages within the file are ever read.
+    const auto mapSize = std::max<std::size_t>( size * 2, 1 << 20 );
+    void* map = ::mmap( nullptr, mapSize, PROT_READ, MAP_SHARED, m_fd, 0 );
+    if( map == MAP_FAILED )
+        fail( "can't map solution store " + m_path );
+
+    if( m_map )
+        ::munmap( const_cast< unsigned char* >( m_map ), m_mapSize );
+    m_map = static_cast< const unsigned char* >( map );
+    m_mapSize = mapSize;
+}
+
+
+void SolutionStore::scan()
+{
+    struct stat status;
+    if( ::fstat( m_fd, &status ) != 0 )
+        fail( "can't stat solution store " + m_path );
+
+    const auto size = static_cast< std::size_t >( status.st_size );
+    if( size <= m_end )
+        return;
+    map( size );
+
+    while( m_end + sizeof( RecordHeader ) <= size )
+    {
+        RecordHeader header;
+        std::memcpy( &header, m_map + m_end, sizeof( header ) );
+        if( header.cells == 0 || header.cells > MaxCells || m_end + recordSize( header.cells ) > size )
+            break;
+        if( checksum( header, m_map + m_end + sizeof( header ) ) != header.check )
+            break;
+
+        // the first record of a key wins, later ones are duplicates
+        m_index.emplace( Digest{ header.high, header.low }, m_end );
+        m_end += recordSize( header.cells );
+    }
+}
+
+
+void SolutionStore::truncateTorn()
+{
+    struct stat status;
+    if( ::fstat( m_fd, &status ) != 0 )
+        fail( "can't stat solution store " + m_path );
+    if( static_cast< std::size_t >( status.st_size ) > m_end && ::ftruncate( m_fd, static_cast< off_t >( m_end ) ) != 0 )
+        fail( "can't repair solution store " + m_path );
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Common.h"
+#include "Digest.h"
+#include "SolutionLookup.h"
+
+namespace Sudoku
+{
+
+/**
+* @brief Persistent store of solutions, keyed like SolutionCache, that survives
+* process restarts. The file is an append-only log of checksummed records; it
+* is memory-mapped for reading and indexed in memory when opened, so lookups
+* are O(1). Several processes may share a file: appends are serialized with
+* an advisory lock and records appended by other processes are picked up by
+* refresh(). Within a process, lookups from any number of threads run
+* concurrently.
+*
+* Only available on POSIX systems.
+*/
+class SolutionStore : public SolutionLookup
+{
+public:
+    /**
+    * @brief Opens a store, creating its file if needed. A record left
+    * incomplete by a crash is truncated away.
+    * @param path the path of the store file
+    * @throw std::runtime_error if the file can't be opened or is not a store
+    */
+    explicit SolutionStore( const std::string& path );
+    ~SolutionStore();
+
+    SolutionStore( const SolutionStore& ) = delete;
+    SolutionStore& operator=( const SolutionStore& ) = delete;
+
+    /**
+    * @brief Looks a solution up.
+    * @param key the digest of the canonical board
+    * @param[out] solution receives the solution in canonical orientation if found
+    * @return True if the solution was found.
+    */
+    bool find( const Digest& key, Nums& solution ) override;
+    /**
+    * @brief Appends a solution unless the store already has one for the key.
+    * @param key the digest of the canonical board
+    * @param solution the solution in canonical orientation
+    * @throw std::runtime_error if the record can't be written
+    */
+    void insert( const Digest& key, const Nums& solution ) override;
+    /**
+    * @brief Picks up the records appended by other processes, reopening the
+    * file if another process compacted it.
+    */
+    void refresh();
+    /**
+    * @brief Rewrites the file with one record per key, keeping only the most
+    * recently appended solutions if a limit is given. The new file replaces
+    * the old one atomically; other processes switch to it on refresh().
+    * @param maxSolutions the number of solutions to keep, 0 to keep them all
+    * @throw std::runtime_error if the new file can't be written
+    */
+    void compact( std::size_t maxSolutions = 0 );
+    /**
+    * @brief Gets the number of solutions in the store.
+    * @return the number of solutions.
+    */
+    std::size_t size() const;
+    /**
+    * @brief Gets the size of the store file.
+    * @return the size of the file in bytes.
+    */
+    std::size_t fileSize() const;
+
+private:
+    std::string m_path;
+    int m_fd = -1;
+    std::uint64_t m_inode = 0;
+    const unsigned char* m_map = nullptr;
+    std::size_t m_mapSize = 0;
+    // end of the last valid record
+    std::size_t m_end = 0;
+    std::unordered_map<Digest, std::size_t, DigestHasher> m_index;
+    std::vector<unsigned char> m_record;
+    mutable std::shared_timed_mutex m_mutex;
+
+    void open();
+    void close() noexcept;
+    /**
+    * @brief Checks that the path still names the open file, i.e. that no other
+    * process compacted it since. Writers check it again once they hold the
+    * file lock, as a compaction may have replaced the file while they waited.
+    */
+    bool isCurrent() const noexcept;
+    void map( std::size_t size );
+    void scan();
+    /**
+    * @brief Drops what a crashed writer left after the last valid record, so
+    * that the records appended next are found. Needs the file lock.
+    */
+    void truncateTorn();
+};
+
+} // namespace
@@ -0,0 +1,179 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "Board.h"
+#include "PerfCounters.h"
+#include "SharedTranspositionTable.h"
+
+namespace Sudoku
+{
+
+/**
+* @brief Flag shared between copies, used to ask a running solve to stop.
+* It can be cancelled from any thread.
+*/
+class CancellationToken
+{
+public:
+    CancellationToken() :
+        m_cancelled( std::make_shared<std::atomic<bool>>( false ) )
+    {
+    }
+    /**
+    * @brief Requests every solve observing this token to stop.
+    */
+    void cancel() noexcept
+    {
+        m_cancelled->store( true, std::memory_order_relaxed );
+    }
+    /**
+    * @brief Checks if cancellation was requested.
+    * @return True if cancel() was called on this token or a copy of it.
+    */
+    bool cancelled() const noexcept
+    {
+        return m_cancelled->load( std::memory_order_relaxed );
+    }
+
+private:
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+};
+
+/**
+* @brief Order in which the search tries the possible values of a cell.
+*/
+enum class ValueOrder
+{
+    /**
+    * @brief Smallest value first.
+    */
+    Ascending,
+    /**
+    * @brief A random order, reproducible from SolveOptions::seed.
+    */
+    Random,
+    /**
+    * @brief The value the fewest unassigned peers of the cell can still
+    * take first, as it removes the fewest possibilities.
+    */
+    LeastConstraining,
+    /**
+    * @brief The value of the cell that led to the fewest dead ends so far
+    * in the search first.
+    */
+    History
+};
+
+/**
+* @brief Limits and heuristics applied to a solve. Default constructed
+* options impose no limits.
+*/
+struct SolveOptions
+{
+    using Clock = std::chrono::steady_clock;
+
+    /**
+    * @brief The solve stops once this point in time is reached.
+    */
+    Clock::time_point deadline = Clock::time_point::max();
+    /**
+    * @brief The solve stops once this many assignments were tried. 0 means no limit.
+    */
+    std::size_t maxNodes = 0;
+    /**
+    * @brief The solve stops once this token is cancelled.
+    */
+    CancellationToken cancellation;
+    /**
+    * @brief Order in which the possible values of a cell are tried.
+    */
+    ValueOrder valueOrder = ValueOrder::Ascending;
+    /**
+    * @brief Seed for the randomized heuristics.
+    */
+    std::uint64_t seed = 0;
+    /**
+    * @brief If set, the visited states are shared with the other searches
+    * given the same table, each skipping the states another one took. A
+    * search sharing states can then only prove that a board has no solution
+    * once all the searches sharing the table are exhausted.
+    */
+    std::shared_ptr<SharedTranspositionTable> sharedStates;
+};
+
+/**
+* @brief How a solve finished.
+*/
+enum class SolveStatus
+{
+    Solved,
+    Unsolvable,
+    DeadlineExceeded,
+    NodeLimitExceeded,
+    Cancelled
+};
+
+/**
+* @brief Gets a short upper case name for a solve status, e.g. "SOLVED".
+* @param status the status
+* @return the name of the status.
+*/
+inline const char* toString( SolveStatus status ) noexcept
+{
+    switch( status )
+    {
+    case SolveStatus::Solved:
+        return "SOLVED";
+    case SolveStatus::Unsolvable:
+        return "UNSOLVABLE";
+    case SolveStatus::DeadlineExceeded:
+        return "TIMEOUT";
+    case SolveStatus::NodeLimitExceeded:
+        return "NODELIMIT";
+    case SolveStatus::Cancelled:
+        return "CANCELLED";
+    }
+    return "UNKNOWN";
+}
+
+/**
+* @brief Statistics gathered during a solve, complete or not.
+*/
+struct SolveStats
+{
+    std::size_t nodes = 0;
+    std::size_t visitedStates = 0;
+    std::size_t maxDepth = 0;
+    /**
+    * @brief With SolveOptions::sharedStates, the probes that found a state
+    * already visited and those that lost a slot to another thread.
+    */
+    std::size_t sharedHits = 0;
+    std::size_t sharedCollisions = 0;
+    std::chrono::duration<double> elapsed{ 0 };
+    /**
+    * @brief With PerfCounters enabled, the hardware events of the whole solve
+    * and of its propagation; the rest is spent searching.
+    */
+    PerfSample counters;
+    PerfSample propagationCounters;
+};
+
+/**
+* @brief Outcome of a solve.
+*/
+struct SolveResult
+{
+    SolveStatus status;
+    /**
+    * @brief The solution if status is SolveStatus::Solved, the input board otherwise.
+    */
+    Board board;
+    SolveStats stats;
+};
+
+} // namespace
@@ -1,9 +1,8 @@
-#include <unordered_set>
-#include <string>
+#include <algorithm>
 
+#include "PerfCounters.h"
 #include "Solver.h"
-#include "BoardHasher.h"
-#include "Utils.h"
+#include "Trace.h"
 
 
 #ifdef DEBUG
@@ -19,93 +18,174 @@
 
 using namespace Sudoku;
 
-namespace Sudoku{
-    bool solve( Board b, std::unordered_set<size_t>& visitedStates, Board& solution );
-}
-
 /**
-* Solve a board using recursion backtracking.
-* @param b The board to solve in this recursion
-* @param visitedStates A set of hashes of boards to check if we already visited a given state
-* @param solution The board to copy the solution to in case we solve
-* @return True if the board was solved, false otherwise
+* @brief Solves the given board using backtracking.
+* @param board The board to solve.
+* @return The solved board, or 'board' if no solution was found.
 */
-bool Sudoku::solve( Board b, std::unordered_set<size_t>& visitedStates, Board& solution )
+Board Sudoku::solve( Board board )
 {
-    static BoardHasher boardHasher;
+    return solve( board, SolveOptions{} ).board;
+}
+
+
+SolveResult Sudoku::solve( const Board& board, const SolveOptions& options )
+{
+    // kept by the thread, so that its memory is reused from one solve to the next
+    thread_local SolverContext context( board.blockSize() );
+    return solve( board, options, context );
+}
 
-    DEBUG( "Board is " << std::endl << b );
 
-    if( b.isSolved() )
+namespace
+{
+/**
+* @brief Steps a search until it stops or one of the limits in the options is reached.
+* @return The status matching the reason the search was stopped, SolveStatus::Solved
+* or SolveStatus::Unsolvable if it stopped on its own.
+*/
+SolveStatus runSearch( Search& search, const SolveOptions& options, SolveStats& stats )
+{
+    while( search.status() == Search::Status::Running )
     {
-        DEBUG( "Solved!!!" << std::endl << b );
-        solution = b;
-        return true;
+        if( options.cancellation.cancelled() )
+            return SolveStatus::Cancelled;
+        if( options.maxNodes != 0 && search.nodes() >= options.maxNodes )
+            return SolveStatus::NodeLimitExceeded;
+        if( SolveOptions::Clock::now() >= options.deadline )
+            return SolveStatus::DeadlineExceeded;
+
+        search.step();
+        stats.maxDepth = std::max( stats.maxDepth, search.frames().size() );
     }
-    DEBUG( "not solved" );
 
-    auto list = b.sortedPossibilities();
+    return search.status() == Search::Status::Solved ? SolveStatus::Solved : SolveStatus::Unsolvable;
+}
+}
 
-    if( list.empty() )
-        return false;
 
-    auto& vals = list.front();
+const SolveResult& Sudoku::solve( const Board& board, const SolveOptions& options, SolverContext& context )
+{
+    const auto start = SolveOptions::Clock::now();
+    TraceScope trace( "solve" );
+    const bool counting = PerfCounters::enabled();
+    PerfSample counters;
+    PerfSample propagation;
+    if( counting )
+    {
+        counters = PerfCounters::read();
+        propagation = PerfCounters::propagation();
+    }
+
+    context.reset( board, options );
+    auto& search = context.search();
+    auto& result = context.result();
 
-    for( auto& n : vals.possibilities )
+    result.status = runSearch( search, options, result.stats );
+    if( result.status == SolveStatus::Solved )
     {
-        Board current( b );
-        auto row = vals.row;
-        auto col = vals.col;
+        result.board = search.board();
+    }
 
-        current.set( row, col, n );
+    result.stats.nodes = search.nodes();
+    result.stats.visitedStates = search.visitedStates();
+    result.stats.sharedHits = search.sharedStatistics().hits;
+    result.stats.sharedCollisions = search.sharedStatistics().collisions;
+    result.stats.elapsed = SolveOptions::Clock::now() - start;
+    if( counting )
+    {
+        result.stats.counters = PerfCounters::read();
+        result.stats.counters -= counters;
+        result.stats.propagationCounters = PerfCounters::propagation();
+        result.stats.propagationCounters -= propagation;
+    }
+    trace.setArg( "nodes", result.stats.nodes );
 
-        auto hash = boardHasher( current );
+    DEBUG( "states visited: " << result.stats.visitedStates );
+    return result;
+}
 
-        if( visitedStates.find( hash ) != visitedStates.end() )
-            continue;
 
-        DEBUG( "not yet visited" );
+const SolveResult& Sudoku::solve( const Board::InputArray& givens, const SolveOptions& options, SolverContext& context, SolutionLookup& cache )
+{
+    const auto start = SolveOptions::Clock::now();
+    const auto dim = static_cast< Num >( givens.size() );
 
-        visitedStates.insert( hash );
+    auto& canonicalizer = context.canonicalizer();
+    canonicalizer.canonicalize( givens );
+    Num blockSize = 1;
+    while( blockSize * blockSize < dim )
+    {
+        ++blockSize;
+    }
 
-        DEBUG( "Trying (" << std::to_string( row ) << "," << std::to_string( col ) << ") set to " << static_cast< int >( n ) );
-        DEBUG( "board after update: " << std::endl << current << std::endl );
+    Nums canonical;
+    if( cache.find( canonicalizer.digest(), canonical ) )
+    {
+        Board::InputArray values;
+        canonicalizer.fromCanonical( canonical, values );
 
-        if( current.isValid() )
+        // guards against digest collisions: the solution must keep the givens
+        bool matches = true;
+        for( Num i = 0; i < dim && matches; ++i )
         {
-            if( solve( current, visitedStates, solution ) )
+            for( Num j = 0; j < dim && matches; ++j )
             {
-                return true;
+                matches = givens[i][j] == 0 || givens[i][j] == values[i][j];
             }
         }
-#ifndef NDEBUG
-        else
+
+        if( matches )
         {
-            auto offending = current.offendingVal();
-            DEBUG( "NOT valid: " << std::to_string( std::get<0>( offending ) )<< ", " << std::to_string( std::get<1>( offending ) )<< ", "
-                << std::to_string( std::get<2>( offending ) ) << ", " << std::to_string( std::get<3>( offending ) ) << ", " << std::to_string( std::get<4>( offending ) ) );
+            Trace::instant( "cache hit", nullptr, 0 );
+            auto& result = context.result();
+            result.status = SolveStatus::Solved;
+            result.board = Board( blockSize, values );
+            result.stats = SolveStats{};
+            result.stats.elapsed = SolveOptions::Clock::now() - start;
+            return result;
         }
-#endif
     }
 
-    return false;
+    solve( Board( blockSize, givens ), options, context );
+    auto& result = context.result();
+    if( result.status == SolveStatus::Solved )
+    {
+        Nums values( dim * dim );
+        for( Num i = 0; i < dim; ++i )
+        {
+            for( Num j = 0; j < dim; ++j )
+            {
+                values[i * dim + j] = result.board.at( i, j );
+            }
+        }
+        canonicalizer.toCanonical( values, canonical );
+        cache.insert( canonicalizer.digest(), canonical );
+    }
+    result.stats.elapsed = SolveOptions::Clock::now() - start;
+    return result;
 }
 
 
-/**
-* @brief Solves the given board using backtracking.
-* @param board The board to solve.
-* @return The solved board, or 'board' if no solution was found.
-*/
-Board Sudoku::solve( Board board )
+SolutionCount Sudoku::countSolutions( const Board& board, std::size_t limit, const SolveOptions& options, SolverContext& context )
 {
-    std::unordered_set<size_t> visitedStates;
-    Board solution{ board.blockSize() };
+    SolutionCount count{ 0, SolveStatus::Unsolvable };
+
+    context.reset( board, options );
+    auto& search = context.search();
+    auto& stats = context.result().stats;
 
-    if( solve( board, visitedStates, solution ) )
+    while( count.solutions < limit )
     {
-        DEBUG( "states visited: " << visitedStates.size() );
-        return solution;
+        count.status = runSearch( search, options, stats );
+        if( count.status != SolveStatus::Solved )
+            break;
+
+        ++count.solutions;
+        search.resume();
     }
-    return board;
+
+    stats.nodes = search.nodes();
+    stats.visitedStates = search.visitedStates();
+    return count;
 }
@@ -1,12 +1,75 @@
 #pragma once
 #include "Board.h"
+#include "SolutionLookup.h"
+#include "SolveOptions.h"
+#include "SolverContext.h"
 
 namespace Sudoku
 {
+    /**
+    * @brief Outcome of countSolutions().
+    */
+    struct SolutionCount
+    {
+        /**
+        * @brief Number of solutions found, at most the limit requested.
+        */
+        std::size_t solutions;
+        /**
+        * @brief SolveStatus::Solved if the limit was reached, SolveStatus::Unsolvable
+        * if the search was exhausted first. In both cases 'solutions' is exact up to
+        * the limit. Any other status means a limit of the options stopped the count early.
+        */
+        SolveStatus status;
+    };
+
     /**
     * @brief Solves the given board using backtracking.
     * @param board The board to solve.
     * @return The solved board, or 'board' if no solution was found.
     */
     Board solve( Board board );
+    /**
+    * @brief Solves the given board using backtracking, stopping early if
+    * any of the limits in the options is reached.
+    * @param board The board to solve.
+    * @param options The limits to apply to the solve.
+    * @return The outcome of the solve along with its statistics.
+    */
+    SolveResult solve( const Board& board, const SolveOptions& options );
+    /**
+    * @brief Solves the given board like solve( board, options ), reusing the
+    * memory of a context left over from previous solves.
+    * @param board The board to solve.
+    * @param options The limits to apply to the solve.
+    * @param context The context to reset and solve the board with.
+    * @return The outcome of the solve, stored in the context and valid until
+    * its next use.
+    */
+    const SolveResult& solve( const Board& board, const SolveOptions& options, SolverContext& context );
+    /**
+    * @brief Solves a puzzle like solve( board, options, context ), looking the
+    * canonical form of its givens up in a solution cache or store first. On a hit the
+    * cached solution is mapped back to the puzzle's orientation and no search
+    * is done (the nodes count is 0); on a miss the solution found, if any, is
+    * added to the cache.
+    * @param givens The values of the puzzle, 0 denoting empty cells.
+    * @param options The limits to apply to the solve.
+    * @param context The context to reset and solve the board with.
+    * @param cache The cache or store shared by the solves of equivalent puzzles.
+    * @return The outcome of the solve, stored in the context and valid until
+    * its next use.
+    * @throw std::invalid_argument if the givens are not a valid board
+    */
+    const SolveResult& solve( const Board::InputArray& givens, const SolveOptions& options, SolverContext& context, SolutionLookup& cache );
+    /**
+    * @brief Counts the solutions of a board, stopping as soon as 'limit' of
+    * them are found. Counting up to 2 checks whether a solution is unique.
+    * @param board The board whose solutions to count.
+    * @param limit The number of solutions after which to stop.
+    * @param options The limits to apply to the whole count.
+    * @param context The context to reset and search the board with.
+    * @return The number of solutions found and why the count stopped.
+    */
+    SolutionCount countSolutions( const Board& board, std::size_t limit, const SolveOptions& options, SolverContext& context );
 }
@@ -0,0 +1,20 @@
+#include "SolverContext.h"
+
+using Sudoku::SolverContext;
+using Sudoku::Board;
+using Sudoku::Num;
+
+SolverContext::SolverContext( Num blockSize ) :
+    m_search( Board( blockSize ) ),
+    m_result{ SolveStatus::Unsolvable, Board( blockSize ), {} }
+{
+}
+
+
+void SolverContext::reset( const Board& board, const SolveOptions& options )
+{
+    m_search.reset( board, options.valueOrder, options.seed, options.sharedStates.get() );
+    m_result.status = SolveStatus::Unsolvable;
+    m_result.board = board;
+    m_result.stats = SolveStats{};
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <memory>
+
+#include "Board.h"
+#include "Canonicalizer.h"
+#include "Search.h"
+#include "SolveOptions.h"
+
+namespace Sudoku
+{
+
+/**
+* @brief Scratch memory for solving boards, meant to be kept by a thread and
+* reused for every board it solves. It owns the search (frame stack, visited
+* states table and the working board with its change record and propagation
+* buffers), the canonicalizer used for cache lookups, built on first use, and
+* the result of the last solve. Once it has solved a board of a given size,
+* further solves of boards of that size don't allocate.
+*/
+class SolverContext
+{
+public:
+    /**
+    * @brief Constructs a context, with its memory sized for boards of the
+    * given block size.
+    * @param blockSize the block size of the boards expected
+    */
+    explicit SolverContext( Num blockSize = 3 );
+    /**
+    * @brief Prepares the context for solving another board. This only resets
+    * sizes and counters, the memory is kept.
+    * @param board the board to solve next
+    * @param options the heuristics to solve it with
+    */
+    void reset( const Board& board, const SolveOptions& options = {} );
+    /**
+    * @brief Gets the search of the board passed to the last reset().
+    * @return the search.
+    */
+    Search& search() noexcept
+    {
+        return m_search;
+    }
+    /**
+    * @brief Gets the result slot reused by every solve done with this context.
+    * @return the result slot.
+    */
+    SolveResult& result() noexcept
+    {
+        return m_result;
+    }
+    /**
+    * @brief Gets the canonicalizer used to look boards up in a solution cache.
+    * @return the canonicalizer.
+    */
+    Canonicalizer& canonicalizer()
+    {
+        if( !m_canonicalizer )
+            m_canonicalizer.reset( new Canonicalizer() );
+        return *m_canonicalizer;
+    }
+
+private:
+    Search m_search;
+    // only the solves looking up a cache need it
+    std::unique_ptr<Canonicalizer> m_canonicalizer;
+    SolveResult m_result;
+};
+
+} // namespace
@@ -0,0 +1,177 @@
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Trace.h"
+
+using Sudoku::Trace;
+
+constexpr std::size_t Trace::DefaultCapacity;
+constexpr std::uint64_t Trace::NoDuration;
+std::atomic<bool> Trace::s_enabled{ false };
+
+namespace
+{
+struct Event
+{
+    const char* name;
+    const char* argName;
+    std::uint64_t start;
+    std::uint64_t duration;
+    std::uint64_t arg;
+};
+
+/**
+* @brief The events of a thread. Only its thread writes to it; it outlives
+* the thread so that the events can be written after it ended.
+*/
+struct Buffer
+{
+    std::vector<Event> events;
+    // where the next event goes, the oldest one once the buffer wrapped
+    std::size_t next = 0;
+    bool wrapped = false;
+    std::size_t thread;
+};
+
+std::mutex registryMutex;
+std::vector<std::shared_ptr<Buffer>> buffers;
+std::size_t capacity = Trace::DefaultCapacity;
+std::uint64_t origin = 0;
+// bumped when the buffers are dropped, so that threads register new ones
+std::atomic<std::size_t> generation{ 0 };
+
+/**
+* @brief Gets the calling thread's buffer, registering one if the buffers
+* were dropped since it last recorded.
+*/
+Buffer* threadBuffer()
+{
+    thread_local std::shared_ptr<Buffer> buffer;
+    thread_local std::size_t bufferGeneration = 0;
+
+    const auto current = generation.load( std::memory_order_acquire );
+    if( !buffer || bufferGeneration != current )
+    {
+        std::lock_guard<std::mutex> lock( registryMutex );
+        buffer = std::make_shared<Buffer>();
+        buffer->events.resize( capacity );
+        buffer->thread = buffers.size();
+        buffers.push_back( buffer );
+        bufferGeneration = current;
+    }
+    return buffer.get();
+}
+
+/**
+* @brief Writes a time in nanoseconds as microseconds, the unit of the format.
+*/
+void writeMicros( std::ostream& stream, std::uint64_t nanos )
+{
+    const auto fraction = nanos % 1000;
+    stream << nanos / 1000 << '.' << fraction / 100 << fraction / 10 % 10 << fraction % 10;
+}
+}
+
+
+void Trace::enable( std::size_t eventsPerThread )
+{
+    {
+        std::lock_guard<std::mutex> lock( registryMutex );
+        buffers.clear();
+        capacity = eventsPerThread ? eventsPerThread : 1;
+        origin = now();
+        generation.fetch_add( 1, std::memory_order_release );
+    }
+    s_enabled.store( true, std::memory_order_relaxed );
+}
+
+
+void Trace::disable() noexcept
+{
+    s_enabled.store( false, std::memory_order_relaxed );
+}
+
+
+void Trace::clear()
+{
+    std::lock_guard<std::mutex> lock( registryMutex );
+    buffers.clear();
+    origin = now();
+    generation.fetch_add( 1, std::memory_order_release );
+}
+
+
+std::size_t Trace::size()
+{
+    std::lock_guard<std::mutex> lock( registryMutex );
+    std::size_t count = 0;
+    for( const auto& buffer : buffers )
+    {
+        count += buffer->wrapped ? buffer->events.size() : buffer->next;
+    }
+    return count;
+}
+
+
+std::uint64_t Trace::now() noexcept
+{
+    return std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+
+void Trace::record( const char* name, std::uint64_t start, std::uint64_t duration, const char* argName, std::uint64_t arg ) noexcept
+{
+    Buffer* buffer = nullptr;
+    try
+    {
+        buffer = threadBuffer();
+    }
+    catch( ... )
+    {
+        // without memory for a buffer, the events of the thread are lost
+        return;
+    }
+
+    buffer->events[buffer->next] = { name, argName, start, duration, arg };
+    if( ++buffer->next == buffer->events.size() )
+    {
+        buffer->next = 0;
+        buffer->wrapped = true;
+    }
+}
+
+
+void Trace::write( std::ostream& stream )
+{
+    std::lock_guard<std::mutex> lock( registryMutex );
+    stream << "{\"traceEvents\":[";
+    bool first = true;
+    for( const auto& buffer : buffers )
+    {
+        const auto count = buffer->wrapped ? buffer->events.size() : buffer->next;
+        const auto begin = buffer->wrapped ? buffer->next : 0;
+        for( std::size_t i = 0; i < count; ++i )
+        {
+            const auto& event = buffer->events[( begin + i ) % buffer->events.size()];
+            stream << ( first ? "\n" : ",\n" ) << "{\"name\":\"" << event.name << "\",\"pid\":1,\"tid\":" << buffer->thread << ",\"ts\":";
+            // events started before enable() are clamped to the origin
+            writeMicros( stream, event.start > origin ? event.start - origin : 0 );
+            if( event.duration == NoDuration )
+            {
+                stream << ",\"ph\":\"i\",\"s\":\"t\"";
+            }
+            else
+            {
+                stream << ",\"ph\":\"X\",\"dur\":";
+                writeMicros( stream, event.duration );
+            }
+            if( event.argName )
+                stream << ",\"args\":{\"" << event.argName << "\":" << event.arg << '}';
+            stream << '}';
+            first = false;
+        }
+    }
+    stream << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace Sudoku
+{
+
+/**
+* @brief Timeline of what the solvers do, for finding where the time of a slow
+* solve goes. Events are recorded into a ring buffer per thread, which keeps
+* the latest ones, and dumped in the Chrome trace event format, which
+* chrome://tracing and Perfetto display. Tracing is off by default, and each
+* instrumentation point then costs a relaxed load and a branch.
+*/
+class Trace
+{
+public:
+    /**
+    * @brief Events kept per thread by default.
+    */
+    static constexpr std::size_t DefaultCapacity = std::size_t( 1 ) << 16;
+
+    /**
+    * @brief Starts recording, dropping the events recorded so far.
+    * @param capacity the number of events kept per thread
+    */
+    static void enable( std::size_t capacity = DefaultCapacity );
+    /**
+    * @brief Stops recording. The events recorded are kept until enable() or
+    * clear().
+    */
+    static void disable() noexcept;
+    static bool enabled() noexcept
+    {
+        return s_enabled.load( std::memory_order_relaxed );
+    }
+    /**
+    * @brief Drops the events recorded.
+    */
+    static void clear();
+    /**
+    * @brief Writes the events recorded as a Chrome trace JSON object, each
+    * thread's in order. Not safe while other threads record.
+    */
+    static void write( std::ostream& stream );
+    /**
+    * @brief Counts the events recorded and kept, on all threads.
+    */
+    static std::size_t size();
+
+    /**
+    * @brief Records an event that happened at a point in time, if tracing.
+    * @param name the name of the event, a string literal
+    * @param argName the name of its argument, a string literal
+    * @param arg the value of its argument
+    */
+    static void instant( const char* name, const char* argName, std::uint64_t arg ) noexcept
+    {
+        if( enabled() )
+            record( name, now(), NoDuration, argName, arg );
+    }
+
+    /**
+    * @brief Gets the current time in nanoseconds.
+    */
+    static std::uint64_t now() noexcept;
+    /**
+    * @brief Records an event in the calling thread's buffer, see TraceScope
+    * and instant().
+    * @param duration the duration in nanoseconds, NoDuration for an instant
+    */
+    static void record( const char* name, std::uint64_t start, std::uint64_t duration, const char* argName, std::uint64_t arg ) noexcept;
+
+    static constexpr std::uint64_t NoDuration = ~std::uint64_t( 0 );
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+/**
+* @brief Records the time spent in a scope as a trace event, if tracing when
+* the scope starts.
+*/
+class TraceScope
+{
+public:
+    /**
+    * @param name the name of the event, a string literal
+    * @param argName the name of its argument, a string literal, or nullptr
+    * @param arg the value of its argument
+    */
+    explicit TraceScope( const char* name, const char* argName = nullptr, std::uint64_t arg = 0 ) noexcept :
+        m_name( Trace::enabled() ? name : nullptr ),
+        m_argName( argName ),
+        m_arg( arg )
+    {
+        if( m_name )
+            m_start = Trace::now();
+    }
+    TraceScope( const TraceScope& ) = delete;
+    TraceScope& operator=( const TraceScope& ) = delete;
+    ~TraceScope()
+    {
+        if( m_name )
+            Trace::record( m_name, m_start, Trace::now() - m_start, m_argName, m_arg );
+    }
+
+    /**
+    * @brief Sets the argument of the event, e.g. a count known at the end.
+    */
+    void setArg( const char* argName, std::uint64_t arg ) noexcept
+    {
+        m_argName = argName;
+        m_arg = arg;
+    }
+
+private:
+    const char* m_name;
+    const char* m_argName;
+    std::uint64_t m_arg;
+    std::uint64_t m_start = 0;
+};
+
+} // namespace
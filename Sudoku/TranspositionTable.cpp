@@ -0,0 +1,88 @@
+#include <algorithm>
+
+#include "TranspositionTable.h"
+
+using Sudoku::TranspositionTable;
+
+TranspositionTable::TranspositionTable( std::size_t capacity )
+{
+    unsigned bits = 4;
+    while( ( std::size_t( 1 ) << bits ) < capacity )
+    {
+        ++bits;
+    }
+    m_slots.assign( std::size_t( 1 ) << bits, Slot{ 0, 0 } );
+    m_shift = 64 - bits;
+}
+
+
+bool TranspositionTable::insert( std::size_t hash )
+{
+    // keep the load factor under 3/4 so probe sequences stay short
+    if( ( m_size + 1 ) * 4 > m_slots.size() * 3 )
+        grow();
+
+    const auto mask = m_slots.size() - 1;
+    for( auto i = home( hash );; i = ( i + 1 ) & mask )
+    {
+        auto& slot = m_slots[i];
+        if( slot.generation != m_generation )
+        {
+            slot = { hash, m_generation };
+            ++m_size;
+            return true;
+        }
+        if( slot.hash == hash )
+            return false;
+    }
+}
+
+
+bool TranspositionTable::contains( std::size_t hash ) const noexcept
+{
+    const auto mask = m_slots.size() - 1;
+    for( auto i = home( hash );; i = ( i + 1 ) & mask )
+    {
+        const auto& slot = m_slots[i];
+        if( slot.generation != m_generation )
+            return false;
+        if( slot.hash == hash )
+            return true;
+    }
+}
+
+
+void TranspositionTable::clear() noexcept
+{
+    m_size = 0;
+    if( ++m_generation == 0 )
+    {
+        // the generation wrapped around: stale slots could look current again
+        std::fill( m_slots.begin(), m_slots.end(), Slot{ 0, 0 } );
+        m_generation = 1;
+    }
+}
+
+
+std::size_t TranspositionTable::home( std::size_t hash ) const noexcept
+{
+    // Fibonacci hashing spreads hashes that only differ in their high bits
+    return static_cast< std::size_t >( ( static_cast< std::uint64_t >( hash ) * 0x9E3779B97F4A7C15ull ) >> m_shift );
+}
+
+
+void TranspositionTable::grow()
+{
+    std::vector<Slot> old( m_slots.size() * 2, Slot{ 0, 0 } );
+    old.swap( m_slots );
+    --m_shift;
+
+    const auto generation = m_generation;
+    m_generation = 1;
+    m_size = 0;
+    for( const auto& slot : old )
+    {
+        if( slot.generation == generation )
+            insert( slot.hash );
+    }
+}
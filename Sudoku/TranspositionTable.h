@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Sudoku
+{
+
+/**
+* @brief Set of board hashes used by the search to skip states it already
+* visited. It is an open addressing table that keeps its memory when cleared,
+* and clearing it is O(1), so it can be reused between solves without allocating.
+*/
+class TranspositionTable
+{
+public:
+    /**
+    * @brief Constructs an empty table.
+    * @param capacity the initial number of slots, rounded up to a power of 2
+    */
+    explicit TranspositionTable( std::size_t capacity = 1024 );
+    /**
+    * @brief Adds a hash to the table. The table grows if it gets too full.
+    * @param hash the hash to add
+    * @return True if the hash was added, false if it was already in the table.
+    */
+    bool insert( std::size_t hash );
+    /**
+    * @brief Checks if a hash is in the table.
+    * @param hash the hash to look for
+    * @return True if the hash is in the table, false otherwise.
+    */
+    bool contains( std::size_t hash ) const noexcept;
+    /**
+    * @brief Removes every hash, keeping the allocated slots.
+    */
+    void clear() noexcept;
+    /**
+    * @brief Gets the number of hashes in the table.
+    * @return the number of hashes in the table.
+    */
+    std::size_t size() const noexcept
+    {
+        return m_size;
+    }
+    /**
+    * @brief Gets the number of slots in the table.
+    * @return the number of slots in the table.
+    */
+    std::size_t capacity() const noexcept
+    {
+        return m_slots.size();
+    }
+
+private:
+    /**
+    * @brief A slot is in use if its generation matches the table's.
+    */
+    struct Slot
+    {
+        std::size_t hash;
+        std::uint32_t generation;
+    };
+
+    std::vector<Slot> m_slots;
+    unsigned m_shift;
+    std::size_t m_size = 0;
+    std::uint32_t m_generation = 1;
+
+    /**
+    * @brief Gets the first slot to probe for a hash.
+    */
+    std::size_t home( std::size_t hash ) const noexcept;
+    /**
+    * @brief Doubles the number of slots, re-inserting the current hashes.
+    */
+    void grow();
+};
+
+} // namespace
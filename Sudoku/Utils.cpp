@@ -1,7 +1,8 @@
 #include "Utils.h"
+#include "ResultWriter.h"
+#include <chrono>
 #include <string>
 #include <stdexcept>
-#include <iomanip>
 
 void Sudoku::checkCoord( Num Dims, Num coord )
 {
@@ -21,21 +22,66 @@ void Sudoku::checkValue( Num Dims, Num value )
         throw std::invalid_argument( "invalid value: " + std::to_string( value ) );
 }
 
-std::ostream& operator<<( std::ostream& stream, const Sudoku::Board& board )
+namespace
 {
-    auto width = board.dimension() / 9;
-    if( board.dimension() % 9 )
-    {
-        width++;
-    }
+template<typename Get>
+std::string writeLine( Sudoku::Num dimension, Get&& get )
+{
+    std::string line;
+    const bool separated = dimension > 9;
 
-    for( Sudoku::Num i = 0; i < board.dimension(); ++i )
+    for( Sudoku::Num i = 0; i < dimension; ++i )
     {
-        for( Sudoku::Num j = 0; j < board.dimension(); ++j )
+        for( Sudoku::Num j = 0; j < dimension; ++j )
         {
-            stream << std::setw( width ) << std::dec << std::to_string( board.at( i, j ) ) << " ";
+            if( separated )
+            {
+                if( !line.empty() )
+                    line += ' ';
+                line += std::to_string( get( i, j ) );
+            }
+            else
+            {
+                line += static_cast< char >( '0' + get( i, j ) );
+            }
         }
-        stream << std::endl;
     }
+    return line;
+}
+}
+
+std::string Sudoku::toLine( const Board& board )
+{
+    return writeLine( board.dimension(), [&board]( Num i, Num j ) { return board.at( i, j ); } );
+}
+
+std::string Sudoku::toLine( const Board::InputArray& values )
+{
+    return writeLine( values.size(), [&values]( Num i, Num j ) { return values[i][j]; } );
+}
+
+std::string Sudoku::toLine( const SolveResult& result )
+{
+    const auto micros = std::chrono::duration_cast< std::chrono::microseconds >( result.stats.elapsed ).count();
+
+    std::string line = toString( result.status );
+    line += ' ';
+    line += result.status == SolveStatus::Solved ? toLine( result.board ) : "-";
+    line += ' ';
+    line += std::to_string( result.stats.nodes );
+    line += ' ';
+    line += std::to_string( micros );
+    return line;
+}
+
+std::ostream& operator<<( std::ostream& stream, const Sudoku::Board& board )
+{
+    // formatted at once and written in a single call, without flushing
+    Sudoku::ResultWriter writer( [&stream]( const char* data, std::size_t size )
+        {
+            stream.write( data, size );
+            return static_cast< bool >( stream );
+        }, Sudoku::OutputFormat::Grid, false, 0 );
+    writer.write( board );
     return stream;
 }
@@ -1,9 +1,11 @@
 #pragma once
 #include <algorithm>
 #include <ostream>
+#include <string>
 
 #include "Board.h"
 #include "Common.h"
+#include "SolveOptions.h"
 
 namespace Sudoku
 {
@@ -32,6 +34,31 @@ namespace Sudoku
 */
     void checkValue( Num Dims, Num value );
 
+/**
+* @brief Writes a board in the compact line format read by parseLine: one
+* character per cell for boards of dimension up to 9, space separated numbers
+* otherwise. Empty cells are written as 0.
+* @param board the board to write
+* @return The board in compact line format, without a line terminator
+*/
+    std::string toLine( const Board& board );
+
+/**
+* @brief Writes board values in the compact line format, see toLine( const Board& ).
+* @param values the values to write, 0 denoting empty cells
+* @return The values in compact line format, without a line terminator
+*/
+    std::string toLine( const Board::InputArray& values );
+
+/**
+* @brief Writes the outcome of a solve on a single line: its status, the
+* solution in compact line format or "-" if there is none, the nodes searched
+* and the time taken in microseconds.
+* @param result the outcome to write
+* @return The outcome, without a line terminator
+*/
+    std::string toLine( const SolveResult& result );
+
 /**
 * @brief Checks if a vector of Num contains a value
 * @param nums the vector to perform the check on
@@ -0,0 +1,171 @@
+#include <algorithm>
+
+#include "Verifier.h"
+
+using Sudoku::Num;
+using Sudoku::Verdict;
+using Sudoku::Verifier;
+
+constexpr std::size_t Verifier::Lanes;
+
+namespace
+{
+constexpr Num StandardDimension = 9;
+constexpr Num StandardCells = StandardDimension * StandardDimension;
+constexpr std::uint64_t LaneMask = ( std::uint64_t( 1 ) << StandardDimension ) - 1;
+}
+
+
+const char* Sudoku::toString( Verdict verdict ) noexcept
+{
+    switch( verdict )
+    {
+    case Verdict::Valid:
+        return "VALID";
+    case Verdict::Incomplete:
+        return "INCOMPLETE";
+    case Verdict::Invalid:
+        return "INVALID";
+    case Verdict::Mismatch:
+        return "MISMATCH";
+    }
+    return "UNKNOWN";
+}
+
+
+Verifier::Verifier( Num blockSize ) :
+    Verifier( Layout( blockSize ) )
+{
+}
+
+
+Verifier::Verifier( const Layout& layout ) :
+    m_layout( layout ),
+    m_cells( layout.dimension() * layout.dimension() ),
+    m_lanes( layout.isStandard() && layout.dimension() == StandardDimension ),
+    m_seen( layout.dimension() / 64 + 1 )
+{
+}
+
+
+Verdict Verifier::verify( const Num* puzzle, const Num* solution ) noexcept
+{
+    const auto dim = m_layout.dimension();
+    bool empty = false;
+    bool outOfRange = false;
+    for( std::size_t cell = 0; cell < m_cells; ++cell )
+    {
+        const auto value = solution[cell];
+        if( puzzle && puzzle[cell] != 0 && puzzle[cell] != value )
+            return Verdict::Mismatch;
+        empty |= value == 0;
+        outOfRange |= value > dim;
+    }
+    if( empty )
+        return Verdict::Incomplete;
+    if( outOfRange )
+        return Verdict::Invalid;
+
+    // with dimension values in range and none repeating, a unit holds them all
+    const auto units = m_layout.unitCount();
+    for( std::size_t unit = 0; unit < units; ++unit )
+    {
+        std::fill( m_seen.begin(), m_seen.end(), 0 );
+        const auto* cells = m_layout.unit( unit );
+        for( Num position = 0; position < dim; ++position )
+        {
+            const auto value = solution[cells[position]] - 1;
+            const auto bit = std::uint64_t( 1 ) << ( value % 64 );
+            auto& word = m_seen[value / 64];
+            if( word & bit )
+                return Verdict::Invalid;
+            word |= bit;
+        }
+    }
+
+    for( const auto& cage : m_layout.cages() )
+    {
+        const auto* cells = m_layout.cageCells( cage );
+        Layout::Mask seen = 0;
+        Num sum = 0;
+        for( Num position = 0; position < cage.size; ++position )
+        {
+            const auto value = solution[cells[position]];
+            const auto bit = Layout::Mask( 1 ) << ( value - 1 );
+            if( seen & bit )
+                return Verdict::Invalid;
+            seen |= bit;
+            sum += value;
+        }
+        if( sum != cage.sum )
+            return Verdict::Invalid;
+    }
+    return Verdict::Valid;
+}
+
+
+void Verifier::verify( const Num* puzzles, const Num* solutions, std::size_t count, Verdict* verdicts ) noexcept
+{
+    std::size_t grid = 0;
+    if( m_lanes )
+    {
+        for( ; count - grid >= Lanes; grid += Lanes )
+        {
+            verifyLanes( puzzles ? puzzles + grid * StandardCells : nullptr, solutions + grid * StandardCells, verdicts + grid );
+        }
+    }
+    for( ; grid < count; ++grid )
+    {
+        verdicts[grid] = verify( puzzles ? puzzles + grid * m_cells : nullptr, solutions + grid * m_cells );
+    }
+}
+
+
+void Verifier::verifyLanes( const Num* puzzles, const Num* solutions, Verdict* verdicts ) noexcept
+{
+    // ORing values from distinct lanes never carries, so a word holds the
+    // masks of a unit of every grid
+    std::uint64_t rows[StandardDimension] = {};
+    std::uint64_t columns[StandardDimension] = {};
+    std::uint64_t quadrants[StandardDimension] = {};
+    // a bit per grid, at the start of its lane
+    std::uint64_t empty = 0;
+    std::uint64_t mismatch = 0;
+    for( Num cell = 0; cell < StandardCells; ++cell )
+    {
+        std::uint64_t bits = 0;
+        for( std::size_t lane = 0; lane < Lanes; ++lane )
+        {
+            const auto value = solutions[lane * StandardCells + cell];
+            const auto given = puzzles ? puzzles[lane * StandardCells + cell] : 0;
+            const auto shift = lane * StandardDimension;
+            // 0 wraps around, so empty and out of range values set no bit
+            bits |= ( value - 1 < StandardDimension ? std::uint64_t( 1 ) << ( value - 1 ) : 0 ) << shift;
+            empty |= std::uint64_t( value == 0 ) << shift;
+            mismatch |= std::uint64_t( given != 0 && given != value ) << shift;
+        }
+        rows[cell / StandardDimension] |= bits;
+        columns[cell % StandardDimension] |= bits;
+        quadrants[cell / 27 * 3 + cell % StandardDimension / 3] |= bits;
+    }
+
+    // a unit of 9 cells with all 9 values has each once
+    auto complete = ~std::uint64_t( 0 );
+    for( Num unit = 0; unit < StandardDimension; ++unit )
+    {
+        complete &= rows[unit] & columns[unit] & quadrants[unit];
+    }
+
+    for( std::size_t lane = 0; lane < Lanes; ++lane )
+    {
+        const auto shift = lane * StandardDimension;
+        if( mismatch >> shift & 1 )
+            verdicts[lane] = Verdict::Mismatch;
+        else if( empty >> shift & 1 )
+            verdicts[lane] = Verdict::Incomplete;
+        else if( ( complete >> shift & LaneMask ) != LaneMask )
+            verdicts[lane] = Verdict::Invalid;
+        else
+            verdicts[lane] = Verdict::Valid;
+    }
+}
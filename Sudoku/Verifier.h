@@ -0,0 +1,101 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Layout.h"
+
+namespace Sudoku
+{
+
+/**
+* @brief Outcome of checking a solution against its puzzle.
+*/
+enum class Verdict
+{
+    /**
+    * @brief Every unit holds each value once, every cage adds up, and the
+    * givens are kept.
+    */
+    Valid,
+    /**
+    * @brief Some cells are empty.
+    */
+    Incomplete,
+    /**
+    * @brief A value repeats in a unit or cage, is out of range, or a cage
+    * doesn't add up.
+    */
+    Invalid,
+    /**
+    * @brief The solution changes or clears a given of the puzzle.
+    */
+    Mismatch
+};
+
+/**
+* @brief Gets the name of a verdict, e.g. "VALID".
+*/
+const char* toString( Verdict verdict ) noexcept;
+
+/**
+* @brief Checks completed grids against the constraints of a layout, without
+* building boards: each unit is checked with a bit set of the values seen.
+* Standard 9x9 grids are checked Lanes at a time, the values of each grid
+* taking a 9 bit lane of a 64 bit word, so that the masks of a row, column
+* or quadrant of all of them are built with the same OR.
+*
+* Grids are arrays of cells in row order, 0 for an empty cell. Not thread
+* safe: use a verifier per thread.
+*/
+class Verifier
+{
+public:
+    /**
+    * @brief The number of standard grids checked together.
+    */
+    static constexpr std::size_t Lanes = 7;
+
+    explicit Verifier( Num blockSize );
+    explicit Verifier( const Layout& layout );
+
+    const Layout& layout() const noexcept
+    {
+        return m_layout;
+    }
+    /**
+    * @brief Gets the number of cells of a grid.
+    */
+    std::size_t cellCount() const noexcept
+    {
+        return m_cells;
+    }
+
+    /**
+    * @brief Checks a solution.
+    * @param puzzle the givens the solution must keep, or nullptr
+    * @param solution the grid to check
+    */
+    Verdict verify( const Num* puzzle, const Num* solution ) noexcept;
+    /**
+    * @brief Checks solutions stored one after another.
+    * @param puzzles the puzzle of each solution, stored the same way, or nullptr
+    * @param solutions the count grids to check
+    * @param verdicts receives the count verdicts
+    */
+    void verify( const Num* puzzles, const Num* solutions, std::size_t count, Verdict* verdicts ) noexcept;
+
+private:
+    Layout m_layout;
+    std::size_t m_cells;
+    bool m_lanes;
+    // a bit per value of the unit being checked
+    std::vector<std::uint64_t> m_seen;
+
+    /**
+    * @brief Checks Lanes standard 9x9 solutions.
+    */
+    static void verifyLanes( const Num* puzzles, const Num* solutions, Verdict* verdicts ) noexcept;
+};
+
+} // namespace
@@ -0,0 +1,87 @@
+#include "gtest/gtest.h"
+
+#include "Annealer.h"
+#include "FileParser.h"
+
+using namespace Sudoku;
+
+namespace
+{
+const std::string Puzzle = "000000290530040000000000054000070081060000000012060547000004000003050070905003400";
+}
+
+TEST( AnnealerTests, solve )
+{
+    const auto givens = parseLineValues( Puzzle );
+    SolveOptions options;
+    options.seed = 7;
+
+    const auto result = anneal( givens, options );
+    ASSERT_EQ( result.status, SolveStatus::Solved );
+    EXPECT_TRUE( result.board.isSolved() );
+    for( Num i = 0; i < 9; ++i )
+    {
+        for( Num j = 0; j < 9; ++j )
+        {
+            if( givens[i][j] != 0 )
+            {
+                EXPECT_EQ( result.board.at( i, j ), givens[i][j] );
+            }
+        }
+    }
+}
+
+TEST( AnnealerTests, parallelChains )
+{
+    AnnealOptions annealOptions;
+    annealOptions.chains = 3;
+
+    const auto result = anneal( Board::InputArray( 9, Nums( 9 ) ), SolveOptions{}, annealOptions );
+    ASSERT_EQ( result.status, SolveStatus::Solved );
+    EXPECT_TRUE( result.board.isSolved() );
+}
+
+TEST( AnnealerTests, reproducible )
+{
+    SolveOptions options;
+    options.seed = 42;
+
+    const auto first = anneal( Board::InputArray( 9, Nums( 9 ) ), options );
+    const auto second = anneal( Board::InputArray( 9, Nums( 9 ) ), options );
+    ASSERT_EQ( first.status, SolveStatus::Solved );
+    EXPECT_EQ( first.stats.nodes, second.stats.nodes );
+    for( Num i = 0; i < 9; ++i )
+    {
+        for( Num j = 0; j < 9; ++j )
+        {
+            EXPECT_EQ( first.board.at( i, j ), second.board.at( i, j ) );
+        }
+    }
+}
+
+TEST( AnnealerTests, limits )
+{
+    SolveOptions options;
+    options.maxNodes = 1;
+    auto result = anneal( Board::InputArray( 16, Nums( 16 ) ), options );
+    EXPECT_EQ( result.status, SolveStatus::NodeLimitExceeded );
+    EXPECT_EQ( result.stats.nodes, 1u );
+
+    SolveOptions cancelled;
+    cancelled.cancellation.cancel();
+    result = anneal( Board::InputArray( 16, Nums( 16 ) ), cancelled );
+    EXPECT_EQ( result.status, SolveStatus::Cancelled );
+}
+
+TEST( AnnealerTests, unsolvable )
+{
+    // the top row has no value left for its third cell
+    const Board::InputArray givens{
+        { 1, 2, 0, 0 },
+        { 0, 0, 0, 0 },
+        { 0, 0, 3, 0 },
+        { 0, 0, 4, 0 } };
+
+    EXPECT_EQ( anneal( givens ).status, SolveStatus::Unsolvable );
+    EXPECT_THROW( anneal( Board::InputArray( 5, Nums( 5 ) ) ), std::invalid_argument );
+}
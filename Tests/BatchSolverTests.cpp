@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "BatchSolver.h"
+#include "FileParser.h"
+#include "Solver.h"
+
+using namespace Sudoku;
+
+namespace
+{
+// solved by singles alone
+const std::string Easy = "000530009000009642000010073103690004560020930024085060679100325250000007001700006";
+// needs search
+const std::string Hard = "000000000590034600060000080400008009010000076000000500070900003300800260050070000";
+
+/**
+* @brief Appends the cells of a puzzle in the compact line format.
+*/
+void append( Nums& puzzles, const std::string& line )
+{
+    Nums cells;
+    parseLineCells( line.data(), line.size(), cells );
+    puzzles.insert( puzzles.end(), cells.begin(), cells.end() );
+}
+
+/**
+* @brief Gets the cells of a solved board in row order.
+*/
+Nums cellsOf( const Board& board )
+{
+    Nums cells;
+    for( Num row = 0; row < 9; ++row )
+    {
+        for( Num column = 0; column < 9; ++column )
+        {
+            cells.push_back( board.at( row, column ) );
+        }
+    }
+    return cells;
+}
+}
+
+TEST( BatchSolverTests, sameAsSearch )
+{
+    // more than a group of lanes, the last one partial, and puzzles needing search among them
+    constexpr std::size_t Count = BatchSolver::Lanes + 5;
+    Nums puzzles;
+    for( std::size_t puzzle = 0; puzzle < Count; ++puzzle )
+    {
+        append( puzzles, puzzle % 7 == 3 ? Hard : Easy );
+    }
+    Nums solutions( puzzles.size() );
+    std::vector<SolveStatus> statuses( Count );
+    std::vector<SolveStats> stats( Count );
+    BatchSolver solver;
+    solver.solve( puzzles.data(), Count, solutions.data(), statuses.data(), {}, stats.data() );
+
+    const auto easy = cellsOf( solve( parseLine( Easy ), SolveOptions{} ).board );
+    const auto hard = cellsOf( solve( parseLine( Hard ), SolveOptions{} ).board );
+    for( std::size_t puzzle = 0; puzzle < Count; ++puzzle )
+    {
+        ASSERT_EQ( statuses[puzzle], SolveStatus::Solved );
+        const auto& expected = puzzle % 7 == 3 ? hard : easy;
+        EXPECT_TRUE( std::equal( expected.begin(), expected.end(), solutions.begin() + puzzle * BatchSolver::Cells ) );
+        EXPECT_GT( stats[puzzle].elapsed.count(), 0 );
+    }
+    EXPECT_EQ( solver.searched(), 3u );
+    EXPECT_EQ( solver.propagated(), Count - 3 );
+    EXPECT_GT( stats[3].nodes, 0u );
+}
+
+TEST( BatchSolverTests, unsolvable )
+{
+    Nums puzzles;
+    // a value repeated in a row, and a cell left without candidates
+    auto repeated = Easy;
+    repeated[0] = '5';
+    append( puzzles, repeated );
+    append( puzzles, "123456780000000009000000000000000000000000000000000000000000000000000000000000000" );
+    append( puzzles, Easy );
+    Nums solutions( puzzles.size() );
+    std::vector<SolveStatus> statuses( 3 );
+    BatchSolver solver;
+    solver.solve( puzzles.data(), 3, solutions.data(), statuses.data() );
+
+    EXPECT_EQ( statuses[0], SolveStatus::Unsolvable );
+    EXPECT_EQ( statuses[1], SolveStatus::Unsolvable );
+    EXPECT_EQ( statuses[2], SolveStatus::Solved );
+    // unsolved puzzles keep their values
+    EXPECT_TRUE( std::equal( puzzles.begin(), puzzles.begin() + 2 * BatchSolver::Cells, solutions.begin() ) );
+    EXPECT_EQ( solver.propagated(), 3u );
+
+    puzzles[5] = 10;
+    EXPECT_THROW( solver.solve( puzzles.data(), 3, solutions.data(), statuses.data() ), std::invalid_argument );
+}
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "gtest/gtest.h"
 
 #include "Board.h"
@@ -465,6 +467,140 @@ TEST( BoardTests, getRow )
     EXPECT_EQ( row[6]->getVal(), 6 );
 }
 
+TEST( BoardTests, views )
+{
+    TestBoard b( 2 );
+    b.set( 0, 1, 3 );
+
+    // the views read the board in place
+    const auto& cell = b.cellRef( 0, 1 );
+    EXPECT_EQ( &cell, &b.cellRef( 0, 1 ) );
+    EXPECT_EQ( cell.getVal(), 3u );
+    const auto candidates = b.candidates( 0, 0 );
+    EXPECT_EQ( Nums( candidates.begin(), candidates.end() ), ( Nums{ 1, 2, 4 } ) );
+    EXPECT_THROW( b.cellRef( 4, 0 ), std::out_of_range );
+    EXPECT_THROW( b.candidates( 0, 4 ), std::out_of_range );
+
+    // rows, columns, then quadrants
+    const auto column = b.unitCells( 4 + 1 );
+    ASSERT_EQ( column.size(), 4u );
+    EXPECT_EQ( &column[0], &cell );
+    EXPECT_EQ( column.position( 3 ), 13u );
+    const auto quadrant = b.unitCells( 8 );
+    Nums values;
+    for( const auto& c : quadrant )
+    {
+        values.push_back( c.getVal() );
+    }
+    EXPECT_EQ( values, ( Nums{ 0, 3, 0, 0 } ) );
+    EXPECT_THROW( b.unitCells( 12 ), std::out_of_range );
+}
+
+TEST( BoardTests, move )
+{
+    TestBoard b( 2 );
+    b.recordChanges( true );
+    const auto checkpoint = b.checkpoint();
+    b.set( 0, 0, 1 );
+    const auto copy = b;
+
+    // the record moves along and can still be rolled back
+    TestBoard moved( std::move( b ) );
+    EXPECT_EQ( moved, copy );
+    moved.rollback( checkpoint );
+    EXPECT_EQ( moved, TestBoard( 2 ) );
+
+    TestBoard assigned( 3 );
+    assigned = std::move( moved );
+    EXPECT_EQ( assigned.dimension(), 4u );
+    EXPECT_EQ( assigned.cellRef( 0, 0 ).count(), 4u );
+}
+
+TEST( BoardTests, flatValues )
+{
+    TestBoard::InputArray values{
+        {
+            {0,0,0,0,0,0,0,0,0},
+            {5,9,0,0,3,4,6,0,0},
+            {0,6,0,0,0,0,0,8,0},
+            {4,0,0,0,0,8,0,0,9},
+            {0,1,0,0,0,0,0,7,6},
+            {0,0,0,0,0,0,5,0,0},
+            {0,7,0,9,0,0,0,0,3},
+            {3,0,0,8,0,0,2,6,0},
+            {0,5,0,0,7,0,0,0,0},
+        }
+    };
+    // two boards in one buffer, the second a slice of it
+    Nums flat( 2 * 81 );
+    for( Num i = 0; i < 9; ++i )
+    {
+        std::copy( values[i].begin(), values[i].end(), flat.begin() + 81 + i * 9 );
+    }
+
+    const TestBoard expected( 3, values );
+    EXPECT_EQ( TestBoard( 3, flat.data() + 81 ), expected );
+    EXPECT_EQ( TestBoard( Layout( 3 ), flat.data() + 81 ), expected );
+    EXPECT_EQ( TestBoard( 3, Nums( flat.begin() + 81, flat.end() ) ), expected );
+    EXPECT_THROW( TestBoard( 3, flat ), std::invalid_argument );
+
+    // a range of narrower values is placed and propagated the same
+    const std::vector<std::uint16_t> narrow( flat.begin() + 81, flat.end() );
+    const TestBoard ranged( 3, narrow.begin(), narrow.end() );
+    EXPECT_EQ( ranged, expected );
+    for( Num i = 0; i < 9; ++i )
+    {
+        for( Num j = 0; j < 9; ++j )
+        {
+            EXPECT_EQ( ranged.cellRef( i, j ), expected.cellRef( i, j ) );
+        }
+    }
+    EXPECT_THROW( TestBoard( 3, narrow.begin(), narrow.end() - 1 ), std::invalid_argument );
+
+    flat[81] = 5;
+    EXPECT_THROW( TestBoard( 3, flat.data() + 81 ), std::invalid_argument );
+    EXPECT_THROW( TestBoard( 3, flat.begin() + 81, flat.end() ), std::invalid_argument );
+}
+
+TEST( BoardTests, deferredUpdates )
+{
+    TestBoard b( 2 );
+    TestBoard expected( 2 );
+    expected.set( 0, 0, 1 );
+    expected.set( 3, 3, 4 );
+
+    // nothing propagates until asked to
+    b.place( 0, 0, 1 );
+    b.place( 3, 3, 4 );
+    EXPECT_EQ( b.cellRef( 0, 1 ).count(), 4u );
+    b.propagate();
+    EXPECT_EQ( b, expected );
+    for( Num i = 0; i < 4; ++i )
+    {
+        for( Num j = 0; j < 4; ++j )
+        {
+            EXPECT_EQ( b.cellRef( i, j ), expected.cellRef( i, j ) );
+        }
+    }
+
+    // eliminations leave the only value of a unit for propagation to place
+    EXPECT_TRUE( b.exclude( 0, 1, 2 ) );
+    EXPECT_FALSE( b.exclude( 0, 1, 2 ) );
+    EXPECT_TRUE( b.exclude( 0, 1, 3 ) );
+    EXPECT_EQ( b.at( 0, 1 ), 4u );
+    b.propagate();
+    EXPECT_TRUE( b.isValid() );
+    EXPECT_EQ( b.cellRef( 0, 2 ).count(), 2u );
+
+    // values placed together are only checked by isValid()
+    b.place( 1, 0, 1 );
+    b.propagate();
+    EXPECT_FALSE( b.isValid() );
+
+    EXPECT_THROW( b.place( 4, 0, 1 ), std::out_of_range );
+    EXPECT_THROW( b.exclude( 0, 0, 5 ), std::invalid_argument );
+}
+
 TEST( BoardTests, getCol )
 {
     TestBoard::InputArray values{
@@ -638,3 +774,79 @@ TEST( BoardTests, printBoard )
 
     ASSERT_NO_THROW( std::cout << b << std::endl );
 }
+
+TEST( BoardTests, countPeerPossibilities )
+{
+    TestBoard b( 2 );
+    std::vector<std::size_t> counts;
+
+    // 3 cells in the row, 3 in the column and 1 more in the quadrant
+    b.countPeerPossibilities( 0, 0, counts );
+    EXPECT_EQ( counts, std::vector<std::size_t>( { 0, 7, 7, 7, 7 } ) );
+
+    // the assigned peer and the peers that lost the value don't count
+    b.set( 3, 3, 1 );
+    b.countPeerPossibilities( 3, 0, counts );
+    EXPECT_EQ( counts, std::vector<std::size_t>( { 0, 4, 6, 6, 6 } ) );
+
+    EXPECT_THROW( b.countPeerPossibilities( 4, 0, counts ), std::out_of_range );
+}
+
+
+TEST( BoardTests, hiddenSingle )
+{
+    TestBoard b( 3 );
+    // 1 is ruled out of the top row but for its first cell, which can still
+    // take any value on its own
+    b.set( 1, 3, 1 );
+    b.set( 2, 6, 1 );
+    b.set( 4, 1, 1 );
+    b.set( 7, 2, 1 );
+    EXPECT_EQ( b.at( 0, 0 ), 1u );
+}
+
+
+TEST( BoardTests, boxLine )
+{
+    TestBoard b( 3 );
+    b.set( 1, 0, 2 );
+    b.set( 1, 1, 3 );
+    b.set( 1, 2, 4 );
+    b.set( 2, 0, 5 );
+    b.set( 2, 1, 6 );
+    b.set( 5, 2, 1 );
+
+    // in the top left quadrant, 1 only fits the top row
+    for( Num col = 3; col < 9; ++col )
+    {
+        EXPECT_FALSE( contains( b.cell( 0, col ).possibilities(), 1 ) ) << col;
+        EXPECT_TRUE( contains( b.cell( 1, col ).possibilities(), 1 ) ) << col;
+    }
+}
+
+
+TEST( BoardTests, cage )
+{
+    Layout layout( 3 );
+    layout.addCage( { { 0, 0 }, { 0, 1 } }, 3 );
+    layout.addCage( { { 3, 0 }, { 3, 1 }, { 3, 2 } }, 7 );
+    Board b( layout );
+
+    // only 1 + 2 and 1 + 2 + 4
+    EXPECT_EQ( b.cell( 0, 1 ).possibilities(), Nums( { 1, 2 } ) );
+    EXPECT_EQ( b.cell( 3, 0 ).possibilities(), Nums( { 1, 2, 4 } ) );
+    EXPECT_EQ( b.cell( 0, 2 ).count(), 7u );
+
+    b.set( 0, 0, 2 );
+    EXPECT_EQ( b.at( 0, 1 ), 1u );
+    EXPECT_EQ( b.cell( 3, 0 ).possibilities(), Nums( { 1, 4 } ) );
+    EXPECT_EQ( b.cell( 3, 1 ).possibilities(), Nums( { 2, 4 } ) );
+    EXPECT_TRUE( b.isValid() );
+
+    // the same value twice in a cage, and a cage of the wrong sum
+    Layout pair( 2 );
+    pair.addCage( { { 0, 0 }, { 1, 2 } }, 4 );
+    EXPECT_THROW( Board( pair, { { 2, 0, 0, 0 }, { 0, 0, 2, 0 }, { 0, 0, 0, 0 }, { 0, 0, 0, 0 } } ), std::invalid_argument );
+    EXPECT_THROW( Board( pair, { { 1, 0, 0, 0 }, { 0, 0, 4, 0 }, { 0, 0, 0, 0 }, { 0, 0, 0, 0 } } ), std::invalid_argument );
+    EXPECT_NO_THROW( Board( pair, { { 1, 0, 0, 0 }, { 0, 0, 3, 0 }, { 0, 0, 0, 0 }, { 0, 0, 0, 0 } } ) );
+}
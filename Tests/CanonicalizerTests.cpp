@@ -0,0 +1,99 @@
+#include "gtest/gtest.h"
+
+#include "Canonicalizer.h"
+#include "FileParser.h"
+
+using namespace Sudoku;
+
+namespace
+{
+const std::string Puzzle = "000000290530040000000000054000070081060000000012060547000004000003050070905003400";
+
+/**
+* @brief Transposes the values, swaps the first two bands, the last two columns
+* of the middle stack and relabels every value v as 10 - v.
+*/
+Board::InputArray transform( const Board::InputArray& values )
+{
+    const Num rows[] = { 3, 4, 5, 0, 1, 2, 6, 7, 8 };
+    const Num columns[] = { 0, 1, 2, 3, 5, 4, 6, 7, 8 };
+
+    Board::InputArray result( 9, Nums( 9 ) );
+    for( Num i = 0; i < 9; ++i )
+    {
+        for( Num j = 0; j < 9; ++j )
+        {
+            const auto value = values[rows[i]][columns[j]];
+            result[j][i] = value ? 10 - value : 0;
+        }
+    }
+    return result;
+}
+}
+
+TEST( CanonicalizerTests, equivalent )
+{
+    Canonicalizer canonicalizer;
+    const auto values = parseLineValues( Puzzle );
+
+    canonicalizer.canonicalize( values );
+    EXPECT_TRUE( canonicalizer.exact() );
+    const auto canonical = canonicalizer.canonical();
+    const auto digest = canonicalizer.digest();
+
+    canonicalizer.canonicalize( transform( values ) );
+    EXPECT_EQ( canonicalizer.canonical(), canonical );
+    EXPECT_EQ( canonicalizer.digest(), digest );
+
+    // the canonical form is its own canonical form
+    Board::InputArray rows( 9, Nums( 9 ) );
+    for( Num i = 0; i < 81; ++i )
+    {
+        rows[i / 9][i % 9] = canonical[i];
+    }
+    canonicalizer.canonicalize( rows );
+    EXPECT_EQ( canonicalizer.canonical(), canonical );
+}
+
+TEST( CanonicalizerTests, different )
+{
+    Canonicalizer canonicalizer;
+    auto values = parseLineValues( Puzzle );
+
+    canonicalizer.canonicalize( values );
+    const auto digest = canonicalizer.digest();
+
+    values[8][8] = 1;
+    canonicalizer.canonicalize( values );
+    EXPECT_NE( canonicalizer.digest(), digest );
+}
+
+TEST( CanonicalizerTests, roundTrip )
+{
+    Canonicalizer canonicalizer;
+    const auto values = transform( parseLineValues( Puzzle ) );
+    canonicalizer.canonicalize( values );
+
+    Nums flat;
+    for( const auto& row : values )
+    {
+        flat.insert( flat.end(), row.begin(), row.end() );
+    }
+
+    Nums canonical;
+    canonicalizer.toCanonical( flat, canonical );
+    EXPECT_EQ( canonical, canonicalizer.canonical() );
+
+    Board::InputArray restored;
+    canonicalizer.fromCanonical( canonical, restored );
+    EXPECT_EQ( restored, values );
+}
+
+TEST( CanonicalizerTests, invalid )
+{
+    Canonicalizer canonicalizer;
+
+    EXPECT_THROW( canonicalizer.canonicalize( Board::InputArray( 5, Nums( 5 ) ) ), std::invalid_argument );
+    EXPECT_THROW( canonicalizer.canonicalize( Board::InputArray( 4, Nums( 3 ) ) ), std::invalid_argument );
+    EXPECT_THROW( canonicalizer.canonicalize( Board::InputArray( 4, Nums( 4, 5 ) ) ), std::invalid_argument );
+}
@@ -71,3 +71,19 @@ TEST( CellTests, compare )
     c2.remove( 1 );
     EXPECT_EQ( c1, c2 );
 }
+
+TEST( CellTests, candidates )
+{
+    TestCell c( 9 );
+    c.remove( ( Nums{ 2, 4, 5, 6, 8 } ) );
+
+    const auto candidates = c.candidates();
+    EXPECT_EQ( Nums( candidates.begin(), candidates.end() ), ( Nums{ 1, 3, 7, 9 } ) );
+    EXPECT_EQ( candidates.size(), c.count() );
+    EXPECT_EQ( candidates[2], 7u );
+    EXPECT_TRUE( candidates.contains( 3 ) );
+    EXPECT_FALSE( candidates.contains( 4 ) );
+
+    c.remove( ( Nums{ 1, 3, 7, 9 } ) );
+    EXPECT_TRUE( c.candidates().empty() );
+}
@@ -0,0 +1,92 @@
+#include "gtest/gtest.h"
+
+#include "ClauseLearner.h"
+#include "FileParser.h"
+#include "Solver.h"
+
+using namespace Sudoku;
+
+namespace
+{
+// puzzles with a unique solution, needing search
+const std::vector<std::string> Puzzles = {
+    "000000290530040000000000054000070081060000000012060547000004000003050070905003400",
+    "100000002090400050006000700050903000000070000000850040700000600030009080002000001",
+    "000000039000001005003050800008090006070002000100400000009080050020000600400700000" };
+}
+
+TEST( ClauseLearnerTests, solve )
+{
+    const auto givens = parseLineValues( Puzzles[0] );
+
+    const auto result = learn( givens );
+    ASSERT_EQ( result.status, SolveStatus::Solved );
+    EXPECT_TRUE( result.board.isSolved() );
+    for( Num i = 0; i < 9; ++i )
+    {
+        for( Num j = 0; j < 9; ++j )
+        {
+            if( givens[i][j] != 0 )
+            {
+                EXPECT_EQ( result.board.at( i, j ), givens[i][j] );
+            }
+        }
+    }
+}
+
+TEST( ClauseLearnerTests, matchesSearch )
+{
+    for( const auto& puzzle : Puzzles )
+    {
+        const auto givens = parseLineValues( puzzle );
+        SolveOptions options;
+        options.valueOrder = ValueOrder::Random;
+        options.seed = 3;
+
+        const auto result = learn( givens, options );
+        ASSERT_EQ( result.status, SolveStatus::Solved );
+        EXPECT_EQ( result.board, solve( Board( 3, givens ) ) );
+    }
+}
+
+TEST( ClauseLearnerTests, emptyBoards )
+{
+    for( Num dim : { 4, 9, 16, 25 } )
+    {
+        const auto result = learn( Board::InputArray( dim, Nums( dim ) ) );
+        ASSERT_EQ( result.status, SolveStatus::Solved );
+        EXPECT_TRUE( result.board.isSolved() );
+    }
+}
+
+TEST( ClauseLearnerTests, limits )
+{
+    SolveOptions options;
+    options.maxNodes = 1;
+    auto result = learn( Board::InputArray( 16, Nums( 16 ) ), options );
+    EXPECT_EQ( result.status, SolveStatus::NodeLimitExceeded );
+    EXPECT_EQ( result.stats.nodes, 1u );
+
+    SolveOptions cancelled;
+    cancelled.cancellation.cancel();
+    result = learn( Board::InputArray( 16, Nums( 16 ) ), cancelled );
+    EXPECT_EQ( result.status, SolveStatus::Cancelled );
+}
+
+TEST( ClauseLearnerTests, unsolvable )
+{
+    // the top row has no value left for its third cell
+    const Board::InputArray givens{
+        { 1, 2, 0, 0 },
+        { 0, 0, 0, 0 },
+        { 0, 0, 3, 0 },
+        { 0, 0, 4, 0 } };
+    EXPECT_EQ( learn( givens ).status, SolveStatus::Unsolvable );
+
+    // only a search finds out that this one has no solution
+    const auto search = parseLineValues( "400000006080070510009500700060000091070930000000001200010320600036704000000100080" );
+    const auto result = learn( search );
+    EXPECT_EQ( result.status, SolveStatus::Unsolvable );
+    EXPECT_GT( result.stats.visitedStates, 0u );
+    EXPECT_THROW( learn( Board::InputArray( 5, Nums( 5 ) ) ), std::invalid_argument );
+}
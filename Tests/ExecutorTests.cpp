@@ -0,0 +1,141 @@
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "Executor.h"
+#include "Solver.h"
+
+using namespace Sudoku;
+
+namespace
+{
+const Board::InputArray Puzzle{
+    {
+        {0,0,0,0,0,0,0,0,0},
+        {5,9,0,0,3,4,6,0,0},
+        {0,6,0,0,0,0,0,8,0},
+        {4,0,0,0,0,8,0,0,9},
+        {0,1,0,0,0,0,0,7,6},
+        {0,0,0,0,0,0,5,0,0},
+        {0,7,0,9,0,0,0,0,3},
+        {3,0,0,8,0,0,2,6,0},
+        {0,5,0,0,7,0,0,0,0},
+    }
+};
+}
+
+TEST( ExecutorTests, futures )
+{
+    Executor executor( 2, 4 );
+    Board b( 3, Puzzle );
+
+    std::vector<std::future<SolveResult>> results;
+    for( int i = 0; i < 8; ++i )
+    {
+        results.push_back( executor.solve( b ) );
+    }
+
+    for( auto& result : results )
+    {
+        auto r = result.get();
+        ASSERT_EQ( r.status, SolveStatus::Solved );
+        EXPECT_TRUE( r.board.isSolved() );
+    }
+}
+
+TEST( ExecutorTests, callback )
+{
+    Board b( 3, Puzzle );
+    std::promise<SolveStatus> status;
+
+    solveAsync( b, SolveOptions{}, [&status]( SolveResult r ) { status.set_value( r.status ); },
+        [&status]( std::exception_ptr error ) { status.set_exception( error ); } );
+
+    EXPECT_EQ( status.get_future().get(), SolveStatus::Solved );
+    EXPECT_EQ( solveAsync( b ).get().board, solve( b ) );
+
+    // an exception thrown by the callback goes to the error callback
+    std::promise<SolveStatus> failed;
+    solveAsync( b, SolveOptions{}, []( SolveResult ) { throw std::logic_error( "callback" ); },
+        [&failed]( std::exception_ptr error ) { failed.set_exception( error ); } );
+    EXPECT_THROW( failed.get_future().get(), std::logic_error );
+}
+
+TEST( ExecutorTests, priorities )
+{
+    Executor executor( 1, 8 );
+    std::promise<void> gate;
+    auto opened = gate.get_future().share();
+    std::promise<void> started;
+
+    // keep the only worker busy until every request is queued
+    executor.submit( [&started, opened]( SolverContext& ) { started.set_value(); opened.wait(); } );
+    started.get_future().wait();
+
+    std::mutex mutex;
+    std::vector<int> order;
+    for( int priority : { 1, 3, 2, 3 } )
+    {
+        executor.submit( [&mutex, &order, priority]( SolverContext& )
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                order.push_back( priority );
+            }, priority );
+    }
+
+    std::promise<void> done;
+    executor.submit( [&done]( SolverContext& ) { done.set_value(); }, -1 );
+
+    gate.set_value();
+    done.get_future().wait();
+
+    EXPECT_EQ( order, ( std::vector<int>{ 3, 3, 2, 1 } ) );
+}
+
+TEST( ExecutorTests, backpressure )
+{
+    Executor executor( 1, 1 );
+    std::promise<void> gate;
+    auto opened = gate.get_future().share();
+    std::promise<void> started;
+
+    executor.submit( [&started, opened]( SolverContext& ) { started.set_value(); opened.wait(); } );
+    started.get_future().wait();
+
+    EXPECT_TRUE( executor.trySubmit( []( SolverContext& ) {} ) );
+    EXPECT_FALSE( executor.trySubmit( []( SolverContext& ) {} ) );
+
+    gate.set_value();
+}
+
+TEST( ExecutorTests, dropped )
+{
+    auto executor = std::make_unique<Executor>( 1, 4 );
+    std::promise<void> gate;
+    auto opened = gate.get_future().share();
+    std::promise<void> started;
+
+    executor->submit( [&started, opened]( SolverContext& ) { started.set_value(); opened.wait(); } );
+    started.get_future().wait();
+
+    Board b( 3, Puzzle );
+    std::promise<SolveStatus> statuses[2];
+    for( auto& status : statuses )
+    {
+        executor->solve( b, SolveOptions{}, [&status]( SolveResult r ) { status.set_value( r.status ); },
+            [&status]( std::exception_ptr error ) { status.set_exception( error ); } );
+    }
+    auto future = executor->solve( b );
+
+    // the queued solves fail while the running task still blocks the destructor
+    std::thread destroyer( [&executor] { executor.reset(); } );
+    for( auto& status : statuses )
+    {
+        EXPECT_THROW( status.get_future().get(), std::runtime_error );
+    }
+    gate.set_value();
+    destroyer.join();
+    EXPECT_THROW( future.get(), std::future_error );
+}
@@ -1,6 +1,7 @@
 #include "gtest/gtest.h"
 
 #include "FileParser.h"
+#include "Utils.h"
 
 using namespace Sudoku;
 
@@ -64,3 +65,133 @@ TEST( FileParserTests, Large )
     EXPECT_EQ( b.at( 0, 0 ), 14 );
     EXPECT_EQ( b.at( 13, 1 ), 15 );
 }
+
+TEST( FileParserTests, line )
+{
+    Board b( 3 );
+    ASSERT_NO_THROW( b = parseLine( "000000000590034600060000080400008009010000076000000500070900003300800260050070000" ) );
+    EXPECT_EQ( b, parseFile( 3, "Good.txt" ) );
+
+    ASSERT_NO_THROW( b = parseLine( ".........59..346...6.....8.4....8..9.1.....76......5...7.9....33..8..26..5..7...." ) );
+    EXPECT_EQ( b, parseFile( 3, "Good.txt" ) );
+
+    Board small( 2 );
+    ASSERT_NO_THROW( small = parseLine( "0 4 2 0, 0 3 4 1, 3 2 1 0, 0 0 0 0" ) );
+    EXPECT_EQ( small, parseFile( 2, "small4x4.txt" ) );
+}
+
+TEST( FileParserTests, badLine )
+{
+    EXPECT_THROW( parseLine( "" ), std::runtime_error );
+    EXPECT_THROW( parseLine( "0000000" ), std::runtime_error );
+    EXPECT_THROW( parseLine( "0a00000000000000" ), std::runtime_error );
+    EXPECT_THROW( parseLine( "1100000000000000" ), std::runtime_error );
+    EXPECT_THROW( parseLine( "0 0 0 0 0 0 0 0 0 0 0 0 0 0 0 17" ), std::runtime_error );
+}
+
+TEST( FileParserTests, layout )
+{
+    EXPECT_TRUE( parseFileLayout( 3, "Good.txt" ).isStandard() );
+
+    const auto layout = parseFileLayout( 2, "Jigsaw4x4.txt" );
+    EXPECT_FALSE( layout.isStandard() );
+    EXPECT_EQ( layout.unitCount(), 12u );
+
+    const auto board = parseFile( 2, "Jigsaw4x4.txt" );
+    EXPECT_EQ( board.at( 0, 3 ), 2u );
+    EXPECT_FALSE( board.layout().isStandard() );
+    // the region of the 2 is the rest of its column and two cells of row 1
+    EXPECT_FALSE( contains( board.cell( 1, 2 ).possibilities(), 2 ) );
+    EXPECT_TRUE( contains( board.cell( 1, 1 ).possibilities(), 2 ) );
+
+    const auto killer = parseFile( 2, "Killer4x4.txt" );
+    ASSERT_EQ( killer.layout().cages().size(), 8u );
+    EXPECT_EQ( killer.layout().cages()[1].sum, 7u );
+    EXPECT_EQ( killer.cell( 0, 0 ).possibilities(), Nums( { 1, 2 } ) );
+    EXPECT_EQ( killer.cell( 0, 3 ).possibilities(), Nums( { 3, 4 } ) );
+}
+
+TEST( FileParserTests, buffer )
+{
+    const std::string text = "0 4 2 0\n0 3 4 1\n3 2 1 0\n0 0 0 0\n";
+    EXPECT_EQ( parseBuffer( 2, text.data(), text.size() ), parseFile( 2, "small4x4.txt" ) );
+    // only the given size is read
+    EXPECT_THROW( parseBuffer( 2, text.data(), 10 ), ParseError );
+
+    const std::string killer = text + "cage 7 2 0 0 0 3";
+    const auto board = parseBuffer( 2, killer.data(), killer.size() );
+    EXPECT_EQ( board.layout().cages().size(), 1u );
+
+    const auto offset = []( const std::string& bad ) -> std::size_t
+        {
+            try
+            {
+                parseBuffer( 2, bad.data(), bad.size() );
+            }
+            catch( const ParseError& ex )
+            {
+                return ex.offset();
+            }
+            return std::string::npos;
+        };
+    EXPECT_EQ( offset( "0 4 2 0 0 3 x 1 3 2 1 0 0 0 0 0" ), 12u );
+    EXPECT_EQ( offset( "0 4 2 0 0 3 4 1 3 2 1 0 0 0 0 5" ), 30u );
+    EXPECT_EQ( offset( "0 4 2 0 0 3 4 1 3 2 1 0 0 0 0" ), 29u );
+    EXPECT_EQ( offset( text + "windows\nstripes" ), 40u );
+    EXPECT_EQ( offset( text + "cage 5 9" ), 39u );
+}
+
+TEST( FileParserTests, lineBuffer )
+{
+    const std::string line = "000000000590034600060000080400008009010000076000000500070900003300800260050070000";
+    EXPECT_EQ( parseLine( line.data(), line.size() ), parseFile( 3, "Good.txt" ) );
+
+    try
+    {
+        parseLine( "0 0 0 0, 0 0 0 0, 0 0 0 0, 0 0 0 9" );
+        FAIL();
+    }
+    catch( const ParseError& ex )
+    {
+        EXPECT_EQ( ex.offset(), 33u );
+    }
+    try
+    {
+        parseLine( "0000000a" );
+        FAIL();
+    }
+    catch( const ParseError& ex )
+    {
+        EXPECT_EQ( ex.offset(), 7u );
+        EXPECT_NE( std::string( ex.what() ).find( "'a'" ), std::string::npos );
+    }
+}
+
+TEST( FileParserTests, pairLine )
+{
+    const Nums solved{ 1, 2, 3, 4, 3, 4, 1, 2, 2, 1, 4, 3, 4, 3, 2, 1 };
+    Nums puzzle;
+    Nums solution;
+    EXPECT_EQ( parsePairLine( "1.3.............\t1234341221434321\r\n", 35, puzzle, solution ), 2u );
+    EXPECT_EQ( puzzle, Nums( { 1, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 } ) );
+    EXPECT_EQ( solution, solved );
+
+    const std::string separated = "1 0 0 0 0 0 0 0 0 0 0 0 0 0 0 0, 1 2 3 4 3 4 1 2 2 1 4 3 4 3 2 1";
+    EXPECT_EQ( parsePairLine( separated.data(), separated.size(), puzzle, solution ), 2u );
+    EXPECT_EQ( puzzle.size(), 16u );
+    EXPECT_EQ( puzzle[0], 1u );
+    EXPECT_EQ( solution, solved );
+
+    // offsets are within the whole line
+    try
+    {
+        parsePairLine( "1234341221434321,12a4341221434321", 33, puzzle, solution );
+        FAIL();
+    }
+    catch( const ParseError& ex )
+    {
+        EXPECT_EQ( ex.offset(), 19u );
+    }
+    EXPECT_THROW( parsePairLine( "1,1234341221434321", 18, puzzle, solution ), ParseError );
+    EXPECT_THROW( parsePairLine( "1234341221434321", 16, puzzle, solution ), ParseError );
+}
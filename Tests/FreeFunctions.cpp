@@ -2,6 +2,7 @@
 
 #include "Common.h"
 #include "Utils.h"
+#include "FileParser.h"
 
 using namespace Sudoku;
 
@@ -16,3 +17,17 @@ TEST( FreeFunctions, contains )
     ASSERT_FALSE( contains( n, 9 ) );
 }
 
+
+TEST( FreeFunctions, toLine )
+{
+    Board b( 2 );
+    b.set( 0, 1, 4 );
+    b.set( 3, 3, 2 );
+    EXPECT_EQ( toLine( b ), "0400000000000002" );
+
+    Board large( 4 );
+    large.set( 0, 0, 16 );
+    const auto line = toLine( large );
+    EXPECT_EQ( line.substr( 0, 5 ), "16 0 " );
+    EXPECT_EQ( parseLine( line ), large );
+}
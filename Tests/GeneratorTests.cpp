@@ -0,0 +1,87 @@
+#include "gtest/gtest.h"
+
+#include "Generator.h"
+#include "Solver.h"
+
+using namespace Sudoku;
+
+TEST( GeneratorTests, fullGrid )
+{
+    Executor executor( 1, 4 );
+
+    for( Num blockSize = 2; blockSize < 5; ++blockSize )
+    {
+        GeneratorOptions options;
+        options.blockSize = blockSize;
+        Generator generator( options, executor );
+
+        auto grid = generator.fullGrid();
+        EXPECT_TRUE( grid.isSolved() ) << blockSize;
+        EXPECT_TRUE( grid.isValid() ) << blockSize;
+    }
+}
+
+TEST( GeneratorTests, generate )
+{
+    Executor executor( 2, 16 );
+    GeneratorOptions options;
+    options.seed = 1234;
+    Generator generator( options, executor );
+
+    auto generated = generator.generate();
+    const auto& puzzle = generated.puzzle;
+
+    ASSERT_TRUE( generated.solution.isSolved() );
+    ASSERT_TRUE( generated.solution.isValid() );
+    EXPECT_LT( generated.clues, 81u );
+
+    // every value known in the puzzle is the one of the solution
+    for( Num i = 0; i < puzzle.dimension(); ++i )
+    {
+        for( Num j = 0; j < puzzle.dimension(); ++j )
+        {
+            if( puzzle.at( i, j ) != 0 )
+            {
+                EXPECT_EQ( puzzle.at( i, j ), generated.solution.at( i, j ) );
+            }
+        }
+    }
+
+    SolverContext context;
+    auto count = countSolutions( puzzle, 2, SolveOptions{}, context );
+    EXPECT_EQ( count.solutions, 1u );
+    EXPECT_EQ( count.status, SolveStatus::Unsolvable );
+}
+
+TEST( GeneratorTests, reproducible )
+{
+    GeneratorOptions options;
+    options.blockSize = 2;
+    options.seed = 99;
+
+    Executor one( 1, 4 );
+    Executor two( 2, 4 );
+    Generator first( options, one );
+    Generator second( options, two );
+
+    EXPECT_EQ( first.generate().puzzle, second.generate().puzzle );
+}
+
+TEST( GeneratorTests, reproducibleWithBudget )
+{
+    // a budget small enough to cut many uniqueness checks short
+    GeneratorOptions options;
+    options.seed = 7;
+    options.maxNodes = 20;
+
+    Executor one( 1, 4 );
+    Generator reference( options, one );
+    const auto expected = reference.generate().givens;
+
+    for( std::size_t threads : { 2u, 3u, 8u } )
+    {
+        Executor executor( threads, 4 );
+        Generator generator( options, executor );
+        EXPECT_EQ( generator.generate().givens, expected ) << threads;
+    }
+}
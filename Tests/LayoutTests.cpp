@@ -0,0 +1,119 @@
+#include <set>
+
+#include "gtest/gtest.h"
+
+#include "Layout.h"
+
+using namespace Sudoku;
+
+namespace
+{
+// regions of a 4x4 jigsaw
+const std::vector<Nums> Regions{
+    { 1, 1, 1, 2 },
+    { 3, 1, 2, 2 },
+    { 3, 3, 4, 2 },
+    { 3, 4, 4, 4 } };
+}
+
+TEST( LayoutTests, standard )
+{
+    const Layout layout( 3 );
+    EXPECT_TRUE( layout.isStandard() );
+    ASSERT_EQ( layout.unitCount(), 27u );
+
+    // row 1, column 2, then the second quadrant in row order
+    EXPECT_EQ( layout.unit( 1 )[0], 9u );
+    EXPECT_EQ( layout.unit( 9 + 2 )[1], 11u );
+    EXPECT_EQ( layout.unit( 18 + 1 )[3], 12u );
+
+    const auto units = layout.memberships( 40 );
+    ASSERT_EQ( units.second - units.first, 3 );
+    EXPECT_EQ( units.first[0].unit, 4u );
+    EXPECT_EQ( units.first[1].unit, 13u );
+    EXPECT_EQ( units.first[2].unit, 22u );
+    EXPECT_EQ( units.first[2].position, 4u );
+    EXPECT_TRUE( layout.contains( 22, 40 ) );
+    EXPECT_FALSE( layout.contains( 21, 40 ) );
+
+    // each line crosses 3 quadrants, both ways
+    EXPECT_EQ( layout.intersections().size(), 4 * 9 * 3u );
+}
+
+TEST( LayoutTests, variants )
+{
+    Layout layout( 3 );
+    layout.addDiagonals();
+    EXPECT_FALSE( layout.isStandard() );
+    ASSERT_EQ( layout.unitCount(), 29u );
+    EXPECT_EQ( layout.unit( 27 )[8], 80u );
+    EXPECT_EQ( layout.unit( 28 )[0], 8u );
+    // the center cell is on both diagonals
+    const auto units = layout.memberships( 40 );
+    EXPECT_EQ( units.second - units.first, 5 );
+
+    layout.addWindows();
+    ASSERT_EQ( layout.unitCount(), 33u );
+    EXPECT_EQ( layout.unit( 29 )[0], 10u );
+    EXPECT_EQ( layout.unit( 32 )[8], 70u );
+
+    EXPECT_THROW( layout.addUnit( { { 0, 0 } } ), std::invalid_argument );
+    EXPECT_THROW( layout.addUnit( std::vector<std::pair<Num, Num>>( 9, { 0, 0 } ) ), std::invalid_argument );
+    EXPECT_THROW( layout.addUnit( std::vector<std::pair<Num, Num>>( 9, { 9, 0 } ) ), std::invalid_argument );
+}
+
+TEST( LayoutTests, regions )
+{
+    Layout layout( 2 );
+    layout.setRegions( Regions );
+    ASSERT_EQ( layout.unitCount(), 12u );
+    const std::set<Num> first( layout.unit( 8 ), layout.unit( 8 ) + 4 );
+    EXPECT_EQ( first, std::set<Num>( { 0, 1, 2, 5 } ) );
+    const std::set<Num> last( layout.unit( 11 ), layout.unit( 11 ) + 4 );
+    EXPECT_EQ( last, std::set<Num>( { 10, 13, 14, 15 } ) );
+
+    auto uneven = Regions;
+    uneven[0][0] = 2;
+    EXPECT_THROW( layout.setRegions( uneven ), std::invalid_argument );
+    uneven[0][0] = 5;
+    EXPECT_THROW( layout.setRegions( uneven ), std::invalid_argument );
+    EXPECT_THROW( layout.setRegions( { { 1 } } ), std::invalid_argument );
+}
+
+TEST( LayoutTests, cages )
+{
+    Layout layout( 3 );
+    layout.addCage( { { 0, 0 }, { 0, 1 } }, 3 );
+    layout.addCage( { { 4, 4 }, { 4, 5 }, { 5, 4 } }, 24 );
+    layout.addCage( { { 8, 7 }, { 8, 8 } }, 10 );
+    layout.addCage( { { 1, 0 }, { 1, 1 } }, 10 );
+    EXPECT_FALSE( layout.isStandard() );
+    EXPECT_EQ( layout.unitCount(), 27u );
+    ASSERT_EQ( layout.cages().size(), 4u );
+
+    // only 1 + 2 and 7 + 8 + 9
+    const auto& pair = layout.cages()[0];
+    ASSERT_EQ( pair.combinationCount, 1u );
+    EXPECT_EQ( layout.combinations( pair )[0], 0x3u );
+    ASSERT_EQ( layout.cages()[1].combinationCount, 1u );
+    EXPECT_EQ( layout.combinations( layout.cages()[1] )[0], 0x1C0u );
+
+    // 1 + 9, 2 + 8, 3 + 7 and 4 + 6, one table for both cages
+    const auto& ten = layout.cages()[2];
+    EXPECT_EQ( ten.combinationCount, 4u );
+    EXPECT_EQ( layout.combinations( ten ), layout.combinations( layout.cages()[3] ) );
+    EXPECT_EQ( layout.cageCells( ten )[1], 80u );
+
+    const auto cages = layout.cageMemberships( 49 );
+    ASSERT_EQ( cages.second - cages.first, 1 );
+    EXPECT_EQ( cages.first->unit, 1u );
+    EXPECT_EQ( cages.first->position, 2u );
+    EXPECT_EQ( layout.cageMemberships( 2 ).first, layout.cageMemberships( 2 ).second );
+
+    EXPECT_THROW( layout.addCage( { { 2, 0 }, { 2, 1 } }, 2 ), std::invalid_argument );
+    EXPECT_THROW( layout.addCage( { { 2, 0 }, { 2, 0 } }, 5 ), std::invalid_argument );
+    EXPECT_THROW( layout.addCage( { { 2, 0 }, { 2, 9 } }, 5 ), std::invalid_argument );
+    EXPECT_THROW( layout.addCage( {}, 0 ), std::invalid_argument );
+    Layout large( 9 );
+    EXPECT_THROW( large.addCage( { { 0, 0 } }, 1 ), std::invalid_argument );
+}
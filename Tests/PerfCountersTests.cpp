@@ -0,0 +1,94 @@
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "FileParser.h"
+#include "PerfCounters.h"
+#include "ResultWriter.h"
+#include "Solver.h"
+
+using namespace Sudoku;
+
+namespace
+{
+const std::string Puzzle = "000000000590034600060000080400008009010000076000000500070900003300800260050070000";
+
+std::uint64_t total( const PerfSample& sample )
+{
+    return sample.cycles + sample.instructions + sample.l1Misses + sample.llcMisses + sample.branchMisses;
+}
+}
+
+TEST( PerfCountersTests, sample )
+{
+    PerfSample sample;
+    sample.cycles = 10;
+    sample.instructions = 20;
+    sample.branchMisses = 3;
+    PerfSample other;
+    other.cycles = 4;
+    other.l1Misses = 2;
+
+    sample += other;
+    EXPECT_EQ( sample.cycles, 14u );
+    EXPECT_EQ( sample.l1Misses, 2u );
+    const auto difference = sample - other;
+    EXPECT_EQ( difference.cycles, 10u );
+    EXPECT_EQ( difference.instructions, 20u );
+    EXPECT_EQ( difference.l1Misses, 0u );
+    EXPECT_EQ( difference.branchMisses, 3u );
+}
+
+TEST( PerfCountersTests, disabled )
+{
+    ASSERT_FALSE( PerfCounters::enabled() );
+    const auto propagation = PerfCounters::propagation();
+    const auto result = solve( parseLine( Puzzle ), SolveOptions{} );
+    ASSERT_EQ( result.status, SolveStatus::Solved );
+    EXPECT_EQ( total( result.stats.counters ), 0u );
+    EXPECT_EQ( total( result.stats.propagationCounters ), 0u );
+    EXPECT_EQ( total( PerfCounters::propagation() - propagation ), 0u );
+}
+
+TEST( PerfCountersTests, solve )
+{
+    // containers and virtual machines often hide the counters, the samples
+    // are then empty and the reason given
+    std::string reason;
+    const bool available = PerfCounters::available( &reason );
+    EXPECT_EQ( reason.empty(), available );
+    if( !available )
+    {
+        EXPECT_EQ( total( PerfCounters::read() ), 0u );
+    }
+
+    PerfCounters::enable();
+    const auto parsing = PerfCounters::parsing();
+    const auto board = parseLine( Puzzle );
+    const auto result = solve( board, SolveOptions{} );
+    std::string json;
+    {
+        ResultWriter writer( [&json]( const char* data, std::size_t size )
+            {
+                json.append( data, size );
+                return true;
+            }, OutputFormat::Json );
+        writer.write( result );
+    }
+    PerfCounters::disable();
+    ASSERT_EQ( result.status, SolveStatus::Solved );
+
+    EXPECT_NE( json.find( ",\"counters\":{\"cycles\":" + std::to_string( result.stats.counters.cycles ) + ",\"instructions\":" ), std::string::npos );
+    EXPECT_NE( json.find( ",\"propagationCounters\":{\"cycles\":" ), std::string::npos );
+    if( !available )
+    {
+        EXPECT_EQ( total( result.stats.counters ), 0u );
+        EXPECT_EQ( total( PerfCounters::parsing() - parsing ), 0u );
+        return;
+    }
+
+    EXPECT_GT( total( result.stats.counters ), 0u );
+    EXPECT_GT( total( result.stats.propagationCounters ), 0u );
+    EXPECT_GT( total( PerfCounters::parsing() - parsing ), 0u );
+    EXPECT_LE( result.stats.propagationCounters.instructions, result.stats.counters.instructions );
+}
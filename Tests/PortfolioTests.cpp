@@ -0,0 +1,133 @@
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "FileParser.h"
+#include "Portfolio.h"
+#include "Solver.h"
+
+using namespace Sudoku;
+
+namespace
+{
+const std::string Puzzle = "100000002090400050006000700050903000000070000000850040700000600030009080002000001";
+// only a search finds out that this one has no solution
+const std::string Unsolvable = "400000006080070510009500700060000091070930000000001200010320600036704000000100080";
+}
+
+TEST( PortfolioTests, defaultPortfolio )
+{
+    const auto configurations = defaultPortfolio( 7, 10 );
+    ASSERT_EQ( configurations.size(), 7u );
+    EXPECT_EQ( toString( configurations[0] ), "search/ascending" );
+    EXPECT_EQ( toString( configurations[1] ), "learn/ascending" );
+    EXPECT_EQ( toString( configurations[2] ), "anneal/seed=12" );
+    EXPECT_EQ( toString( configurations[3] ), "search/history" );
+    EXPECT_EQ( toString( configurations[4] ), "search/lcv" );
+    EXPECT_EQ( toString( configurations[5] ), "search/random/seed=15" );
+    EXPECT_EQ( toString( configurations[6] ), "learn/random/seed=16" );
+}
+
+TEST( PortfolioTests, solve )
+{
+    const Board board( 3, parseLineValues( Puzzle ) );
+    const auto configurations = defaultPortfolio( 4 );
+
+    const auto portfolio = solvePortfolio( board, SolveOptions{}, configurations );
+    ASSERT_LT( portfolio.winner, configurations.size() );
+    ASSERT_EQ( portfolio.result.status, SolveStatus::Solved );
+    EXPECT_EQ( portfolio.result.board, solve( board ) );
+}
+
+TEST( PortfolioTests, losersAreCancelled )
+{
+    // annealing can't tell that there is no solution, clause learning can
+    const Board board( 3, parseLineValues( Unsolvable ) );
+    std::vector<Configuration> configurations( 2 );
+    configurations[0].engine = Engine::Anneal;
+    configurations[1].engine = Engine::Learn;
+
+    const auto portfolio = solvePortfolio( board, SolveOptions{}, configurations );
+    EXPECT_EQ( portfolio.winner, 1u );
+    EXPECT_EQ( portfolio.result.status, SolveStatus::Unsolvable );
+}
+
+TEST( PortfolioTests, unsolvable )
+{
+    // the top row has no value left for its third cell
+    const Board::InputArray givens{
+        { 1, 2, 0, 0 },
+        { 0, 0, 0, 0 },
+        { 0, 0, 3, 0 },
+        { 0, 0, 4, 0 } };
+
+    const auto portfolio = solvePortfolio( Board( 2, givens ), SolveOptions{}, defaultPortfolio( 3 ) );
+    EXPECT_LT( portfolio.winner, 3u );
+    EXPECT_EQ( portfolio.result.status, SolveStatus::Unsolvable );
+}
+
+TEST( PortfolioTests, limits )
+{
+    SolveOptions options;
+    options.maxNodes = 1;
+    auto portfolio = solvePortfolio( Board( 4 ), options, defaultPortfolio( 2 ) );
+    EXPECT_EQ( portfolio.winner, 2u );
+    EXPECT_EQ( portfolio.result.status, SolveStatus::NodeLimitExceeded );
+
+    SolveOptions cancelled;
+    std::thread canceller( [cancelled]() mutable
+        {
+            std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+            cancelled.cancellation.cancel();
+        } );
+    std::vector<Configuration> configurations( 1 );
+    configurations[0].engine = Engine::Anneal;
+    portfolio = solvePortfolio( Board( 3, parseLineValues( Unsolvable ) ), cancelled, configurations );
+    canceller.join();
+    EXPECT_EQ( portfolio.winner, 1u );
+    EXPECT_EQ( portfolio.result.status, SolveStatus::Cancelled );
+
+    EXPECT_THROW( solvePortfolio( Board( 2 ), SolveOptions{}, {} ), std::invalid_argument );
+}
+
+TEST( PortfolioTests, sharedStates )
+{
+    std::vector<Configuration> configurations( 3 );
+    configurations[1].valueOrder = ValueOrder::History;
+    configurations[2].valueOrder = ValueOrder::Random;
+
+    const Board board( 3, parseLineValues( Puzzle ) );
+    auto portfolio = solvePortfolio( board, SolveOptions{}, configurations );
+    ASSERT_EQ( portfolio.result.status, SolveStatus::Solved );
+    EXPECT_EQ( portfolio.result.board, solve( board ) );
+
+    // the searches skip each other's states, so only the last one exhausted
+    // proves there is no solution
+    portfolio = solvePortfolio( Board( 3, parseLineValues( Unsolvable ) ), SolveOptions{}, configurations );
+    EXPECT_LT( portfolio.winner, 3u );
+    EXPECT_EQ( portfolio.result.status, SolveStatus::Unsolvable );
+    EXPECT_GT( portfolio.sharedHits, 0u );
+}
+
+TEST( PortfolioTests, inconclusiveSharedStates )
+{
+    // the one search that exhausts its states before the other reaches the
+    // node limit only skipped the states the other took: neither concludes
+    std::vector<Configuration> configurations( 2 );
+    SolveOptions options;
+    options.maxNodes = 5;
+    const Board board( 3, parseLineValues( Unsolvable ) );
+    for( int i = 0; i < 50; ++i )
+    {
+        const auto portfolio = solvePortfolio( board, options, configurations );
+        if( portfolio.winner == configurations.size() )
+        {
+            EXPECT_EQ( portfolio.result.status, SolveStatus::NodeLimitExceeded );
+        }
+        else
+        {
+            EXPECT_EQ( portfolio.result.status, SolveStatus::Unsolvable );
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#include "gtest/gtest.h"
+
+#include "FileParser.h"
+#include "Rater.h"
+
+using namespace Sudoku;
+
+namespace
+{
+std::size_t steps( const Rating& rating )
+{
+    std::size_t count = 0;
+    for( auto n : rating.histogram )
+    {
+        count += n;
+    }
+    return count;
+}
+}
+
+TEST( RaterTests, singles )
+{
+    Rater rater;
+    const auto clues = parseLineValues( "003020600900305001001806400008102900700000008006708200002609500800203009005010300" );
+    const auto rating = rater.rate( clues );
+
+    EXPECT_TRUE( rating.solved );
+    EXPECT_LE( rating.hardest, Technique::NakedSingle );
+    EXPECT_LT( rating.grade, weight( Technique::Pointing ) );
+    // each step of a singles-only puzzle fills one of its 49 empty cells
+    EXPECT_EQ( steps( rating ), 49u );
+}
+
+TEST( RaterTests, techniques )
+{
+    Rater rater;
+
+    auto rating = rater.rate( parseLineValues( "000000290530040000000000054000070081060000000012060547000004000003050070905003400" ) );
+    EXPECT_TRUE( rating.solved );
+    EXPECT_EQ( rating.hardest, Technique::Pointing );
+    EXPECT_GE( rating.grade, weight( Technique::Pointing ) );
+    EXPECT_LT( rating.grade, weight( Technique::Claiming ) );
+
+    rating = rater.rate( parseLineValues( "000000000590034600060000080400008009010000076000000500070900003300800260050070000" ) );
+    EXPECT_TRUE( rating.solved );
+    EXPECT_EQ( rating.hardest, Technique::NakedPair );
+    EXPECT_GT( rating.histogram[static_cast< std::size_t >( Technique::NakedPair )], 0u );
+}
+
+TEST( RaterTests, search )
+{
+    Rater rater;
+    const auto rating = rater.rate( parseLineValues( "800000000003600000070090200050007000000045700000100030001000068008500010090000400" ) );
+
+    EXPECT_FALSE( rating.solved );
+    EXPECT_EQ( rating.hardest, Technique::Search );
+    EXPECT_GE( rating.grade, weight( Technique::Search ) );
+}
+
+TEST( RaterTests, reuse )
+{
+    Rater rater;
+    const auto hard = parseLineValues( "000000000590034600060000080400008009010000076000000500070900003300800260050070000" );
+    const auto first = rater.rate( hard );
+
+    // rating boards of another size in between doesn't change the outcome
+    const auto small = rater.rate( Board::InputArray( 4, Nums( 4 ) ) );
+    EXPECT_EQ( small.hardest, Technique::Search );
+
+    const auto second = rater.rate( hard );
+    EXPECT_EQ( first.grade, second.grade );
+    EXPECT_EQ( first.histogram, second.histogram );
+}
+
+TEST( RaterTests, invalid )
+{
+    Rater rater;
+
+    // two 1s in the first row
+    auto clues = parseLineValues( "110000000000000000000000000000000000000000000000000000000000000000000000000000000" );
+    EXPECT_FALSE( rater.rate( clues ).solved );
+
+    EXPECT_THROW( rater.rate( Board::InputArray( 5, Nums( 5 ) ) ), std::invalid_argument );
+    clues[0][0] = 10;
+    EXPECT_THROW( rater.rate( clues ), std::invalid_argument );
+}
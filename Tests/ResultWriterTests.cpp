@@ -0,0 +1,173 @@
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "ResultWriter.h"
+#include "Utils.h"
+
+using namespace Sudoku;
+
+namespace
+{
+/**
+* @brief Collects what a writer writes, and the size of each write.
+*/
+struct Output
+{
+    std::string text;
+    std::vector<std::size_t> writes;
+
+    ResultWriter::Sink sink()
+    {
+        return [this]( const char* data, std::size_t size )
+            {
+                text.append( data, size );
+                writes.push_back( size );
+                return true;
+            };
+    }
+};
+
+SolveResult solved()
+{
+    Board board( 2 );
+    board.set( 0, 1, 4 );
+    board.set( 3, 3, 2 );
+    SolveResult result{ SolveStatus::Solved, board, {} };
+    result.stats.nodes = 12;
+    result.stats.elapsed = std::chrono::microseconds( 345 );
+    return result;
+}
+}
+
+TEST( ResultWriterTests, line )
+{
+    Output output;
+    {
+        ResultWriter writer( output.sink(), OutputFormat::Line );
+        const auto result = solved();
+        writer.write( result );
+        writer.write( SolveResult{ SolveStatus::Unsolvable, Board( 2 ), {} } );
+        writer.writeError( "bad line" );
+        writer.write( result.board );
+        EXPECT_TRUE( output.text.empty() );
+
+        // the same as the server responses
+        EXPECT_TRUE( writer.flush() );
+        EXPECT_EQ( output.text.substr( 0, output.text.find( '\n' ) ), toLine( result ) );
+    }
+    EXPECT_EQ( output.text,
+        "SOLVED 0400000000000002 12 345\n"
+        "UNSOLVABLE - 0 0\n"
+        "ERROR bad line\n"
+        "0400000000000002\n" );
+    EXPECT_EQ( output.writes.size(), 1u );
+
+    Output bare;
+    ResultWriter( bare.sink(), OutputFormat::Line, false ).write( solved() );
+    EXPECT_EQ( bare.text, "SOLVED 0400000000000002\n" );
+}
+
+TEST( ResultWriterTests, grid )
+{
+    Output output;
+    ResultWriter( output.sink(), OutputFormat::Grid ).write( solved() );
+    EXPECT_EQ( output.text, "SOLVED 12 345\n0 4 0 0 \n0 0 0 0 \n0 0 0 0 \n0 0 0 2 \n\n" );
+
+    // boards alone like operator<<
+    Board large( 4 );
+    large.set( 0, 0, 16 );
+    Output grid;
+    ResultWriter( grid.sink(), OutputFormat::Grid ).write( large );
+    std::ostringstream stream;
+    stream << large;
+    EXPECT_EQ( grid.text, stream.str() );
+    EXPECT_EQ( grid.text.substr( 0, 6 ), "16  0 " );
+}
+
+TEST( ResultWriterTests, json )
+{
+    Output output;
+    {
+        ResultWriter writer( output.sink(), OutputFormat::Json );
+        writer.write( solved() );
+        writer.write( SolveResult{ SolveStatus::DeadlineExceeded, Board( 2 ), {} } );
+        writer.writeError( "a \"quoted\"\tmessage\\" );
+        writer.write( Board( 2 ) );
+    }
+    EXPECT_EQ( output.text,
+        "{\"status\":\"SOLVED\",\"solution\":\"0400000000000002\",\"nodes\":12,\"micros\":345}\n"
+        "{\"status\":\"TIMEOUT\",\"solution\":null,\"nodes\":0,\"micros\":0}\n"
+        "{\"status\":\"ERROR\",\"error\":\"a \\\"quoted\\\"\\u0009message\\\\\"}\n"
+        "{\"board\":\"0000000000000000\"}\n" );
+
+    Output bare;
+    ResultWriter( bare.sink(), OutputFormat::Json, false ).write( solved() );
+    EXPECT_EQ( bare.text, "{\"status\":\"SOLVED\",\"solution\":\"0400000000000002\"}\n" );
+
+    EXPECT_EQ( parseOutputFormat( "json" ), OutputFormat::Json );
+    EXPECT_THROW( parseOutputFormat( "xml" ), std::invalid_argument );
+}
+
+TEST( ResultWriterTests, buffering )
+{
+    Output output;
+    const auto result = solved();
+    const auto line = toLine( result ) + "\n";
+    {
+        ResultWriter writer( output.sink(), OutputFormat::Line, true, 1024 );
+        for( int i = 0; i < 100; ++i )
+        {
+            writer.write( result );
+        }
+    }
+
+    // whole records in writes of nearly the buffer size
+    ASSERT_EQ( output.text.size(), 100 * line.size() );
+    EXPECT_LT( output.writes.size(), 100 * line.size() / 512 );
+    for( auto size : output.writes )
+    {
+        EXPECT_EQ( size % line.size(), 0u );
+        EXPECT_LE( size, 1024u );
+    }
+
+    // a record larger than the buffer still goes out whole
+    Output large;
+    ResultWriter( large.sink(), OutputFormat::Line, true, 16 ).write( Board( 5 ) );
+    EXPECT_EQ( large.writes.size(), 1u );
+    EXPECT_EQ( large.text, toLine( Board( 5 ) ) + "\n" );
+
+    // failures of the sink are reported
+    ResultWriter failing( []( const char*, std::size_t ) { return false; }, OutputFormat::Line );
+    failing.write( result );
+    EXPECT_TRUE( failing.good() );
+    EXPECT_FALSE( failing.flush() );
+    EXPECT_FALSE( failing.good() );
+}
+
+TEST( ResultWriterTests, flat )
+{
+    // the same records as for a board with the same values
+    const auto result = solved();
+    Nums cells( 16 );
+    for( Num cell = 0; cell < cells.size(); ++cell )
+    {
+        cells[cell] = result.board.at( cell / 4, cell % 4 );
+    }
+    const OutputFormat formats[] = { OutputFormat::Line, OutputFormat::Grid, OutputFormat::Json };
+    for( const auto format : formats )
+    {
+        Output board;
+        Output flat;
+        ResultWriter( board.sink(), format ).write( result );
+        ResultWriter( flat.sink(), format ).write( result.status, cells.data(), 4, result.stats );
+        EXPECT_EQ( flat.text, board.text );
+    }
+
+    Output unsolved;
+    ResultWriter( unsolved.sink(), OutputFormat::Line ).write( SolveStatus::Unsolvable, cells.data(), 4 );
+    EXPECT_EQ( unsolved.text, "UNSOLVABLE - 0 0\n" );
+}
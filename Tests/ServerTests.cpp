@@ -0,0 +1,58 @@
+#include <string>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "Server.h"
+#include "Socket.h"
+
+using namespace Sudoku;
+
+namespace
+{
+const std::string Puzzle = "000000000590034600060000080400008009010000076000000500070900003300800260050070000";
+}
+
+TEST( ServerTests, requests )
+{
+    ServerConfig config;
+    config.address = "unix:" + ::testing::TempDir() + "requests.sock";
+    config.threads = 2;
+    config.cacheSize = 16;
+
+    const int listener = listenOn( config.address );
+    int result = 0;
+    std::thread server( [&config, listener, &result] { result = serve( config, listener ); } );
+
+    // pipelined requests are answered in order, the repeated one from the cache
+    const int client = connectTo( config.address );
+    const auto requests = Puzzle + "\nnot a board\n\n" + Puzzle + "\n";
+    EXPECT_TRUE( writeAll( client, requests.data(), requests.size() ) );
+
+    LineReader reader( client );
+    std::string line;
+    EXPECT_TRUE( reader.next( line ) );
+    EXPECT_EQ( line.compare( 0, 7, "SOLVED " ), 0 ) << line;
+    const auto solution = line.substr( 7, Puzzle.size() );
+    EXPECT_TRUE( reader.next( line ) );
+    EXPECT_EQ( line.compare( 0, 6, "ERROR " ), 0 ) << line;
+    EXPECT_TRUE( reader.next( line ) );
+    EXPECT_EQ( line.compare( 0, 7, "SOLVED " ), 0 ) << line;
+    EXPECT_EQ( line.substr( 7, Puzzle.size() ), solution );
+
+    // shutting the listener down stops the server, which closes the open
+    // connections before returning
+    ::shutdown( listener, SHUT_RDWR );
+    server.join();
+    EXPECT_NE( result, 0 );
+
+    timeval timeout{ 5, 0 };
+    ::setsockopt( client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof( timeout ) );
+    char byte;
+    EXPECT_EQ( ::recv( client, &byte, 1, 0 ), 0 );
+    ::close( client );
+}
@@ -0,0 +1,91 @@
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "SharedTranspositionTable.h"
+
+using namespace Sudoku;
+
+TEST( SharedTranspositionTableTests, insert )
+{
+    SharedTranspositionTable table( 16 );
+    SharedTranspositionTable::Statistics statistics;
+
+    EXPECT_TRUE( table.insert( 0, statistics ) );
+    EXPECT_TRUE( table.insert( 42, statistics ) );
+    EXPECT_FALSE( table.insert( 42, statistics ) );
+    EXPECT_TRUE( table.contains( 0, statistics ) );
+    EXPECT_TRUE( table.contains( 42, statistics ) );
+    EXPECT_FALSE( table.contains( 7, statistics ) );
+    EXPECT_EQ( table.size(), 2u );
+    EXPECT_EQ( table.capacity(), 16u );
+
+    EXPECT_EQ( statistics.probes, 6u );
+    EXPECT_EQ( statistics.hits, 3u );
+    EXPECT_EQ( statistics.stores, 2u );
+    EXPECT_EQ( statistics.drops, 0u );
+
+    table.clear();
+    EXPECT_EQ( table.size(), 0u );
+    EXPECT_FALSE( table.contains( 42, statistics ) );
+}
+
+TEST( SharedTranspositionTableTests, full )
+{
+    SharedTranspositionTable table( 16 );
+    SharedTranspositionTable::Statistics statistics;
+
+    // a full table doesn't store new hashes, but still reports them as new
+    for( std::size_t i = 1; i <= 16; ++i )
+    {
+        ASSERT_TRUE( table.insert( i * 7919, statistics ) );
+    }
+    EXPECT_TRUE( table.insert( 5, statistics ) );
+    EXPECT_EQ( statistics.drops, 1u );
+    EXPECT_FALSE( table.contains( 5, statistics ) );
+    EXPECT_EQ( table.size(), 16u );
+}
+
+TEST( SharedTranspositionTableTests, threads )
+{
+    const std::size_t threadCount = 64;
+    const std::size_t hashes = 2000;
+    SharedTranspositionTable table( 8 * hashes );
+    std::vector<SharedTranspositionTable::Statistics> statistics( threadCount );
+    std::vector<std::size_t> added( threadCount );
+
+    // every thread inserts the same hashes, in a different order
+    std::vector<std::thread> threads;
+    for( std::size_t t = 0; t < threadCount; ++t )
+    {
+        threads.emplace_back( [&, t]()
+            {
+                for( std::size_t i = 0; i < hashes; ++i )
+                {
+                    const auto hash = ( i * 31 + t * 17 ) % hashes * 104729;
+                    added[t] += table.insert( hash, statistics[t] );
+                }
+            } );
+    }
+    for( auto& thread : threads )
+    {
+        thread.join();
+    }
+
+    SharedTranspositionTable::Statistics total;
+    std::size_t totalAdded = 0;
+    for( std::size_t t = 0; t < threadCount; ++t )
+    {
+        total += statistics[t];
+        totalAdded += added[t];
+    }
+
+    // each hash was new to exactly one thread
+    EXPECT_EQ( totalAdded, hashes );
+    EXPECT_EQ( total.stores, hashes );
+    EXPECT_EQ( total.drops, 0u );
+    EXPECT_EQ( total.probes, threadCount * hashes );
+    EXPECT_EQ( total.hits, ( threadCount - 1 ) * hashes );
+    EXPECT_EQ( table.size(), hashes );
+}
@@ -0,0 +1,79 @@
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "Socket.h"
+
+using namespace Sudoku;
+
+TEST( SocketTests, addresses )
+{
+    EXPECT_THROW( listenOn( "localhost:1234" ), std::runtime_error );
+    EXPECT_THROW( listenOn( "unix:" ), std::runtime_error );
+    EXPECT_THROW( listenOn( "unix:" + std::string( 200, 'x' ) ), std::runtime_error );
+    EXPECT_THROW( listenOn( "tcp:0" ), std::runtime_error );
+    EXPECT_THROW( listenOn( "tcp:65536" ), std::runtime_error );
+
+    const auto address = "unix:" + ::testing::TempDir() + "addresses.sock";
+    EXPECT_THROW( connectTo( address ), std::runtime_error );
+
+    // a socket file left behind doesn't prevent listening again
+    ::close( listenOn( address ) );
+    const int listener = listenOn( address );
+    const int client = connectTo( address );
+    const int server = ::accept( listener, nullptr, nullptr );
+    ASSERT_GE( server, 0 );
+
+    EXPECT_TRUE( writeAll( client, "ping\n", 5 ) );
+    LineReader reader( server );
+    std::string line;
+    EXPECT_TRUE( reader.next( line ) );
+    EXPECT_EQ( line, "ping" );
+
+    ::close( server );
+    ::close( client );
+    ::close( listener );
+}
+
+TEST( SocketTests, lines )
+{
+    int fds[2];
+    ASSERT_EQ( ::socketpair( AF_UNIX, SOCK_STREAM, 0, fds ), 0 );
+
+    // a line longer than the read buffer, and one without terminator
+    const std::string longLine( 100 * 1024, 'x' );
+    const auto data = "first\r\n\nsecond\n" + longLine + "\nlast";
+    std::string line;
+    {
+        std::thread writer( [&fds, &data]
+            {
+                EXPECT_TRUE( writeAll( fds[1], data.data(), data.size() ) );
+                ::shutdown( fds[1], SHUT_WR );
+            } );
+        LineReader reader( fds[0] );
+
+        EXPECT_TRUE( reader.next( line ) );
+        EXPECT_EQ( line, "first" );
+        EXPECT_TRUE( reader.next( line ) );
+        EXPECT_EQ( line, "" );
+        EXPECT_TRUE( reader.next( line ) );
+        EXPECT_EQ( line, "second" );
+        EXPECT_TRUE( reader.next( line ) );
+        EXPECT_EQ( line, longLine );
+        EXPECT_TRUE( reader.next( line ) );
+        EXPECT_EQ( line, "last" );
+        EXPECT_FALSE( reader.next( line ) );
+        EXPECT_TRUE( line.empty() );
+        writer.join();
+    }
+
+    // writing to a closed connection fails instead of raising SIGPIPE
+    ::close( fds[0] );
+    EXPECT_FALSE( writeAll( fds[1], "x\n", 2 ) );
+    ::close( fds[1] );
+}
@@ -0,0 +1,61 @@
+#include "gtest/gtest.h"
+
+#include "FileParser.h"
+#include "SolutionCache.h"
+#include "Solver.h"
+
+using namespace Sudoku;
+
+TEST( SolutionCacheTests, lru )
+{
+    SolutionCache cache( 2 );
+    const Digest first{ 1, 1 }, second{ 2, 2 }, third{ 3, 3 };
+    Nums solution;
+
+    cache.insert( first, { 1 } );
+    cache.insert( second, { 2 } );
+    EXPECT_TRUE( cache.find( first, solution ) );
+    EXPECT_EQ( solution, Nums{ 1 } );
+
+    // 'second' is now the least recently used entry
+    cache.insert( third, { 3 } );
+    EXPECT_EQ( cache.size(), 2u );
+    EXPECT_FALSE( cache.find( second, solution ) );
+    EXPECT_TRUE( cache.find( first, solution ) );
+    EXPECT_TRUE( cache.find( third, solution ) );
+    EXPECT_EQ( solution, Nums{ 3 } );
+    EXPECT_EQ( cache.hits(), 3u );
+    EXPECT_EQ( cache.misses(), 1u );
+
+    EXPECT_THROW( SolutionCache( 0 ), std::invalid_argument );
+}
+
+TEST( SolutionCacheTests, solve )
+{
+    SolutionCache cache( 16 );
+    SolverContext context;
+    const auto givens = parseLineValues( "100000002090400050006000700050903000000070000000850040700000600030009080002000001" );
+
+    // the same puzzle, transposed
+    Board::InputArray transposed( 9, Nums( 9 ) );
+    for( Num i = 0; i < 9; ++i )
+    {
+        for( Num j = 0; j < 9; ++j )
+        {
+            transposed[j][i] = givens[i][j];
+        }
+    }
+
+    const auto expected = solve( Board( 3, transposed ), SolveOptions{} ).board;
+
+    const auto& miss = solve( givens, SolveOptions{}, context, cache );
+    ASSERT_EQ( miss.status, SolveStatus::Solved );
+    EXPECT_GT( miss.stats.nodes, 0u );
+    EXPECT_EQ( cache.size(), 1u );
+
+    const auto& hit = solve( transposed, SolveOptions{}, context, cache );
+    ASSERT_EQ( hit.status, SolveStatus::Solved );
+    EXPECT_EQ( hit.stats.nodes, 0u );
+    EXPECT_EQ( hit.board, expected );
+    EXPECT_EQ( cache.hits(), 1u );
+}
@@ -0,0 +1,217 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "FileParser.h"
+#include "SolutionStore.h"
+#include "Solver.h"
+
+using namespace Sudoku;
+
+namespace
+{
+std::string storePath( const std::string& name )
+{
+    const auto path = ::testing::TempDir() + name;
+    std::remove( path.c_str() );
+    return path;
+}
+
+std::size_t fileLength( const std::string& path )
+{
+    std::ifstream file( path, std::ios::binary | std::ios::ate );
+    return static_cast< std::size_t >( file.tellg() );
+}
+}
+
+TEST( SolutionStoreTests, persist )
+{
+    const auto path = storePath( "persist.store" );
+    const Digest first{ 1, 2 }, second{ 3, 4 };
+    Nums solution;
+    {
+        SolutionStore store( path );
+        EXPECT_FALSE( store.find( first, solution ) );
+        store.insert( first, { 1, 2, 3, 4 } );
+        store.insert( second, { 4, 3, 2, 1 } );
+        store.insert( first, { 4, 3, 2, 1 } );
+        EXPECT_EQ( store.size(), 2u );
+    }
+
+    SolutionStore store( path );
+    EXPECT_EQ( store.size(), 2u );
+    ASSERT_TRUE( store.find( first, solution ) );
+    EXPECT_EQ( solution, ( Nums{ 1, 2, 3, 4 } ) );
+    ASSERT_TRUE( store.find( second, solution ) );
+    EXPECT_EQ( solution, ( Nums{ 4, 3, 2, 1 } ) );
+}
+
+TEST( SolutionStoreTests, tornRecord )
+{
+    const auto path = storePath( "torn.store" );
+    std::size_t size = 0;
+    {
+        SolutionStore store( path );
+        store.insert( { 1, 2 }, { 1, 2, 3, 4 } );
+        size = store.fileSize();
+    }
+    {
+        // a writer crashed in the middle of a record
+        std::ofstream file( path, std::ios::binary | std::ios::app );
+        file << "garbage";
+    }
+
+    SolutionStore store( path );
+    EXPECT_EQ( store.size(), 1u );
+    EXPECT_EQ( fileLength( path ), size );
+
+    store.insert( { 3, 4 }, { 4, 3, 2, 1 } );
+    EXPECT_EQ( SolutionStore( path ).size(), 2u );
+
+    std::ofstream( path + ".bad" ) << "not a store";
+    EXPECT_THROW( SolutionStore( path + ".bad" ), std::runtime_error );
+}
+
+TEST( SolutionStoreTests, tornWhileOpen )
+{
+    const auto path = storePath( "tornopen.store" );
+    SolutionStore store( path );
+    store.insert( { 1, 2 }, { 1, 2, 3, 4 } );
+    {
+        // another writer crashed in the middle of a record
+        std::ofstream file( path, std::ios::binary | std::ios::app );
+        file << "garbage";
+    }
+
+    // the record goes where the torn one started, not after it
+    store.insert( { 3, 4 }, { 4, 3, 2, 1 } );
+    Nums solution;
+    EXPECT_TRUE( store.find( { 3, 4 }, solution ) );
+    SolutionStore reopened( path );
+    EXPECT_EQ( reopened.size(), 2u );
+    EXPECT_TRUE( reopened.find( { 3, 4 }, solution ) );
+    EXPECT_EQ( solution, ( Nums{ 4, 3, 2, 1 } ) );
+}
+
+TEST( SolutionStoreTests, sharedFile )
+{
+    const auto path = storePath( "shared.store" );
+    SolutionStore writer( path );
+    SolutionStore reader( path );
+    Nums solution;
+
+    writer.insert( { 1, 1 }, { 1 } );
+    EXPECT_FALSE( reader.find( { 1, 1 }, solution ) );
+    reader.refresh();
+    EXPECT_TRUE( reader.find( { 1, 1 }, solution ) );
+
+    // the reader doesn't append a second record for a key the writer added
+    writer.insert( { 2, 2 }, { 2 } );
+    const auto size = writer.fileSize();
+    reader.insert( { 2, 2 }, { 2 } );
+    EXPECT_EQ( reader.fileSize(), size );
+
+    writer.insert( { 3, 3 }, { 3 } );
+    writer.compact( 2 );
+    EXPECT_EQ( writer.size(), 2u );
+    EXPECT_FALSE( writer.find( { 1, 1 }, solution ) );
+    EXPECT_LT( fileLength( path ), size + 8 );
+
+    // the reader switches to the compacted file
+    reader.refresh();
+    EXPECT_EQ( reader.size(), 2u );
+    EXPECT_TRUE( reader.find( { 3, 3 }, solution ) );
+    EXPECT_EQ( solution, Nums{ 3 } );
+}
+
+TEST( SolutionStoreTests, compactWhileInserting )
+{
+    const auto path = storePath( "compacting.store" );
+    SolutionStore writer( path );
+    SolutionStore compactor( path );
+    compactor.insert( { 1, 1 }, { 1 } );
+    compactor.compact();
+
+    // the writer appends to the compacted file, not the one it opened
+    writer.insert( { 2, 2 }, { 2 } );
+    EXPECT_EQ( SolutionStore( path ).size(), 2u );
+
+    // replace the file while the writer waits for its lock
+    const auto replacement = storePath( "compacting.store.new" );
+    SolutionStore( replacement ).insert( { 3, 3 }, { 3 } );
+    const int fd = ::open( path.c_str(), O_RDWR | O_CLOEXEC );
+    ASSERT_GE( fd, 0 );
+    ASSERT_EQ( ::flock( fd, LOCK_EX ), 0 );
+    std::thread inserter( [&writer] { writer.insert( { 4, 4 }, { 4 } ); } );
+    std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+    ASSERT_EQ( std::rename( replacement.c_str(), path.c_str() ), 0 );
+    ::flock( fd, LOCK_UN );
+    inserter.join();
+    ::close( fd );
+
+    SolutionStore reopened( path );
+    Nums solution;
+    EXPECT_EQ( reopened.size(), 2u );
+    EXPECT_TRUE( reopened.find( { 3, 3 }, solution ) );
+    EXPECT_TRUE( reopened.find( { 4, 4 }, solution ) );
+    EXPECT_EQ( solution, Nums{ 4 } );
+}
+
+TEST( SolutionStoreTests, concurrentReaders )
+{
+    const auto path = storePath( "readers.store" );
+    SolutionStore store( path );
+    for( std::uint64_t i = 0; i < 100; ++i )
+    {
+        store.insert( { i, i }, { i % 10 } );
+    }
+
+    std::vector<std::thread> readers;
+    std::vector<int> found( 4, 0 );
+    for( std::size_t t = 0; t < found.size(); ++t )
+    {
+        readers.emplace_back( [&store, &found, t]()
+            {
+                Nums solution;
+                for( std::uint64_t i = 0; i < 100; ++i )
+                {
+                    found[t] += store.find( { i, i }, solution ) && solution == Nums{ i % 10 };
+                }
+            } );
+    }
+    for( auto& reader : readers )
+    {
+        reader.join();
+    }
+    EXPECT_EQ( found, std::vector<int>( 4, 100 ) );
+}
+
+TEST( SolutionStoreTests, solve )
+{
+    const auto path = storePath( "solve.store" );
+    const auto givens = parseLineValues( "000000290530040000000000054000070081060000000012060547000004000003050070905003400" );
+    SolverContext context;
+    Board solution( 3 );
+    {
+        SolutionStore store( path );
+        const auto& result = solve( givens, SolveOptions{}, context, store );
+        ASSERT_EQ( result.status, SolveStatus::Solved );
+        solution = result.board;
+    }
+
+    // a new process finds the solution without searching
+    SolutionStore store( path );
+    const auto& result = solve( givens, SolveOptions{}, context, store );
+    ASSERT_EQ( result.status, SolveStatus::Solved );
+    EXPECT_EQ( result.stats.nodes, 0u );
+    EXPECT_EQ( result.board, solution );
+}
@@ -0,0 +1,341 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "gtest/gtest.h"
+
+#include "FileParser.h"
+#include "Solver.h"
+#include "Search.h"
+
+using namespace Sudoku;
+
+namespace
+{
+std::atomic<std::size_t> allocations{ 0 };
+}
+
+// count every allocation of the test program, to check solves that must not allocate
+void* operator new( std::size_t size )
+{
+    ++allocations;
+    if( void* p = std::malloc( size ? size : 1 ) )
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete( void* p ) noexcept
+{
+    std::free( p );
+}
+
+void operator delete( void* p, std::size_t ) noexcept
+{
+    std::free( p );
+}
+
+namespace
+{
+const Board::InputArray Puzzle{
+    {
+        {0,0,0,0,0,0,0,0,0},
+        {5,9,0,0,3,4,6,0,0},
+        {0,6,0,0,0,0,0,8,0},
+        {4,0,0,0,0,8,0,0,9},
+        {0,1,0,0,0,0,0,7,6},
+        {0,0,0,0,0,0,5,0,0},
+        {0,7,0,9,0,0,0,0,3},
+        {3,0,0,8,0,0,2,6,0},
+        {0,5,0,0,7,0,0,0,0},
+    }
+};
+
+bool matchesClues( const Board& solution, const Board::InputArray& clues )
+{
+    for( Num i = 0; i < solution.dimension(); ++i )
+    {
+        for( Num j = 0; j < solution.dimension(); ++j )
+        {
+            if( clues[i][j] != 0 && clues[i][j] != solution.at( i, j ) )
+                return false;
+        }
+    }
+    return true;
+}
+}
+
+TEST( SolverTests, solve )
+{
+    Board b( 3, Puzzle );
+
+    auto s = solve( b );
+
+    ASSERT_TRUE( s.isSolved() );
+    ASSERT_TRUE( s.isValid() );
+    EXPECT_TRUE( matchesClues( s, Puzzle ) );
+}
+
+TEST( SolverTests, unsolvable )
+{
+    // cell (0, 0) is left with no possibilities
+    Board b( 2 );
+    b.set( 0, 2, 1 );
+    b.set( 0, 3, 2 );
+    b.set( 2, 0, 3 );
+    b.set( 1, 1, 4 );
+
+    auto s = solve( b );
+
+    EXPECT_FALSE( s.isSolved() );
+    EXPECT_EQ( s, b );
+}
+
+TEST( SolverTests, filledContradiction )
+{
+    // propagation fills every cell, repeating values in some units
+    const auto board = parseLine( "700008190030906805008030000075000000003004001190700000000000530000080040084300002" );
+    ASSERT_FALSE( Board( board ).isValid() );
+
+    const auto result = solve( board, SolveOptions{} );
+    EXPECT_EQ( result.status, SolveStatus::Unsolvable );
+    EXPECT_EQ( result.stats.nodes, 0u );
+    Search search( board );
+    EXPECT_EQ( search.status(), Search::Status::Exhausted );
+}
+
+TEST( SolverTests, searchSteps )
+{
+    Board b( 3, Puzzle );
+    Search search( b );
+
+    ASSERT_EQ( search.status(), Search::Status::Running );
+    ASSERT_EQ( search.frames().size(), 1u );
+
+    // the search can be paused at any step and its stack inspected
+    std::size_t maxDepth = 0;
+    while( search.step() == Search::Status::Running )
+    {
+        maxDepth = std::max( maxDepth, search.frames().size() );
+    }
+
+    ASSERT_EQ( search.status(), Search::Status::Solved );
+    EXPECT_GT( maxDepth, 0u );
+    EXPECT_EQ( search.board(), solve( b ) );
+}
+
+TEST( SolverTests, rollback )
+{
+    Board b( 3, Puzzle );
+    Board original( b );
+
+    b.recordChanges( true );
+    const auto checkpoint = b.checkpoint();
+
+    b.set( 0, 0, 1 );
+    ASSERT_NE( b, original );
+
+    b.rollback( checkpoint );
+    for( Num i = 0; i < b.dimension(); ++i )
+    {
+        for( Num j = 0; j < b.dimension(); ++j )
+        {
+            EXPECT_EQ( b.cell( i, j ), original.cell( i, j ) );
+        }
+    }
+}
+
+TEST( SolverTests, options )
+{
+    Board b( 3, Puzzle );
+
+    auto result = solve( b, SolveOptions{} );
+    ASSERT_EQ( result.status, SolveStatus::Solved );
+    EXPECT_TRUE( result.board.isSolved() );
+    EXPECT_GT( result.stats.nodes, 0u );
+    EXPECT_GT( result.stats.maxDepth, 0u );
+}
+
+TEST( SolverTests, nodeLimit )
+{
+    Board b( 3, Puzzle );
+    SolveOptions options;
+    options.maxNodes = 1;
+
+    auto result = solve( b, options );
+    ASSERT_EQ( result.status, SolveStatus::NodeLimitExceeded );
+    EXPECT_EQ( result.stats.nodes, 1u );
+    EXPECT_EQ( result.board, b );
+}
+
+TEST( SolverTests, deadline )
+{
+    Board b( 3, Puzzle );
+    SolveOptions options;
+    options.deadline = SolveOptions::Clock::now();
+
+    auto result = solve( b, options );
+    ASSERT_EQ( result.status, SolveStatus::DeadlineExceeded );
+    EXPECT_EQ( result.stats.nodes, 0u );
+}
+
+TEST( SolverTests, cancelled )
+{
+    Board b( 3, Puzzle );
+    SolveOptions options;
+    auto token = options.cancellation;
+    token.cancel();
+
+    auto result = solve( b, options );
+    ASSERT_EQ( result.status, SolveStatus::Cancelled );
+    EXPECT_TRUE( options.cancellation.cancelled() );
+}
+
+TEST( SolverTests, contextReuse )
+{
+    Board b( 3, Puzzle );
+    SolverContext context( 3 );
+
+    const auto expected = solve( b );
+    ASSERT_EQ( solve( b, SolveOptions{}, context ).board, expected );
+
+    // once warmed up, solving boards of the same size does not allocate
+    const SolveOptions options;
+    const auto before = allocations.load();
+    const auto& result = solve( b, options, context );
+    const auto after = allocations.load();
+
+    ASSERT_EQ( result.status, SolveStatus::Solved );
+    EXPECT_EQ( result.board, expected );
+    EXPECT_EQ( after, before );
+}
+
+TEST( SolverTests, valueOrders )
+{
+    Board b( 3, Puzzle );
+    SolverContext context( 3 );
+    const auto expected = solve( b );
+
+    for( auto order : { ValueOrder::Ascending, ValueOrder::Random, ValueOrder::LeastConstraining, ValueOrder::History } )
+    {
+        SolveOptions options;
+        options.valueOrder = order;
+        options.seed = 5;
+        ASSERT_EQ( solve( b, options, context ).board, expected );
+
+        // ordering the values doesn't allocate either
+        const auto before = allocations.load();
+        const auto& result = solve( b, options, context );
+        const auto after = allocations.load();
+
+        ASSERT_EQ( result.status, SolveStatus::Solved );
+        EXPECT_EQ( result.board, expected );
+        EXPECT_EQ( after, before );
+    }
+}
+
+TEST( SolverTests, countSolutions )
+{
+    SolverContext context;
+
+    // an empty 4x4 board has 288 solutions
+    auto count = countSolutions( Board( 2 ), 1000, SolveOptions{}, context );
+    EXPECT_EQ( count.status, SolveStatus::Unsolvable );
+    EXPECT_EQ( count.solutions, 288u );
+
+    count = countSolutions( Board( 2 ), 2, SolveOptions{}, context );
+    EXPECT_EQ( count.status, SolveStatus::Solved );
+    EXPECT_EQ( count.solutions, 2u );
+}
+
+TEST( SolverTests, variants )
+{
+    const auto check = []( const Board& board )
+        {
+            const auto& layout = board.layout();
+            const auto dim = board.dimension();
+            for( std::size_t unit = 0; unit < layout.unitCount(); ++unit )
+            {
+                Nums values;
+                for( Num i = 0; i < dim; ++i )
+                {
+                    const auto cell = layout.unit( unit )[i];
+                    values.push_back( board.at( cell / dim, cell % dim ) );
+                }
+                std::sort( values.begin(), values.end() );
+                ASSERT_EQ( std::unique( values.begin(), values.end() ), values.end() ) << unit;
+                ASSERT_NE( values.front(), 0u ) << unit;
+            }
+        };
+
+    Layout diagonals( 3 );
+    diagonals.addDiagonals();
+    diagonals.addWindows();
+    auto result = solve( Board( diagonals ), SolveOptions{} );
+    ASSERT_EQ( result.status, SolveStatus::Solved );
+    check( result.board );
+
+    Layout jigsaw( 2 );
+    jigsaw.setRegions( {
+        { 1, 1, 1, 2 },
+        { 3, 1, 2, 2 },
+        { 3, 3, 4, 2 },
+        { 3, 4, 4, 4 } } );
+    result = solve( Board( jigsaw, { { 0, 0, 0, 2 }, { 0, 0, 0, 0 }, { 0, 0, 0, 0 }, { 0, 0, 0, 0 } } ), SolveOptions{} );
+    ASSERT_EQ( result.status, SolveStatus::Solved );
+    EXPECT_EQ( result.board.at( 0, 3 ), 2u );
+    check( result.board );
+
+    // a 1 on the main diagonal twice
+    EXPECT_THROW( Board( diagonals, Board::InputArray{
+        { 1, 0, 0, 0, 0, 0, 0, 0, 0 },
+        { 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+        { 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+        { 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+        { 0, 0, 0, 0, 1, 0, 0, 0, 0 },
+        { 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+        { 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+        { 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+        { 0, 0, 0, 0, 0, 0, 0, 0, 0 } } ), std::invalid_argument );
+}
+
+TEST( SolverTests, killer )
+{
+    // cages over the rows of a solution, given no values
+    const auto solution = solve( Board( 3, Puzzle ) );
+    Layout layout( 3 );
+    for( Num row = 0; row < 9; ++row )
+    {
+        for( Num col = 0; col < 9; col += 3 )
+        {
+            const Num sums[] = { solution.at( row, col ) + solution.at( row, col + 1 ), solution.at( row, col + 2 ) };
+            layout.addCage( { { row, col }, { row, col + 1 } }, sums[0] );
+            layout.addCage( { { row, col + 2 } }, sums[1] );
+        }
+    }
+
+    const Board board( layout );
+    SolverContext context( 3 );
+    ASSERT_EQ( solve( board, SolveOptions{}, context ).status, SolveStatus::Solved );
+
+    // cage propagation doesn't allocate either
+    const SolveOptions options;
+    const auto before = allocations.load();
+    const auto& result = solve( board, options, context );
+    const auto after = allocations.load();
+
+    ASSERT_EQ( result.status, SolveStatus::Solved );
+    EXPECT_EQ( after, before );
+    auto copy = result.board;
+    EXPECT_TRUE( copy.isValid() );
+    for( const auto& cage : layout.cages() )
+    {
+        Num sum = 0;
+        for( Num i = 0; i < cage.size; ++i )
+        {
+            const auto cell = layout.cageCells( cage )[i];
+            sum += result.board.at( cell / 9, cell % 9 );
+        }
+        EXPECT_EQ( sum, cage.sum );
+    }
+}
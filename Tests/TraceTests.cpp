@@ -0,0 +1,84 @@
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "Solver.h"
+#include "Trace.h"
+
+using namespace Sudoku;
+
+namespace
+{
+const Board::InputArray Puzzle{
+    {
+        {0,0,0,0,0,0,0,0,0},
+        {5,9,0,0,3,4,6,0,0},
+        {0,6,0,0,0,0,0,8,0},
+        {4,0,0,0,0,8,0,0,9},
+        {0,1,0,0,0,0,0,7,6},
+        {0,0,0,0,0,0,5,0,0},
+        {0,7,0,9,0,0,0,0,3},
+        {3,0,0,8,0,0,2,6,0},
+        {0,5,0,0,7,0,0,0,0},
+    }
+};
+}
+
+TEST( TraceTests, disabled )
+{
+    Trace::clear();
+    ASSERT_FALSE( Trace::enabled() );
+    solve( Board( 3, Puzzle ), SolveOptions{} );
+    EXPECT_EQ( Trace::size(), 0u );
+}
+
+TEST( TraceTests, solve )
+{
+    Trace::enable();
+    const auto result = solve( Board( 3, Puzzle ), SolveOptions{} );
+    Trace::disable();
+    ASSERT_EQ( result.status, SolveStatus::Solved );
+
+    // a set and a propagation per node at least, and the solve around them
+    EXPECT_GT( Trace::size(), 2 * result.stats.nodes );
+    std::ostringstream stream;
+    Trace::write( stream );
+    const auto json = stream.str();
+    EXPECT_EQ( json.compare( 0, 15, "{\"traceEvents\":" ), 0 );
+    EXPECT_NE( json.find( "\"name\":\"solve\",\"pid\":1,\"tid\":0" ), std::string::npos );
+    EXPECT_NE( json.find( "\"args\":{\"nodes\":" + std::to_string( result.stats.nodes ) + "}" ), std::string::npos );
+    EXPECT_NE( json.find( "\"name\":\"propagate\"" ), std::string::npos );
+    EXPECT_NE( json.find( "\"name\":\"set\"" ), std::string::npos );
+    EXPECT_NE( json.find( "\"ph\":\"i\"" ), std::string::npos );
+
+    // nothing more once disabled
+    const auto size = Trace::size();
+    solve( Board( 3, Puzzle ), SolveOptions{} );
+    EXPECT_EQ( Trace::size(), size );
+    Trace::clear();
+    EXPECT_EQ( Trace::size(), 0u );
+}
+
+TEST( TraceTests, ringBuffer )
+{
+    Trace::enable( 8 );
+    for( std::uint64_t i = 0; i < 20; ++i )
+    {
+        Trace::instant( "tick", "i", i );
+    }
+    std::thread other( []() { TraceScope scope( "other" ); } );
+    other.join();
+    Trace::disable();
+
+    // the latest events of each thread, oldest first
+    EXPECT_EQ( Trace::size(), 9u );
+    std::ostringstream stream;
+    Trace::write( stream );
+    const auto json = stream.str();
+    EXPECT_EQ( json.find( "{\"i\":11}" ), std::string::npos );
+    EXPECT_LT( json.find( "{\"i\":12}" ), json.find( "{\"i\":19}" ) );
+    EXPECT_NE( json.find( "\"name\":\"other\",\"pid\":1,\"tid\":1" ), std::string::npos );
+    Trace::clear();
+}
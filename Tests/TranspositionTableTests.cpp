@@ -0,0 +1,49 @@
+#include "gtest/gtest.h"
+
+#include "TranspositionTable.h"
+
+using namespace Sudoku;
+
+TEST( TranspositionTableTests, insert )
+{
+    TranspositionTable table( 16 );
+
+    EXPECT_TRUE( table.insert( 0 ) );
+    EXPECT_TRUE( table.insert( 42 ) );
+    EXPECT_FALSE( table.insert( 42 ) );
+    EXPECT_TRUE( table.contains( 0 ) );
+    EXPECT_TRUE( table.contains( 42 ) );
+    EXPECT_FALSE( table.contains( 7 ) );
+    EXPECT_EQ( table.size(), 2u );
+}
+
+TEST( TranspositionTableTests, grow )
+{
+    TranspositionTable table( 16 );
+
+    for( std::size_t i = 0; i < 1000; ++i )
+    {
+        ASSERT_TRUE( table.insert( i * 7919 ) );
+    }
+    EXPECT_EQ( table.size(), 1000u );
+    EXPECT_GE( table.capacity(), 1000u );
+
+    for( std::size_t i = 0; i < 1000; ++i )
+    {
+        ASSERT_TRUE( table.contains( i * 7919 ) );
+    }
+}
+
+TEST( TranspositionTableTests, clear )
+{
+    TranspositionTable table( 16 );
+    table.insert( 1 );
+    table.insert( 2 );
+    const auto capacity = table.capacity();
+
+    table.clear();
+    EXPECT_EQ( table.size(), 0u );
+    EXPECT_EQ( table.capacity(), capacity );
+    EXPECT_FALSE( table.contains( 1 ) );
+    EXPECT_TRUE( table.insert( 1 ) );
+}
@@ -0,0 +1,137 @@
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "Verifier.h"
+
+using namespace Sudoku;
+
+namespace
+{
+/**
+* @brief Makes a valid grid of a standard layout: each row shifts the
+* previous one by a block, and by one more at each band.
+*/
+Nums validGrid( Num blockSize )
+{
+    const auto dim = blockSize * blockSize;
+    Nums grid( dim * dim );
+    for( Num row = 0; row < dim; ++row )
+    {
+        for( Num column = 0; column < dim; ++column )
+        {
+            grid[row * dim + column] = ( row * blockSize + row / blockSize + column ) % dim + 1;
+        }
+    }
+    return grid;
+}
+}
+
+TEST( VerifierTests, verdicts )
+{
+    Verifier verifier( 3 );
+    const auto solution = validGrid( 3 );
+    auto puzzle = solution;
+    for( std::size_t cell = 0; cell < puzzle.size(); cell += 2 )
+    {
+        puzzle[cell] = 0;
+    }
+    EXPECT_EQ( verifier.verify( puzzle.data(), solution.data() ), Verdict::Valid );
+    EXPECT_EQ( verifier.verify( nullptr, solution.data() ), Verdict::Valid );
+
+    auto swapped = solution;
+    std::swap( swapped[0], swapped[1] );
+    EXPECT_EQ( verifier.verify( nullptr, swapped.data() ), Verdict::Invalid );
+    auto outOfRange = solution;
+    outOfRange[40] = 10;
+    EXPECT_EQ( verifier.verify( nullptr, outOfRange.data() ), Verdict::Invalid );
+    auto incomplete = solution;
+    incomplete[0] = 0;
+    EXPECT_EQ( verifier.verify( nullptr, incomplete.data() ), Verdict::Incomplete );
+    // cell 1 is a given
+    EXPECT_EQ( verifier.verify( puzzle.data(), swapped.data() ), Verdict::Mismatch );
+    EXPECT_EQ( verifier.verify( puzzle.data(), incomplete.data() ), Verdict::Incomplete );
+
+    EXPECT_STREQ( toString( Verdict::Mismatch ), "MISMATCH" );
+}
+
+TEST( VerifierTests, bulk )
+{
+    // more than a few groups of lanes, and some grids past the last group
+    const std::size_t count = 5 * Verifier::Lanes + 3;
+    const auto valid = validGrid( 3 );
+    Nums puzzles;
+    Nums solutions;
+    std::vector<Verdict> expected;
+    for( std::size_t grid = 0; grid < count; ++grid )
+    {
+        auto puzzle = valid;
+        auto solution = valid;
+        puzzle[grid % 81] = 0;
+        switch( grid % 5 )
+        {
+        case 1:
+            puzzle[( grid + 9 ) % 81] = 0;
+            std::swap( solution[grid % 81], solution[( grid + 9 ) % 81] );
+            expected.push_back( Verdict::Invalid );
+            break;
+        case 2:
+            solution[80] = 0;
+            expected.push_back( grid % 81 == 80 ? Verdict::Incomplete : Verdict::Mismatch );
+            break;
+        case 3:
+            solution[grid % 81] = 0;
+            expected.push_back( Verdict::Incomplete );
+            break;
+        default:
+            expected.push_back( Verdict::Valid );
+            break;
+        }
+        puzzles.insert( puzzles.end(), puzzle.begin(), puzzle.end() );
+        solutions.insert( solutions.end(), solution.begin(), solution.end() );
+    }
+
+    Verifier verifier( 3 );
+    std::vector<Verdict> verdicts( count );
+    verifier.verify( puzzles.data(), solutions.data(), count, verdicts.data() );
+    EXPECT_EQ( verdicts, expected );
+    for( std::size_t grid = 0; grid < count; ++grid )
+    {
+        EXPECT_EQ( verifier.verify( puzzles.data() + grid * 81, solutions.data() + grid * 81 ), expected[grid] );
+    }
+}
+
+TEST( VerifierTests, sizes )
+{
+    for( Num blockSize : { 1, 2, 4, 9 } )
+    {
+        Verifier verifier( blockSize );
+        auto grid = validGrid( blockSize );
+        ASSERT_EQ( verifier.cellCount(), grid.size() );
+        EXPECT_EQ( verifier.verify( nullptr, grid.data() ), Verdict::Valid );
+        if( blockSize > 1 )
+        {
+            // keeps the rows, breaks a column and a region
+            std::swap( grid[0], grid[grid.size() - 1] );
+            EXPECT_EQ( verifier.verify( nullptr, grid.data() ), Verdict::Invalid );
+        }
+    }
+}
+
+TEST( VerifierTests, variants )
+{
+    Layout layout( 2 );
+    layout.addCage( { { 0, 0 }, { 0, 1 } }, 3 );
+    Verifier verifier( layout );
+    const auto grid = validGrid( 2 );
+    // 1 and 2 add up to 3
+    EXPECT_EQ( verifier.verify( nullptr, grid.data() ), Verdict::Valid );
+
+    Layout other( 2 );
+    other.addCage( { { 0, 0 }, { 0, 1 } }, 4 );
+    EXPECT_EQ( Verifier( other ).verify( nullptr, grid.data() ), Verdict::Invalid );
+
+    Layout diagonals( 2 );
+    diagonals.addDiagonals();
+    EXPECT_EQ( Verifier( diagonals ).verify( nullptr, grid.data() ), Verdict::Invalid );
+}